@@ -22,6 +22,16 @@
 #include "sg/Renderer.h"
 #include "sg/common/FrameBuffer.h"
 
+#include <fstream>
+
+#ifdef _WIN32
+#  include <windows.h>
+#  include <psapi.h>
+#  pragma comment(lib, "psapi.lib")
+#else
+#  include <sys/resource.h>
+#endif
+
 namespace ospray {
   namespace app {
 
@@ -36,11 +46,51 @@ namespace ospray {
 
       template <typename T>
       void outputStats(const T &stats);
+
+      template <typename T>
+      void outputJSON(const sg::Renderer &renderer, const T &stats);
+
       size_t numWarmupFrames = 10;
       size_t numBenchFrames = 100;
       std::string imageOutputFile = "";
+      std::string jsonOutputFile = "";
+      std::vector<std::string> scenes;
+      size_t sceneSize = 0;
     };
 
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    //! peak resident set size of this process, in bytes
+    static size_t peakMemoryUsage()
+    {
+#ifdef _WIN32
+      PROCESS_MEMORY_COUNTERS pmc;
+      if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+        return pmc.PeakWorkingSetSize;
+      return 0;
+#else
+      struct rusage usage;
+      if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#  ifdef __APPLE__
+      return usage.ru_maxrss;
+#  else
+      return size_t(usage.ru_maxrss) * 1024;
+#  endif
+#endif
+    }
+
+    static std::string jsonString(const std::string &s)
+    {
+      std::string result = "\"";
+      for (const char c : s) {
+        if (c == '"' || c == '\\')
+          result += '\\';
+        result += c;
+      }
+      return result + "\"";
+    }
+
     OSPBenchmark::OSPBenchmark()
     {
       addPlane = false; // NOTE(jda) - override default behavior, can still
@@ -57,7 +107,7 @@ namespace ospray {
         renderer->renderFrame(fb, OSP_FB_COLOR | OSP_FB_ACCUM);
 
       auto benchmarker =
-          pico_bench::Benchmarker<std::chrono::milliseconds>{ numBenchFrames };
+          pico_bench::Benchmarker<Milliseconds>{ numBenchFrames };
 
       auto stats = benchmarker([&]() {
         renderer->renderFrame(fb, OSP_FB_COLOR | OSP_FB_ACCUM);
@@ -72,6 +122,9 @@ namespace ospray {
       }
 
       outputStats(stats);
+
+      if (!jsonOutputFile.empty())
+        outputJSON(*renderer, stats);
     }
 
     int OSPBenchmark::parseCommandLine(int &ac, const char **&av)
@@ -90,8 +143,30 @@ namespace ospray {
           numBenchFrames = atoi(av[i + 1]);
           removeArgs(ac, av, i, 2);
           --i;
+        } else if (arg == "--json") {
+          jsonOutputFile = av[i + 1];
+          removeArgs(ac, av, i, 2);
+          --i;
+        } else if (arg == "--scene") {
+          scenes.push_back(av[i + 1]);
+          removeArgs(ac, av, i, 2);
+          --i;
+        } else if (arg == "--scene-size") {
+          sceneSize = atol(av[i + 1]);
+          removeArgs(ac, av, i, 2);
+          --i;
         }
       }
+
+      // built-in procedural scenes, e.g. '--scene spheres --scene-size 1000'
+      // becomes '--generate:spheres:size=1000'
+      for (const auto &scene : scenes) {
+        std::string file = "--generate:" + scene;
+        if (sceneSize > 0)
+          file += ":size=" + std::to_string(sceneSize);
+        files.push_back(clFile(file, clTransform()));
+      }
+
       return 0;
     }
 
@@ -105,6 +180,56 @@ namespace ospray {
       std::cout << stats << std::endl;
     }
 
+    /*! write all measurements as a single json object to
+        'jsonOutputFile' ("-" writes to stdout) */
+    template <typename T>
+    void OSPBenchmark::outputJSON(const sg::Renderer &renderer, const T &stats)
+    {
+      std::ofstream file;
+      if (jsonOutputFile != "-") {
+        file.open(jsonOutputFile);
+        if (!file) {
+          throw std::runtime_error("#ospBenchmark: could not open '"
+                                   + jsonOutputFile + "' for writing");
+        }
+      }
+      std::ostream &out = file.is_open() ? file : std::cout;
+
+      // one primary ray per pixel and sample (secondary rays depend on
+      // the renderer and scene, and are not counted)
+      const int spp = std::max(renderer["spp"].valueAs<int>(), 1);
+      const double primaryRays = double(width) * height * spp;
+      const double medianSeconds = stats.median().count() / 1000.0;
+
+      out << "{\n"
+          << "  \"scenes\": [";
+      for (size_t i = 0; i < files.size(); ++i)
+        out << (i ? ", " : "") << jsonString(files[i].file);
+      out << "],\n"
+          << "  \"renderer\": "
+          << jsonString(renderer["rendererType"].valueAs<std::string>())
+          << ",\n"
+          << "  \"width\": " << width << ",\n"
+          << "  \"height\": " << height << ",\n"
+          << "  \"spp\": " << spp << ",\n"
+          << "  \"loadTimeMs\": " << sceneLoadTimer.milliseconds() << ",\n"
+          << "  \"commitTimeMs\": " << sceneCommitTimer.milliseconds()
+          << ",\n"
+          << "  \"frameTimeMs\": {\n"
+          << "    \"min\": " << stats.min().count() << ",\n"
+          << "    \"max\": " << stats.max().count() << ",\n"
+          << "    \"median\": " << stats.median().count() << ",\n"
+          << "    \"medianAbsDev\": " << stats.median_abs_dev().count() << ",\n"
+          << "    \"mean\": " << stats.mean().count() << ",\n"
+          << "    \"stdDev\": " << stats.std_dev().count() << ",\n"
+          << "    \"samples\": " << stats.size() << "\n"
+          << "  },\n"
+          << "  \"primaryRaysPerSecond\": "
+          << (medianSeconds > 0.0 ? primaryRays / medianSeconds : 0.0) << ",\n"
+          << "  \"peakMemoryBytes\": " << peakMemoryUsage() << "\n"
+          << "}" << std::endl;
+    }
+
   } // ::ospray::app
 } // ::ospray
 
@@ -0,0 +1,452 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "../pico_bench/pico_bench.h"
+// ospray
+#include "ospray/ospray.h"
+#include "common/Model.h"
+#include "fb/LocalFB.h"
+#include "fb/Tile.h"
+#include "texture/Texture2D.h"
+#include "transferFunction/TransferFunction.h"
+#include "volume/Volume.h"
+// ospcommon
+#include "ospcommon/containers/aligned_allocator.h"
+#include "ospcommon/tasking/parallel_for.h"
+// ispc exports
+#include "GridAccelerator_ispc.h"
+#include "LocalFB_ispc.h"
+#include "MicroBenchKernels_ispc.h"
+#include "StructuredVolume_ispc.h"
+#include "Volume_ispc.h"
+// std
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+
+/*! \file microbench.cpp benchmarks of individual ospray (ISPC) kernels
+
+    every benchmark drives a single kernel with synthetic input, on a
+    fixed number of threads (the work of one run gets split into
+    chunks that are processed with tasking::parallel_for). kernels
+    that ospray exports are called directly, the others go through the
+    thin wrappers in MicroBenchKernels.ispc. note that this uses ospray
+    internals, and thus only works with the local ("default") device */
+
+namespace ospray {
+  namespace microbench {
+
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    /*! a kernel benchmark: each call of 'run' processes 'numItems'
+        items (samples, rays, pixels, ...) once */
+    struct Benchmark
+    {
+      size_t numItems;
+      std::function<void()> run;
+    };
+
+    //! number of items handed to a kernel in a single call
+    static const size_t chunkSize = 4096;
+
+    /*! calls 'kernel(begin, count)' for all chunks of 'numItems' items,
+        in parallel */
+    template <typename Kernel>
+    inline void forEachChunk(size_t numItems, const Kernel &kernel)
+    {
+      const size_t numChunks = (numItems + chunkSize - 1) / chunkSize;
+      tasking::parallel_for(numChunks, [&](size_t chunkID) {
+        const size_t begin = chunkID * chunkSize;
+        kernel(begin, std::min(chunkSize, numItems - begin));
+      });
+    }
+
+    template <typename T>
+    inline std::shared_ptr<std::vector<T>> makeArray(size_t size)
+    {
+      return std::make_shared<std::vector<T>>(size);
+    }
+
+    inline float uniform(std::mt19937 &rng)
+    {
+      return std::uniform_real_distribution<float>(0.f, 1.f)(rng);
+    }
+
+    inline vec3f uniform3f(std::mt19937 &rng)
+    {
+      return vec3f(uniform(rng), uniform(rng), uniform(rng));
+    }
+
+    // Helpers creating the objects the kernels operate on ////////////////////
+
+    static OSPTransferFunction createTransferFunction(bool preIntegration)
+    {
+      std::mt19937 rng(0);
+      std::vector<vec3f> colors(256);
+      std::vector<float> opacities(256);
+      for (size_t i = 0; i < colors.size(); ++i) {
+        colors[i] = uniform3f(rng);
+        opacities[i] = uniform(rng);
+      }
+
+      OSPTransferFunction tf = ospNewTransferFunction("piecewise_linear");
+      OSPData colorData = ospNewData(colors.size(), OSP_FLOAT3, colors.data());
+      OSPData opacityData =
+          ospNewData(opacities.size(), OSP_FLOAT, opacities.data());
+      ospSetData(tf, "colors", colorData);
+      ospSetData(tf, "opacities", opacityData);
+      ospSet2f(tf, "valueRange", 0.f, 1.f);
+      ospSet1i(tf, "preIntegration", preIntegration);
+      ospCommit(tf);
+      ospRelease(colorData);
+      ospRelease(opacityData);
+      return tf;
+    }
+
+    /*! a structured volume of 'size^3' random float voxels in [0,1] */
+    static Volume *createStructuredVolume(const std::string &type,
+                                          int size,
+                                          std::shared_ptr<std::vector<float>> &voxels)
+    {
+      const vec3i dims(size);
+      std::mt19937 rng(0);
+      voxels = makeArray<float>(size_t(dims.x) * dims.y * dims.z);
+      for (auto &v : *voxels)
+        v = uniform(rng);
+
+      OSPVolume volume = ospNewVolume(type.c_str());
+      if (!volume)
+        throw std::runtime_error("could not create volume '" + type + "'");
+
+      ospSetString(volume, "voxelType", "float");
+      ospSetVec3i(volume, "dimensions", (const osp::vec3i &)dims);
+      if (type == "shared_structured_volume") {
+        OSPData data = ospNewData(voxels->size(), OSP_FLOAT, voxels->data(),
+                                  OSP_DATA_SHARED_BUFFER);
+        ospSetData(volume, "voxelData", data);
+        ospRelease(data);
+      } else {
+        const vec3i lower(0);
+        ospSetRegion(volume, voxels->data(),
+                     (const osp::vec3i &)lower, (const osp::vec3i &)dims);
+      }
+      OSPTransferFunction tf = createTransferFunction(false);
+      ospSetObject(volume, "transferFunction", tf);
+      ospCommit(volume);
+      ospRelease(tf);
+
+      return (Volume *)volume;
+    }
+
+    // Benchmarks /////////////////////////////////////////////////////////////
+
+    static Benchmark volumeComputeSamples(const std::string &type,
+                                          size_t numItems)
+    {
+      std::shared_ptr<std::vector<float>> voxels;
+      const int size = 256;
+      void *volume = createStructuredVolume(type, size, voxels)->getIE();
+
+      std::mt19937 rng(0);
+      auto coords = makeArray<vec3f>(numItems);
+      for (auto &c : *coords)
+        c = uniform3f(rng) * float(size - 1);
+      auto samples = makeArray<float>(numItems);
+
+      return {numItems, [=]() {
+        forEachChunk(numItems, [&](size_t begin, size_t count) {
+          float *results = samples->data() + begin;
+          ispc::Volume_computeSamples(volume, &results,
+                                      (const ispc::vec3f *)coords->data()
+                                      + begin, count);
+        });
+        // keep the voxels alive for shared volumes
+        (void)voxels;
+      }};
+    }
+
+    static Benchmark gridAcceleratorBuild()
+    {
+      std::shared_ptr<std::vector<float>> voxels;
+      void *volume =
+          createStructuredVolume("block_bricked_volume", 256, voxels)->getIE();
+      // (a fresh accelerator, exactly as StructuredVolume::buildAccelerator()
+      //  creates it, which the benchmark then fills brick by brick)
+      void *accel = ispc::StructuredVolume_createAccelerator(volume);
+      const int numBricks = ispc::GridAccelerator_getBrickCount_x(accel)
+                          * ispc::GridAccelerator_getBrickCount_y(accel)
+                          * ispc::GridAccelerator_getBrickCount_z(accel);
+
+      return {voxels->size(), [=]() {
+        tasking::parallel_for(numBricks, [&](int brickID) {
+          ispc::GridAccelerator_buildAccelerator(volume, brickID);
+        });
+      }};
+    }
+
+    static Benchmark localFrameBufferAccumulateTile()
+    {
+      const vec2i fbSize(1024);
+      OSPFrameBuffer fb =
+          ospNewFrameBuffer((const osp::vec2i &)fbSize, OSP_FB_SRGBA,
+                            OSP_FB_COLOR | OSP_FB_ACCUM | OSP_FB_VARIANCE);
+      void *fbIE = ((FrameBuffer *)fb)->getIE();
+
+      using TileArray =
+          std::vector<Tile, containers::aligned_allocator<Tile, 64>>;
+      auto tiles = std::make_shared<TileArray>();
+      const vec2i numTiles = divRoundUp(fbSize, vec2i(TILE_SIZE));
+      std::mt19937 rng(0);
+      for (int y = 0; y < numTiles.y; ++y) {
+        for (int x = 0; x < numTiles.x; ++x) {
+          // accumID > 0 reads back the accumulation (and variance) buffer
+          tiles->emplace_back(vec2i(x, y), fbSize, 1);
+          auto &tile = tiles->back();
+          for (int i = 0; i < TILE_SIZE * TILE_SIZE; ++i) {
+            tile.r[i] = uniform(rng);
+            tile.g[i] = uniform(rng);
+            tile.b[i] = uniform(rng);
+            tile.a[i] = 1.f;
+          }
+        }
+      }
+
+      return {size_t(fbSize.product()), [=]() {
+        tasking::parallel_for(int(tiles->size()), [&](int tileID) {
+          ispc::LocalFrameBuffer_accumulateTile(fbIE,
+                                                (ispc::Tile &)(*tiles)[tileID]);
+        });
+      }};
+    }
+
+    /*! rays from random points on a sphere around the unit cube
+        towards random points inside of it, against 100k randomly
+        placed spheres or cylinders */
+    static Benchmark traceRays(const std::string &type, size_t numItems)
+    {
+      const size_t numPrims = 100000;
+      std::mt19937 rng(0);
+
+      OSPGeometry geometry = ospNewGeometry(type.c_str());
+      OSPData data;
+      if (type == "spheres") {
+        std::vector<vec4f> spheres(numPrims);
+        for (auto &s : spheres)
+          s = vec4f(uniform3f(rng), 0.f);
+        data = ospNewData(numPrims, OSP_FLOAT4, spheres.data());
+      } else {
+        std::vector<vec3f> cylinders(2 * numPrims);
+        for (size_t i = 0; i < numPrims; ++i) {
+          cylinders[2 * i + 0] = uniform3f(rng);
+          cylinders[2 * i + 1] =
+              cylinders[2 * i] + 0.05f * (uniform3f(rng) - vec3f(0.5f));
+        }
+        data = ospNewData(cylinders.size(), OSP_FLOAT3, cylinders.data());
+      }
+      ospSetData(geometry, type.c_str(), data);
+      ospSet1f(geometry, "radius", 0.002f);
+      ospCommit(geometry);
+
+      OSPModel model = ospNewModel();
+      ospAddGeometry(model, geometry);
+      ospCommit(model);
+      ospRelease(data);
+      ospRelease(geometry);
+      void *modelIE = ((Model *)model)->getIE();
+
+      auto org = makeArray<vec3f>(numItems);
+      auto dir = makeArray<vec3f>(numItems);
+      auto t = makeArray<float>(numItems);
+      for (size_t i = 0; i < numItems; ++i) {
+        const vec3f p = normalize(uniform3f(rng) - vec3f(0.5f));
+        (*org)[i] = vec3f(0.5f) + 2.f * p;
+        (*dir)[i] = normalize(uniform3f(rng) - (*org)[i]);
+      }
+
+      return {numItems, [=]() {
+        forEachChunk(numItems, [&](size_t begin, size_t count) {
+          ispc::MicroBench_traceRays(modelIE,
+                                     (const ispc::vec3f *)org->data() + begin,
+                                     (const ispc::vec3f *)dir->data() + begin,
+                                     t->data() + begin,
+                                     count);
+        });
+      }};
+    }
+
+    static Benchmark texture2DGet(uint32_t flags, size_t numItems)
+    {
+      const vec2i size(1024);
+      std::mt19937 rng(0);
+      std::vector<uint32_t> texels(size.product());
+      for (auto &texel : texels)
+        texel = rng();
+
+      OSPTexture2D texture = ospNewTexture2D((const osp::vec2i &)size,
+                                             OSP_TEXTURE_RGBA8,
+                                             texels.data(), flags);
+      void *textureIE = ((Texture2D *)texture)->getIE();
+
+      auto coords = makeArray<vec2f>(numItems);
+      for (auto &c : *coords)
+        c = vec2f(uniform(rng), uniform(rng));
+      auto results = makeArray<vec4f>(numItems);
+
+      return {numItems, [=]() {
+        forEachChunk(numItems, [&](size_t begin, size_t count) {
+          ispc::MicroBench_texture2DGet(textureIE,
+                                        (const ispc::vec2f *)coords->data()
+                                        + begin,
+                                        (ispc::vec4f *)results->data() + begin,
+                                        count);
+        });
+      }};
+    }
+
+    static Benchmark transferFunctionGet(bool preIntegration, size_t numItems)
+    {
+      void *tfIE =
+          ((TransferFunction *)createTransferFunction(preIntegration))->getIE();
+
+      std::mt19937 rng(0);
+      // one additional value for the segments of pre-integrated lookups
+      auto values = makeArray<float>(numItems + 1);
+      for (auto &v : *values)
+        v = uniform(rng);
+      auto results = makeArray<vec4f>(numItems);
+
+      return {numItems, [=]() {
+        forEachChunk(numItems, [&](size_t begin, size_t count) {
+          auto get = preIntegration
+                     ? ispc::MicroBench_transferFunctionGetIntegrated
+                     : ispc::MicroBench_transferFunctionGet;
+          get(tfIE, values->data() + begin,
+              (ispc::vec4f *)results->data() + begin, count);
+        });
+      }};
+    }
+
+    // Driver /////////////////////////////////////////////////////////////////
+
+    static void printHelp()
+    {
+      std::cout << "./ospMicroBenchmark [params]" << std::endl
+                << "params..." << std::endl
+                << "\t" << "--threads int //number of threads (default 1)" << std::endl
+                << "\t" << "--iterations int //timed runs per kernel (default 100)" << std::endl
+                << "\t" << "--items int //samples/rays/lookups per run (default 1M)" << std::endl
+                << "\t" << "--filter string //only run kernels whose name contains 'string'" << std::endl
+                << std::endl;
+    }
+
+    static int main(int ac, const char **av)
+    {
+      int numThreads = 1;
+      size_t numIterations = 100;
+      size_t numItems = 1 << 20;
+      std::string filter;
+
+      for (int i = 1; i < ac; i++) {
+        const std::string arg = av[i];
+        if (arg == "--help") {
+          printHelp();
+          return 0;
+        } else if (arg == "--threads" && i + 1 < ac) {
+          numThreads = atoi(av[++i]);
+        } else if (arg == "--iterations" && i + 1 < ac) {
+          numIterations = atol(av[++i]);
+        } else if (arg == "--items" && i + 1 < ac) {
+          numItems = atol(av[++i]);
+        } else if (arg == "--filter" && i + 1 < ac) {
+          filter = av[++i];
+        } else {
+          std::cerr << "Error: unknown parameter '" << arg << "'." << std::endl;
+          printHelp();
+          return 1;
+        }
+      }
+
+      OSPDevice device = ospNewDevice("default");
+      ospDeviceSet1i(device, "numThreads", numThreads);
+      ospDeviceCommit(device);
+      ospSetCurrentDevice(device);
+
+      const std::vector<std::pair<std::string, std::function<Benchmark()>>>
+      benchmarks = {
+        {"Volume_computeSamples/shared_structured_volume",
+         [&]() {
+           return volumeComputeSamples("shared_structured_volume", numItems);
+         }},
+        {"Volume_computeSamples/block_bricked_volume",
+         [&]() {
+           return volumeComputeSamples("block_bricked_volume", numItems);
+         }},
+        {"GridAccelerator_buildAccelerator",
+         [&]() { return gridAcceleratorBuild(); }},
+        {"LocalFrameBuffer_accumulateTile",
+         [&]() { return localFrameBufferAccumulateTile(); }},
+        {"traceRay/spheres",
+         [&]() { return traceRays("spheres", numItems); }},
+        {"traceRay/cylinders",
+         [&]() { return traceRays("cylinders", numItems); }},
+        {"Texture2D_get/bilinear",
+         [&]() { return texture2DGet(0, numItems); }},
+        {"Texture2D_get/nearest",
+         [&]() { return texture2DGet(OSP_TEXTURE_FILTER_NEAREST, numItems); }},
+        {"TransferFunction_get",
+         [&]() { return transferFunctionGet(false, numItems); }},
+        {"TransferFunction_getIntegrated",
+         [&]() { return transferFunctionGet(true, numItems); }}
+      };
+
+      std::cout << "#ospMicroBenchmark: " << numThreads << " thread(s), "
+                << numIterations << " iterations" << std::endl;
+      std::cout << std::left << std::setw(50) << "kernel" << std::right
+                << std::setw(12) << "median ms" << std::setw(12) << "min ms"
+                << std::setw(12) << "max ms" << std::setw(14) << "Mitems/s"
+                << std::endl;
+
+      for (const auto &b : benchmarks) {
+        if (b.first.find(filter) == std::string::npos)
+          continue;
+
+        const Benchmark benchmark = b.second();
+        const auto stats =
+            pico_bench::Benchmarker<Milliseconds>{numIterations}(benchmark.run);
+        const double itemsPerSecond =
+            benchmark.numItems / (stats.median().count() / 1000.0);
+
+        std::cout << std::left << std::setw(50) << b.first << std::right
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(12) << stats.median().count()
+                  << std::setw(12) << stats.min().count()
+                  << std::setw(12) << stats.max().count()
+                  << std::setw(14) << itemsPerSecond / 1e6 << std::endl;
+      }
+
+      return 0;
+    }
+
+  } // ::ospray::microbench
+} // ::ospray
+
+int main(int ac, const char **av)
+{
+  return ospray::microbench::main(ac, av);
+}
@@ -71,6 +71,7 @@ namespace ospray {
                 << "\t" << "--rotate float float float //rotate transform" << std::endl
                 << "\t" << "--animation //adds subsequent import files to a timeseries" << std::endl
                 << "\t" << "--file //adds subsequent import files without a timeseries" << std::endl
+                << "\t" << "--generate:type[:param=value...] //procedurally generate a scene (spheres, triangles, structured, unstructured, amr, lightroom)" << std::endl
                 << "\t" << "-w int //window width" << std::endl
                 << "\t" << "-h int //window height" << std::endl
                 << "\t" << "--size int int //window width height" << std::endl
@@ -113,14 +114,18 @@ namespace ospray {
       }
 
       addLightsToScene(renderer);
+      sceneLoadTimer.start();
       addImporterNodesToWorld(renderer);
       addAnimatedImporterNodesToWorld(renderer);
+      sceneLoadTimer.stop();
       addPlaneToScene(renderer);
       setupCamera(renderer);
 
       renderer["frameBuffer"]["size"] = vec2i(width, height);
-      renderer.traverse(sg::VerifyNodes{});
+      sceneCommitTimer.start();
+      renderer.traverseModified(sg::VerifyNodes{});
       renderer.commit();
+      sceneCommitTimer.stop();
 
       // last, to be able to modify all created SG nodes
       parseCommandLineSG(argc, argv, renderer);
@@ -129,7 +134,7 @@ namespace ospray {
         renderer.traverse(sg::PrintNodes{});
 
       // recommit in case any command line options modified the scene graph
-      renderer.traverse(sg::VerifyNodes{});
+      renderer.traverseModified(sg::VerifyNodes{});
       renderer.commit();
 
       render(rendererPtr);
@@ -273,7 +278,8 @@ namespace ospray {
           // SG parameters are validated by prefix only.
           // Later different function is used for parsing this type parameters.
           continue;
-        } else if (arg[0] != '-' || utility::beginsWith(arg, "--import:")) {
+        } else if (arg[0] != '-' || utility::beginsWith(arg, "--import:")
+                   || utility::beginsWith(arg, "--generate:")) {
           if (!inAnimation)
             files.push_back(clFile(av[i], currentCLTransform));
           else
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "ospcommon/utility/CodeTimer.h"
 #include "ospcommon/utility/getEnvVar.h"
 
 #include "common/sg/SceneGraph.h"
@@ -102,6 +103,11 @@ namespace ospray {
       std::string initialRendererType;
       box3f bboxWithoutPlane;
 
+      //! time spent importing (or generating) the files given on the
+      //  command line, and for the initial commit of the scene graph
+      utility::CodeTimer sceneLoadTimer;
+      utility::CodeTimer sceneCommitTimer;
+
       bool addPlane =
           utility::getEnvVar<int>("OSPRAY_APPS_GROUND_PLANE").value_or(1);
 
@@ -87,6 +87,26 @@ namespace ospray {
                   " tile rendering early termination.");
       child("varianceThreshold").setMinMax(0.f, 25.f);
 
+      createChild("frameBudgetMs", "float", 0.f,
+                  NodeFlags::required |
+                  NodeFlags::gui_slider,
+                  "time budget per frame in milliseconds (0 = unlimited);"
+                  " tiles that do not fit get rendered in later frames.");
+      child("frameBudgetMs").setMinMax(0.f, 1000.f);
+
+      createChild("foveaRadius", "float", 0.f,
+                  NodeFlags::required |
+                  NodeFlags::gui_slider,
+                  "radius of the full resolution region around"
+                  " 'foveaCenter', relative to the image height"
+                  " (0 = foveation disabled).");
+      child("foveaRadius").setMinMax(0.f, 2.f);
+      createChild("maxSubsampling", "int", 3,
+                  NodeFlags::required |
+                  NodeFlags::gui_slider,
+                  "coarsest subsampling level for foveated rendering");
+      child("maxSubsampling").setMinMax(0, 4);
+
       //TODO: move these to seperate SciVisRenderer
       createChild("shadowsEnabled", "bool", true);
       createChild("maxDepth", "int", 5,
@@ -112,6 +132,12 @@ namespace ospray {
       createChild("autoEpsilon", "bool", true, NodeFlags::required,
         "automatically adjust epsilon step");
 
+      createChild("parallelCommit", "bool", false, NodeFlags::none,
+                  "commit independent parts of the scene (e.g., the "
+                  "geometries of a model) in parallel. Only enable this "
+                  "for a device whose API can be called concurrently "
+                  "(i.e., the local device, not MPI)");
+
       createChild("oneSidedLighting", "bool", true, NodeFlags::required);
       createChild("aoTransparencyEnabled", "bool", true, NodeFlags::required);
 
@@ -138,7 +164,7 @@ namespace ospray {
     {
       RenderContext ctx;
       if (verifyCommit) {
-        Node::traverse(VerifyNodes{});
+        traverseModified(VerifyNodes{});
         traverse(ctx, "commit");
       }
       traverse(ctx, "render");
@@ -212,6 +238,7 @@ namespace ospray {
       ctx.ospRenderer = ospRenderer;
       ctx.ospRendererType = rendererType;
       ctx.world = child("world").nodeAs<sg::Model>();
+      ctx.parallelCommit = child("parallelCommit").valueAs<bool>();
     }
 
     void Renderer::postCommit(RenderContext &ctx)
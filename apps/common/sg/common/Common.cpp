@@ -24,6 +24,7 @@
 #  include <windows.h>
 #else
 #  include <sys/mman.h>
+#  include <unistd.h>
 #endif
 #include <fcntl.h>
 
@@ -62,25 +63,39 @@ namespace ospray {
 #endif
       fclose(file);
 
+      if (fileSize <= 0)
+        return nullptr;
+
+      // NOTE: the mapping is never unmapped, as arrays created on top of
+      //       it get handed to ospray as shared buffers; pages only get
+      //       faulted in once they are actually accessed
 #ifdef _WIN32
       HANDLE fileHandle = CreateFile(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-      if (fileHandle == nullptr)
+      if (fileHandle == INVALID_HANDLE_VALUE)
         THROW_SG_ERROR("could not open file '" + fileName + "' (error " + std::to_string(GetLastError()) + ")\n");
       HANDLE fileMappingHandle = CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
       if (fileMappingHandle == nullptr)
         THROW_SG_ERROR("could not create file mapping (error " + std::to_string(GetLastError()) + ")\n");
+
+      void *mem = MapViewOfFile(fileMappingHandle, FILE_MAP_READ, 0, 0, fileSize);
+      // the view keeps the mapping alive
+      CloseHandle(fileMappingHandle);
+      CloseHandle(fileHandle);
+      if (mem == nullptr)
+        THROW_SG_ERROR("could not map file '" + fileName + "' (error " + std::to_string(GetLastError()) + ")\n");
 #else
       int fd = ::open(fileName.c_str(), O_LARGEFILE | O_RDONLY);
       if (fd == -1)
         THROW_SG_ERROR("could not open file '" + fileName + "'\n");
-#endif
 
-      return (unsigned char *)
-#ifdef _WIN32
-        MapViewOfFile(fileMappingHandle, FILE_MAP_READ, 0, 0, fileSize);
-#else
-        mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+      void *mem = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+      // the mapping stays valid after closing the file descriptor
+      ::close(fd);
+      if (mem == MAP_FAILED)
+        THROW_SG_ERROR("could not map file '" + fileName + "'\n");
 #endif
+
+      return (const unsigned char *)mem;
     }
 
   } // ::ospray::sg
@@ -64,6 +64,11 @@ namespace ospray {
       child("bounds") = computeBounds();
     }
 
+    bool Model::commitChildrenInParallel() const
+    {
+      return true;
+    }
+
     OSP_REGISTER_SG_NODE(Model);
 
   } // ::ospray::sg
@@ -38,6 +38,9 @@ namespace ospray {
 
     protected:
 
+      //! geometries, volumes, instances, ... get committed independently
+      virtual bool commitChildrenInParallel() const override;
+
       OSPModel stashedModel{nullptr};
     };
 
@@ -17,6 +17,7 @@
 #include "Node.h"
 #include "../visitor/VerifyNodes.h"
 
+#include "ospcommon/tasking/parallel_for.h"
 #include "ospcommon/utility/StringManip.h"
 
 namespace ospray {
@@ -210,17 +211,81 @@ namespace ospray {
     void Node::markAsModified()
     {
       properties.lastModified = TimeStamp();
-      if (hasParent())
+      if (hasParent()) {
+        parent().queueModifiedChild(*this);
         parent().setChildrenModified(properties.lastModified);
+      }
     }
 
     void Node::setChildrenModified(TimeStamp t)
     {
-      if (t > properties.childrenMTime) {
+      {
+        std::lock_guard<std::mutex> lock{modified_mutex};
+        if (t <= properties.childrenMTime)
+          return;
         properties.childrenMTime = t;
-        if (hasParent())
-          parent().setChildrenModified(properties.childrenMTime);
       }
+
+      if (hasParent()) {
+        parent().queueModifiedChild(*this);
+        parent().setChildrenModified(t);
+      }
+    }
+
+    bool Node::needsCommit() const
+    {
+      return lastModified() >= lastCommitted() ||
+             childrenLastModified() >= lastCommitted();
+    }
+
+    void Node::queueModifiedChild(Node &child)
+    {
+      std::lock_guard<std::mutex> lock{modified_mutex};
+
+      // nodes which were only linked via setChild() (i.e., have a different
+      // or no parent) can't use the flag, avoid trivial duplicates instead
+      const bool isParent = child.properties.parent == this;
+      if (isParent && child.properties.queuedAsModified)
+        return;
+
+      auto &queue = properties.modifiedChildren;
+      if (queue.empty() || queue.back() != &child)
+        queue.push_back(&child);
+
+      if (isParent)
+        child.properties.queuedAsModified = true;
+    }
+
+    void Node::unqueueModifiedChild(Node &child)
+    {
+      std::lock_guard<std::mutex> lock{modified_mutex};
+
+      auto &queue = properties.modifiedChildren;
+      queue.erase(std::remove(queue.begin(), queue.end(), &child), queue.end());
+
+      if (child.properties.parent == this)
+        child.properties.queuedAsModified = false;
+    }
+
+    std::vector<Node*> Node::modifiedChildren() const
+    {
+      std::lock_guard<std::mutex> lock{modified_mutex};
+      return properties.modifiedChildren;
+    }
+
+    std::vector<Node*> Node::takeModifiedChildren()
+    {
+      std::lock_guard<std::mutex> lock{modified_mutex};
+
+      std::vector<Node*> modified;
+      modified.swap(properties.modifiedChildren);
+
+      for (auto *child : modified) {
+        if (child->properties.parent == this)
+          child->properties.queuedAsModified = false;
+      }
+
+      return modified;
     }
 
     // Parent-child structual interface ///////////////////////////////////////
@@ -326,7 +391,9 @@ namespace ospray {
     void Node::remove(const std::string &name)
     {
       if (hasChild(name)) {
-        child(name).properties.parent = nullptr;
+        auto &c = child(name);
+        unlinkChild(c);
+        c.properties.parent = nullptr;
         properties.children.erase(name);
       }
     }
@@ -345,7 +412,46 @@ namespace ospray {
     void Node::setChild(const std::string &name,
                         const std::shared_ptr<Node> &node)
     {
-      properties.children[name] = node;
+      auto &c = properties.children[name];
+      if (c == node)
+        return;
+
+      if (c)
+        unlinkChild(*c);
+
+      c = node;
+      linkChild(*node);
+    }
+
+    void Node::linkChild(Node &child)
+    {
+      auto &refs = child.properties.numReferences;
+      if (++refs > 1) {
+        // the child can now be reached via several paths, which thus can't
+        // be committed independently anymore
+        markSharedSubtree();
+        if (child.hasParent())
+          child.parent().markSharedSubtree();
+      } else if (child.properties.sharedSubtree) {
+        markSharedSubtree();
+      }
+
+      if (child.needsCommit())
+        queueModifiedChild(child);
+    }
+
+    void Node::unlinkChild(Node &child)
+    {
+      child.properties.numReferences--;
+      unqueueModifiedChild(child);
+    }
+
+    void Node::markSharedSubtree()
+    {
+      for (Node *n = this; n && !n->properties.sharedSubtree;
+           n = n->properties.parent) {
+        n->properties.sharedSubtree = true;
+      }
     }
 
     bool Node::hasParent() const
@@ -360,19 +466,28 @@ namespace ospray {
 
     void Node::setParent(Node &p)
     {
+      if (properties.parent == &p)
+        return;
+
+      if (properties.parent)
+        properties.parent->unqueueModifiedChild(*this);
+
       properties.parent = &p;
+
+      if (needsCommit())
+        p.queueModifiedChild(*this);
     }
 
     void Node::setParent(const std::shared_ptr<Node> &p)
     {
-      properties.parent = p.get();
+      setParent(*p);
     }
 
     // Traversal interface ////////////////////////////////////////////////////
 
     void Node::verify()
     {
-      traverse(VerifyNodes{false});
+      traverseModified(VerifyNodes{false});
     }
 
     void Node::commit()
@@ -398,8 +513,16 @@ namespace ospray {
       ctx.level++;
 
       if (traverseChildren) {
-        for (auto &child : properties.children)
-          child.second->traverse(ctx, operation);
+        if (operation == "commit")
+          commitModifiedChildren(ctx);
+        else {
+          for (auto &child : properties.children)
+            child.second->traverse(ctx, operation);
+        }
+      } else if (operation == "commit") {
+        // the commit of this subtree got pruned, so whatever is still
+        // queued is stale and must not be visited by later traversals
+        takeModifiedChildren();
       }
 
       ctx.level--;
@@ -407,6 +530,35 @@ namespace ospray {
       postTraverse(ctx, operation);
     }
 
+    void Node::commitModifiedChildren(RenderContext &ctx)
+    {
+      // children modified while committing this node's subtree get queued
+      // again, and will be visited by the next commit traversal
+      auto modified = takeModifiedChildren();
+
+      if (!(ctx.parallelCommit && commitChildrenInParallel()) ||
+          modified.size() < 2) {
+        for (auto *child : modified)
+          child->traverse(ctx, "commit");
+        return;
+      }
+
+      // shared subtrees may be reached from elsewhere, commit them upfront
+      std::vector<Node*> independent;
+      for (auto *child : modified) {
+        if (child->properties.numReferences <= 1 &&
+            !child->properties.sharedSubtree)
+          independent.push_back(child);
+        else
+          child->traverse(ctx, "commit");
+      }
+
+      tasking::parallel_for(independent.size(), [&](size_t i) {
+        RenderContext childCtx = ctx;
+        independent[i]->traverse(childCtx, "commit");
+      });
+    }
+
     void Node::traverse(const std::string &operation)
     {
       RenderContext ctx;
@@ -444,6 +596,11 @@ namespace ospray {
     {
     }
 
+    bool Node::commitChildrenInParallel() const
+    {
+      return false;
+    }
+
     // ==================================================================
     // global stuff
     // ==================================================================
@@ -451,6 +608,7 @@ namespace ospray {
     using CreatorFct = sg::Node*(*)();
 
     static std::map<std::string, CreatorFct> nodeRegistry;
+    static std::mutex nodeRegistryMutex;
 
     std::shared_ptr<Node> createNode(std::string name,
                                      std::string type,
@@ -458,19 +616,24 @@ namespace ospray {
                                      int flags,
                                      std::string documentation)
     {
-      std::map<std::string, CreatorFct>::iterator it = nodeRegistry.find(type);
       CreatorFct creator = nullptr;
 
-      if (it == nodeRegistry.end()) {
-        std::string creatorName = "ospray_create_sg_node__" + type;
-        creator = (CreatorFct)getSymbol(creatorName);
+      {
+        // nodes may get created from within (parallel) commits
+        std::lock_guard<std::mutex> lock{nodeRegistryMutex};
+        auto it = nodeRegistry.find(type);
 
-        if (!creator)
-          throw std::runtime_error("unknown OSPRay sg::Node '" + type + "'");
+        if (it == nodeRegistry.end()) {
+          std::string creatorName = "ospray_create_sg_node__" + type;
+          creator = (CreatorFct)getSymbol(creatorName);
 
-        nodeRegistry[type] = creator;
-      } else {
-        creator = it->second;
+          if (!creator)
+            throw std::runtime_error("unknown OSPRay sg::Node '" + type + "'");
+
+          nodeRegistry[type] = creator;
+        } else {
+          creator = it->second;
+        }
       }
 
       std::shared_ptr<sg::Node> newNode(creator());
@@ -204,8 +204,17 @@ namespace ospray {
       template <typename VISITOR_T, typename = is_valid_visitor_t<VISITOR_T>>
       void traverse(VISITOR_T &&visitor);
 
-      //! Invoke a "verify" traversal of the scene graph (and possibly
-      //  its children)
+      //! Like traverse(), but only descend into children that were modified
+      //  (or have modified children) since they were last committed
+      template <typename VISITOR_T, typename = is_valid_visitor_t<VISITOR_T>>
+      void traverseModified(VISITOR_T &&visitor, TraversalContext &ctx);
+
+      //! Helper overload to traverse with a default constructed TravesalContext
+      template <typename VISITOR_T, typename = is_valid_visitor_t<VISITOR_T>>
+      void traverseModified(VISITOR_T &&visitor);
+
+      //! Invoke a "verify" traversal of the scene graph (and those of its
+      //  children which were modified since the last commit)
       void verify();
 
       //! Invoke a "commit" traversal of the scene graph (and possibly
@@ -245,6 +254,14 @@ namespace ospray {
       //! Called after committing children during traversal
       virtual void postCommit(RenderContext &ctx);
 
+      //! Whether modified children may get committed in parallel. Only
+      //  children whose subtrees are not shared with other parts of the
+      //  graph will be, the remaining ones still get committed serially
+      virtual bool commitChildrenInParallel() const;
+
+      //! returns (a snapshot of) the children queued as modified
+      std::vector<Node*> modifiedChildren() const;
+
       struct
       {
         std::string name;
@@ -263,14 +280,42 @@ namespace ospray {
         NodeFlags flags;
         bool valid {false};
         std::string documentation;
+        //! children which got modified since they were last committed, in
+        //  the order they were modified; a commit traversal only visits
+        //  these instead of all children
+        std::vector<Node*> modifiedChildren;
+        //! this node is queued in 'parent->properties.modifiedChildren'
+        bool queuedAsModified {false};
+        //! number of nodes this node is a child of
+        int numReferences {0};
+        //! this node's subtree contains a node with several parents
+        bool sharedSubtree {false};
       } properties;
 
       // NOTE(jda) - The mutex is 'mutable' because const methods still need
       //             to be able to lock the mutex
       mutable std::mutex value_mutex;
+      //! guards 'childrenMTime' and the modified children queue
+      mutable std::mutex modified_mutex;
 
     private:
 
+      bool needsCommit() const;
+
+      //! queue 'child' as modified (once), for the next commit traversal
+      void queueModifiedChild(Node &child);
+      void unqueueModifiedChild(Node &child);
+      //! returns and clears the queue of modified children
+      std::vector<Node*> takeModifiedChildren();
+
+      //! commit the modified children, see commitChildrenInParallel()
+      void commitModifiedChildren(RenderContext &ctx);
+
+      void linkChild(Node &child);
+      void unlinkChild(Node &child);
+      //! mark this node and its ancestors as containing a shared node
+      void markSharedSubtree();
+
       friend struct VerifyNodes;
     };
 
@@ -448,6 +493,36 @@ namespace ospray {
       traverse(std::forward<VISITOR_T>(visitor), ctx);
     }
 
+    template <typename VISITOR_T, typename>
+    inline void Node::traverseModified(VISITOR_T &&visitor,
+                                       TraversalContext &ctx)
+    {
+      static_assert(is_valid_visitor<VISITOR_T>::value,
+                    "VISITOR_T must be a child class of sg::Visitor or"
+                    " implement 'bool visit(Node &node, TraversalContext &ctx)'"
+                    "!");
+
+      bool traverseChildren = visitor(*this, ctx);
+
+      ctx.level++;
+
+      if (traverseChildren) {
+        for (auto *child : modifiedChildren())
+          child->traverseModified(visitor, ctx);
+      }
+
+      ctx.level--;
+
+      visitor.postChildren(*this, ctx);
+    }
+
+    template <typename VISITOR_T, typename>
+    inline void Node::traverseModified(VISITOR_T &&visitor)
+    {
+      TraversalContext ctx;
+      traverseModified(std::forward<VISITOR_T>(visitor), ctx);
+    }
+
     /*! \brief registers a internal ospray::<ClassName> renderer under
       the externally accessible name "external_name"
 
@@ -44,6 +44,9 @@ namespace ospray {
       std::string ospRendererType;
       int level {0};
 
+      //! allow nodes to commit independent children in parallel
+      bool parallelCommit {false};
+
 
       utility::TimeStamp _MTime;
       utility::TimeStamp _childMTime;
@@ -57,7 +60,8 @@ namespace ospray {
         currentOSPModel(nullptr),
         currentTransform(newXfm),
         ospRenderer(nullptr),
-        level(0)
+        level(0),
+        parallelCommit(other.parallelCommit)
     {}
 
   }// ::ospray::sg
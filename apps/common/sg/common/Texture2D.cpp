@@ -65,7 +65,10 @@ namespace ospray {
         return;
       }
 
-      auto ospTexture2D = ospNewTexture2D((osp::vec2i&)size, type, dat, 0);
+      // texel data is owned by this node (or lives in a mapped scene
+      // file), so ospray can use it directly without making a copy
+      auto ospTexture2D = ospNewTexture2D((osp::vec2i&)size, type, dat,
+                                          OSP_TEXTURE_SHARED_BUFFER);
       setValue(ospTexture2D);
       ospCommit(ospTexture2D);
     }
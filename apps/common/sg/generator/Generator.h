@@ -0,0 +1,90 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+// ospray::sg
+#include "../importer/Importer.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+// stl
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+/*! \file sg/generator/Generator.h helpers shared by the procedural
+    scene generators, which get invoked through a
+    '--generate:<type>[:param=value[:...]]' file name. all generators
+    understand a 'size' parameter that scales the amount of generated
+    data, and a 'seed' parameter for the random number generator */
+
+namespace ospray {
+  namespace sg {
+    namespace generator {
+
+      /*! return value of the parameter with given name, or
+          'defaultValue' if the parameter wasn't supplied */
+      template <typename T>
+      inline T param(const GeneratorParams &params,
+                     const std::string &name,
+                     const T &defaultValue)
+      {
+        for (const auto &p : params) {
+          if (p.first != name)
+            continue;
+          std::stringstream ss(p.second);
+          T value;
+          if (!(ss >> value)) {
+            throw std::runtime_error("#osp:sg: invalid value '" + p.second
+                                     + "' for generator parameter '"
+                                     + name + "'");
+          }
+          return value;
+        }
+        return defaultValue;
+      }
+
+      /*! calls 'generate(itemID, rng)' for all items, in parallel over
+          blocks of items. each block uses its own random number
+          generator seeded from 'seed' and the block ID, so the
+          generated data does not depend on the number of threads */
+      template <typename Generate>
+      inline void parallelGenerate(size_t numItems,
+                                   uint32_t seed,
+                                   const Generate &generate)
+      {
+        static const size_t blockSize = 4096;
+        const size_t numBlocks = (numItems + blockSize - 1) / blockSize;
+        tasking::parallel_for(numBlocks, [&](size_t blockID) {
+          std::seed_seq seq{seed, uint32_t(blockID), uint32_t(blockID >> 32)};
+          std::mt19937 rng(seq);
+          const size_t begin = blockID * blockSize;
+          const size_t end = std::min(begin + blockSize, numItems);
+          for (size_t i = begin; i < end; ++i)
+            generate(i, rng);
+        });
+      }
+
+      /*! uniformly distributed float in [0,1) */
+      inline float uniform(std::mt19937 &rng)
+      {
+        return std::uniform_real_distribution<float>(0.f, 1.f)(rng);
+      }
+
+    } // ::ospray::sg::generator
+  } // ::ospray::sg
+} // ::ospray
@@ -0,0 +1,100 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Generator.h"
+#include "common/sg/SceneGraph.h"
+
+/*! \file sg/generator/generateLightRoom.cpp a room (floor and two
+    walls) lit by many small point lights, for benchmarking light
+    evaluation. the lights get added to the 'lights' of the renderer
+    the generated world belongs to
+
+    parameters:
+      size      = number of lights (default 256)
+      intensity = total intensity of all lights (default 4)
+      seed      = random seed
+*/
+
+namespace ospray {
+  namespace sg {
+
+    static void addQuad(DataVector3f &vertex, DataVector3i &index,
+                        const vec3f &p, const vec3f &du, const vec3f &dv)
+    {
+      const int v = vertex.size();
+      vertex.push_back(p);
+      vertex.push_back(p + du);
+      vertex.push_back(p + du + dv);
+      vertex.push_back(p + dv);
+      index.push_back(vec3i(v, v + 1, v + 2));
+      index.push_back(vec3i(v, v + 2, v + 3));
+    }
+
+    void generateLightRoom(const std::shared_ptr<Node> &world,
+                           const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const int numLights = std::max(param<int>(params, "size", 256), 1);
+      const float intensity = param<float>(params, "intensity", 4.f);
+      const uint32_t seed = param<uint32_t>(params, "seed", 0);
+
+      Node *renderer = world.get();
+      while (!renderer->hasChild("lights") && renderer->hasParent())
+        renderer = &renderer->parent();
+
+      if (!renderer->hasChild("lights")) {
+        throw std::runtime_error("#osp:sg: 'lightroom' generator needs to "
+                                 "be part of a renderer's world");
+      }
+
+      auto vertex = std::make_shared<DataVector3f>();
+      auto index = std::make_shared<DataVector3i>();
+      addQuad(*vertex, *index, vec3f(0.f), vec3f(0, 0, 1), vec3f(1, 0, 0));
+      addQuad(*vertex, *index, vec3f(0.f), vec3f(0, 1, 0), vec3f(0, 0, 1));
+      addQuad(*vertex, *index, vec3f(0, 0, 1), vec3f(0, 1, 0), vec3f(1, 0, 0));
+      vertex->setName("vertex");
+      index->setName("index");
+
+      auto &room = world->createChild("room", "TriangleMesh");
+      room.add(vertex);
+      room.add(index);
+
+      auto &lights = renderer->child("lights");
+
+      std::mt19937 rng(seed);
+      for (int i = 0; i < numLights; ++i) {
+        auto &light = lights.createChild("roomLight_" + std::to_string(i),
+                                         "PointLight");
+        light["position"] = vec3f(0.1f + 0.8f * uniform(rng),
+                                  0.05f + 0.6f * uniform(rng),
+                                  0.1f + 0.8f * uniform(rng));
+        light["color"] = vec3f(0.5f) + 0.5f * vec3f(uniform(rng),
+                                                    uniform(rng),
+                                                    uniform(rng));
+        light["intensity"] = intensity / numLights;
+        light["radius"] = 0.01f;
+      }
+
+      std::cout << "#osp.sg: generated room with "
+                << prettyNumber(numLights) << " lights" << std::endl;
+    }
+
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateLightRoom, lightroom);
+
+  } // ::ospray::sg
+} // ::ospray
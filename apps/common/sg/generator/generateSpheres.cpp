@@ -0,0 +1,74 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Generator.h"
+#include "common/sg/SceneGraph.h"
+
+/*! \file sg/generator/generateSpheres.cpp randomly placed spheres
+
+    parameters:
+      size   = number of spheres (default 1M)
+      radius = sphere radius (default: spheres cover ~10% of the volume)
+      seed   = random seed
+*/
+
+namespace ospray {
+  namespace sg {
+
+    void generateSpheres(const std::shared_ptr<Node> &world,
+                         const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const size_t numSpheres = param<size_t>(params, "size", 1000000);
+      const float radius =
+          param<float>(params, "radius", 0.3f / std::cbrt(float(numSpheres)));
+      const uint32_t seed = param<uint32_t>(params, "seed", 0);
+
+      // center (xyz) and radius (w) of each sphere
+      auto sphereData = std::make_shared<DataVectorT<vec4f,OSP_RAW>>();
+      auto colorData = std::make_shared<DataVectorT<vec4f,OSP_RAW>>();
+      sphereData->v.resize(numSpheres);
+      colorData->v.resize(numSpheres);
+
+      parallelGenerate(numSpheres, seed, [&](size_t i, std::mt19937 &rng) {
+        const vec3f p(uniform(rng), uniform(rng), uniform(rng));
+        sphereData->v[i] = vec4f(p, radius * (0.5f + uniform(rng)));
+        colorData->v[i] = vec4f(uniform(rng), uniform(rng), uniform(rng), 1.f);
+      });
+
+      auto &sphereObject = world->createChild("spheres", "Spheres");
+
+      sphereData->setName("spheres");
+      sphereObject.add(sphereData);
+      colorData->setName("colorData");
+      sphereObject.add(colorData);
+
+      sphereObject.createChild("bytes_per_sphere", "int", int(sizeof(vec4f)));
+      sphereObject.createChild("offset_center", "int", int(0*sizeof(float)));
+      sphereObject.createChild("offset_radius", "int", int(3*sizeof(float)));
+      sphereObject.createChild("color_offset", "int", int(0*sizeof(float)));
+      sphereObject.createChild("color_stride", "int", int(4*sizeof(float)));
+
+      std::cout << "#osp.sg: generated " << prettyNumber(numSpheres)
+                << " spheres" << std::endl;
+    }
+
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateSpheres, spheres);
+
+  } // ::ospray::sg
+} // ::ospray
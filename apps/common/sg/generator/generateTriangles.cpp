@@ -0,0 +1,108 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Generator.h"
+#include "common/sg/SceneGraph.h"
+
+/*! \file sg/generator/generateTriangles.cpp tessellated, bumpy spheres
+
+    parameters:
+      size   = number of segments around each sphere; each mesh has
+               size*size triangles (default 1024, i.e., ~1M triangles)
+      meshes = number of meshes along each axis of a regular grid of
+               meshes (default 1)
+*/
+
+namespace ospray {
+  namespace sg {
+
+    static void generateBumpySphere(Node &mesh, const vec3f &center, int size)
+    {
+      const int numRings = std::max(size / 2, 2);
+      const int numSegments = std::max(size, 3);
+      const int numVertices = (numRings + 1) * (numSegments + 1);
+
+      auto vertex = std::make_shared<DataVector3f>();
+      auto normal = std::make_shared<DataVector3f>();
+      auto index = std::make_shared<DataVector3i>();
+      vertex->v.resize(numVertices);
+      normal->v.resize(numVertices);
+      index->v.resize(2 * numRings * numSegments);
+
+      tasking::parallel_for(numRings + 1, [&](int r) {
+        const float theta = float(M_PI) * r / numRings;
+        for (int s = 0; s <= numSegments; ++s) {
+          const float phi = 2.f * float(M_PI) * s / numSegments;
+          const vec3f n(std::sin(theta) * std::cos(phi),
+                        std::cos(theta),
+                        std::sin(theta) * std::sin(phi));
+          const float bump =
+              1.f + 0.05f * std::sin(16.f * theta) * std::sin(16.f * phi);
+          const int v = r * (numSegments + 1) + s;
+          vertex->v[v] = center + 0.4f * bump * n;
+          normal->v[v] = n;
+        }
+      });
+
+      tasking::parallel_for(numRings, [&](int r) {
+        for (int s = 0; s < numSegments; ++s) {
+          const int v0 = r * (numSegments + 1) + s;
+          const int v1 = v0 + numSegments + 1;
+          const int t = 2 * (r * numSegments + s);
+          index->v[t + 0] = vec3i(v0, v1, v0 + 1);
+          index->v[t + 1] = vec3i(v0 + 1, v1, v1 + 1);
+        }
+      });
+
+      vertex->setName("vertex");
+      normal->setName("normal");
+      index->setName("index");
+      mesh.add(vertex);
+      mesh.add(normal);
+      mesh.add(index);
+    }
+
+    void generateTriangles(const std::shared_ptr<Node> &world,
+                           const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const int size = param<int>(params, "size", 1024);
+      const int meshes = std::max(param<int>(params, "meshes", 1), 1);
+
+      for (int z = 0; z < meshes; ++z) {
+        for (int y = 0; y < meshes; ++y) {
+          for (int x = 0; x < meshes; ++x) {
+            std::stringstream ss;
+            ss << "mesh_" << x << "_" << y << "_" << z;
+            auto &mesh = world->createChild(ss.str(), "TriangleMesh");
+            generateBumpySphere(mesh, vec3f(x, y, z) + vec3f(0.5f), size);
+          }
+        }
+      }
+
+      const size_t numTriangles = size_t(meshes) * meshes * meshes
+                                  * 2 * std::max(size / 2, 2)
+                                  * std::max(size, 3);
+      std::cout << "#osp.sg: generated " << prettyNumber(numTriangles)
+                << " triangles" << std::endl;
+    }
+
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateTriangles, triangles);
+
+  } // ::ospray::sg
+} // ::ospray
@@ -0,0 +1,238 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "Generator.h"
+#include "common/sg/SceneGraph.h"
+#include "common/sg/volume/AMRVolume.h"
+
+/*! \file sg/generator/generateVolumes.cpp procedural structured,
+    unstructured and AMR volumes, all sampling the Marschner-Lobb test
+    function over the unit cube
+
+    parameters:
+      size      = number of voxels/cells along each axis (default 256
+                  structured, 64 unstructured, 64 for the coarsest AMR
+                  level)
+      brickSize = (amr only) number of cells of a brick along each
+                  axis (default 8)
+      levels    = (amr only) number of refinement levels (default 3)
+*/
+
+namespace ospray {
+  namespace sg {
+
+    /*! the Marschner-Lobb function, for 'p' in [0,1]^3; values in [0,1] */
+    static inline float marschnerLobb(const vec3f &p)
+    {
+      const float fM = 6.f;
+      const float alpha = 0.25f;
+      const vec3f q = 2.f * p - vec3f(1.f);
+      const float r = std::sqrt(q.x * q.x + q.y * q.y);
+      const float rho = std::cos(2.f * float(M_PI) * fM
+                                 * std::cos(float(M_PI) * r / 2.f));
+      return (1.f - std::sin(float(M_PI) * q.z / 2.f) + alpha * (1.f + rho))
+             / (2.f * (1.f + alpha));
+    }
+
+    void generateStructuredVolume(const std::shared_ptr<Node> &world,
+                                  const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const int size = std::max(param<int>(params, "size", 256), 2);
+      const vec3i dims(size);
+
+      auto volume = createNode("structured_volume", "StructuredVolume")
+                        ->nodeAs<StructuredVolume>();
+      volume->dimensions = dims;
+
+      auto voxels = std::make_shared<DataVector1f>();
+      voxels->v.resize(size_t(dims.x) * dims.y * dims.z);
+
+      const float spacing = 1.f / (size - 1);
+      tasking::parallel_for(dims.z, [&](int z) {
+        for (int y = 0; y < dims.y; ++y) {
+          for (int x = 0; x < dims.x; ++x) {
+            const size_t i = (size_t(z) * dims.y + y) * dims.x + x;
+            voxels->v[i] = marschnerLobb(vec3f(x, y, z) * spacing);
+          }
+        }
+      });
+
+      voxels->setName("voxelData");
+      volume->add(voxels);
+      volume->child("gridSpacing") = vec3f(spacing);
+
+      world->add(volume);
+
+      std::cout << "#osp.sg: generated " << dims << " structured volume"
+                << std::endl;
+    }
+
+    void generateUnstructuredVolume(const std::shared_ptr<Node> &world,
+                                    const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const int size = std::max(param<int>(params, "size", 64), 1);
+      const int numVerts = size + 1;
+
+      auto vertices =
+          createNode("vertices", "DataVector3f")->nodeAs<DataVector3f>();
+      auto field = createNode("field", "DataVector1f")->nodeAs<DataVector1f>();
+      auto indices =
+          createNode("hexahedra", "DataVector4i")->nodeAs<DataVector4i>();
+
+      vertices->v.resize(size_t(numVerts) * numVerts * numVerts);
+      field->v.resize(vertices->v.size());
+      // two vec4i per cell: the 8 vertices of the hexahedron
+      indices->v.resize(2 * size_t(size) * size * size);
+
+      auto vertexID = [&](int x, int y, int z) {
+        return int((size_t(z) * numVerts + y) * numVerts + x);
+      };
+
+      tasking::parallel_for(numVerts, [&](int z) {
+        for (int y = 0; y < numVerts; ++y) {
+          for (int x = 0; x < numVerts; ++x) {
+            const vec3f p = vec3f(x, y, z) / float(size);
+            vertices->v[vertexID(x, y, z)] = p;
+            field->v[vertexID(x, y, z)] = marschnerLobb(p);
+          }
+        }
+      });
+
+      tasking::parallel_for(size, [&](int z) {
+        for (int y = 0; y < size; ++y) {
+          for (int x = 0; x < size; ++x) {
+            const size_t c = (size_t(z) * size + y) * size + x;
+            indices->v[2 * c + 0] = vec4i(vertexID(x,     y,     z),
+                                          vertexID(x + 1, y,     z),
+                                          vertexID(x + 1, y + 1, z),
+                                          vertexID(x,     y + 1, z));
+            indices->v[2 * c + 1] = vec4i(vertexID(x,     y,     z + 1),
+                                          vertexID(x + 1, y,     z + 1),
+                                          vertexID(x + 1, y + 1, z + 1),
+                                          vertexID(x,     y + 1, z + 1));
+          }
+        }
+      });
+
+      auto &v = world->createChild("unstructured_volume", "UnstructuredVolume");
+
+      v.add(vertices);
+      v.add(indices);
+      v.add(field);
+
+      std::cout << "#osp.sg: generated unstructured volume with "
+                << prettyNumber(size_t(size) * size * size) << " hexahedra"
+                << std::endl;
+    }
+
+    void generateAMRVolume(const std::shared_ptr<Node> &world,
+                           const GeneratorParams &params)
+    {
+      using namespace generator;
+
+      const int brickSize = std::max(param<int>(params, "brickSize", 8), 1);
+      const int size = std::max(param<int>(params, "size", 64), brickSize);
+      const int levels = std::max(param<int>(params, "levels", 3), 1);
+
+      auto node = createNode("amr", "AMRVolume")->nodeAs<AMRVolume>();
+
+      // level 0 bricks cover the whole domain, each finer level refines
+      // those bricks (by a factor of two) that contain features, i.e.,
+      // whose value range exceeds a threshold
+      const int numBricks0 = (size + brickSize - 1) / brickSize;
+      std::vector<AMRVolume::BrickInfo> levelBricks;
+      for (int z = 0; z < numBricks0; ++z) {
+        for (int y = 0; y < numBricks0; ++y) {
+          for (int x = 0; x < numBricks0; ++x) {
+            AMRVolume::BrickInfo bi;
+            bi.box.lower = vec3i(x, y, z) * brickSize;
+            bi.box.upper = bi.box.lower + vec3i(brickSize - 1);
+            bi.level = 0;
+            bi.dt = 1.f / (numBricks0 * brickSize);
+            levelBricks.push_back(bi);
+          }
+        }
+      }
+
+      const int numCells = brickSize * brickSize * brickSize;
+
+      for (int level = 0; level < levels && !levelBricks.empty(); ++level) {
+        const size_t first = node->brickInfo.size();
+        node->brickInfo.insert(node->brickInfo.end(),
+                               levelBricks.begin(), levelBricks.end());
+        node->brickPtrs.resize(node->brickInfo.size());
+
+        std::vector<range1f> brickRange(levelBricks.size());
+        tasking::parallel_for(levelBricks.size(), [&](size_t b) {
+          const auto &bi = levelBricks[b];
+          float *data = new float[numCells];
+          for (int z = 0, i = 0; z < brickSize; ++z) {
+            for (int y = 0; y < brickSize; ++y) {
+              for (int x = 0; x < brickSize; ++x, ++i) {
+                const vec3f p =
+                    (vec3f(bi.box.lower + vec3i(x, y, z)) + vec3f(0.5f))
+                    * bi.dt;
+                data[i] = marschnerLobb(p);
+                brickRange[b].extend(data[i]);
+              }
+            }
+          }
+          node->brickPtrs[first + b] = data;
+        });
+
+        std::vector<AMRVolume::BrickInfo> finerBricks;
+        for (size_t b = 0; b < levelBricks.size(); ++b) {
+          node->valueRange.extend(brickRange[b]);
+          if (brickRange[b].size() < 0.25f)
+            continue;
+          const auto &bi = levelBricks[b];
+          for (int i = 0; i < 8; ++i) {
+            const vec3i octant((i & 1) ? 1 : 0,
+                               (i & 2) ? 1 : 0,
+                               (i & 4) ? 1 : 0);
+            AMRVolume::BrickInfo fine;
+            fine.box.lower = 2 * bi.box.lower + octant * brickSize;
+            fine.box.upper = fine.box.lower + vec3i(brickSize - 1);
+            fine.level = level + 1;
+            fine.dt = 0.5f * bi.dt;
+            finerBricks.push_back(fine);
+          }
+        }
+        levelBricks.swap(finerBricks);
+      }
+
+      node->voxelType = "float";
+      node->child("bounds") = box3f(vec3f(0.f), vec3f(1.f));
+      node->child("transferFunction")["valueRange"] =
+          node->valueRange.toVec2f();
+      world->add(node);
+
+      std::cout << "#osp.sg: generated AMR volume with "
+                << prettyNumber(node->brickInfo.size()) << " bricks"
+                << std::endl;
+    }
+
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateStructuredVolume, structured);
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateUnstructuredVolume, unstructured);
+    OSPSG_REGISTER_GENERATE_FUNCTION(generateAMRVolume, amr);
+
+  } // ::ospray::sg
+} // ::ospray
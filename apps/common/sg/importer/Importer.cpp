@@ -147,6 +147,20 @@ namespace ospray {
 
       if (fu) {
         importURL(wsg, fileName, *fu);
+      } else if (utility::beginsWith(fileName, "--generate:")) {
+        auto splitValues = utility::split(fileName, ':');
+
+        GeneratorParams params;
+        for (size_t i = 2; i < splitValues.size(); ++i) {
+          const auto &arg = splitValues[i];
+          const auto eq = arg.find('=');
+          if (eq == std::string::npos)
+            params.emplace_back(arg, "");
+          else
+            params.emplace_back(arg.substr(0, eq), arg.substr(eq + 1));
+        }
+
+        importRegistryGenerator(wsg, splitValues[1], params);
       } else if (utility::beginsWith(fileName, "--import:")) {
         auto splitValues = utility::split(fileName, ':');
         bool isGenerator = (splitValues.size() == 2);
@@ -154,7 +168,7 @@ namespace ospray {
         auto type = splitValues[1];
 
         if (isGenerator)
-          importRegistryGenerator(wsg, type);
+          importRegistryGenerator(wsg, type, GeneratorParams());
         else {
           auto file = splitValues[2];
           importRegistryFileLoader(wsg, type, FileName(file));
@@ -182,56 +196,27 @@ namespace ospray {
       }
     }
 
-    // TODO: Implement a registry for data "generators" which don't require
-    //       an input file.
-    void Importer::importRegistryGenerator(std::shared_ptr<Node> /*world*/,
-                                           const std::string &/*type*/) const
+    void Importer::importRegistryGenerator(std::shared_ptr<Node> world,
+                                           const std::string &type,
+                                           const GeneratorParams &params) const
     {
-      #if 0
-      // Function pointer type for creating a concrete instance of a subtype of
-      // this class.
-      using importFunction = void(*)(std::shared_ptr<Node>, const FileName &);
-
-      // Function pointers corresponding to each subtype.
-      static std::map<std::string, importFunction> symbolRegistry;
+      static std::map<std::string, GeneratorFunction> symbolRegistry;
 
-      // Find the creation function for the subtype if not already known.
       if (symbolRegistry.count(type) == 0) {
-        postStatusMsg(2) << "#ospray: trying to look up "
-                         << type_string << " type '" << type
-                         << "' for the first time";
-
-        // Construct the name of the creation function to look for.
-        std::string creationFunctionName = "ospray_create_" + type_string
-                                           +  "__" + type;
-
-        // Look for the named function.
+        std::string creationFunctionName = "ospray_sg_generate_" + type;
         symbolRegistry[type] =
-            (creationFunctionPointer)getSymbol(creationFunctionName);
-
-        // The named function may not be found if the requested subtype is not
-        // known.
-        if (!symbolRegistry[type]) {
-          postStatusMsg(1) << "  WARNING: unrecognized " << type_string
-                           << " type '" << type << "'.";
-        }
+            (GeneratorFunction)getSymbol(creationFunctionName);
       }
 
-      // Create a concrete instance of the requested subtype.
-      auto *object = symbolRegistry[type] ? (*symbolRegistry[type])() : nullptr;
+      auto fcn = symbolRegistry[type];
 
-      // Denote the subclass type in the ManagedObject base class.
-      if (object) {
-        object->managedObjectType = OSP_TYPE;
-      }
+      if (fcn)
+        fcn(world, params);
       else {
         symbolRegistry.erase(type);
-        throw std::runtime_error("Could not find " + type_string + " of type: "
-          + type + ".  Make sure you have the correct OSPRay libraries linked.");
+        throw std::runtime_error("Could not find sg generator of type: "
+          + type + ".  Make sure you have the correct libraries loaded.");
       }
-
-      return object;
-      #endif
     }
 
     void Importer::importRegistryFileLoader(std::shared_ptr<Node> world,
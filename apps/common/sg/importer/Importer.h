@@ -52,6 +52,9 @@ namespace ospray {
     };
 
 
+    /*! list of 'name=value' parameters given to a scene generator */
+    using GeneratorParams = std::vector<std::pair<std::string,std::string>>;
+
     struct OSPSG_INTERFACE Importer : public sg::Renderable
     {
       Importer();
@@ -66,7 +69,8 @@ namespace ospray {
                      const FileName &fileName,
                      const FormatURL &fu) const;
       void importRegistryGenerator(std::shared_ptr<Node> world,
-                                   const std::string &type) const;
+                                   const std::string &type,
+                                   const GeneratorParams &params) const;
       void importRegistryFileLoader(std::shared_ptr<Node> world,
                                     const std::string &type,
                                     const FileName &fileName) const;
@@ -78,6 +82,12 @@ namespace ospray {
     using ImporterFunction = void (*)(std::shared_ptr<Node> world,
                                       const FileName &fileName);
 
+    /*! prototype for any scene graph generator function, i.e., an
+        'importer' which procedurally creates its contents instead of
+        reading them from a file */
+    using GeneratorFunction = void (*)(std::shared_ptr<Node> world,
+                                       const GeneratorParams &params);
+
     /*! declare an importer function for a given file extension */
     OSPSG_INTERFACE
     void declareImporterForFileExtension(const std::string &fileExtension,
@@ -158,5 +168,18 @@ namespace ospray {
     /* additional declaration to avoid "extra ;" -Wpedantic warnings */        \
     void ospray_sg_import_##name()
 
+    // Macro to register generators ///////////////////////////////////////////
+
+    /*! generators get invoked through a '--generate:<name>[:p=v[:...]]'
+        (or, without parameters, '--import:<name>') file name */
+#define OSPSG_REGISTER_GENERATE_FUNCTION(function, name)                       \
+    extern "C" void ospray_sg_generate_##name(std::shared_ptr<Node> world,     \
+                                              const GeneratorParams &params)   \
+    {                                                                          \
+      function(world, params);                                                 \
+    }                                                                          \
+    /* additional declaration to avoid "extra ;" -Wpedantic warnings */        \
+    void ospray_sg_generate_##name()
+
   } // ::ospray::sg
 } // ::ospray
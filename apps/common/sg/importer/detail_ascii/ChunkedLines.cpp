@@ -0,0 +1,227 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "ChunkedLines.h"
+
+// stdlib, for mmap
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+#include <fcntl.h>
+// stl
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+// O_LARGEFILE is a GNU extension.
+#ifdef __APPLE__
+#define  O_LARGEFILE  0
+#endif
+
+namespace ospray {
+  namespace sg {
+    namespace ascii {
+
+      MappedFile::MappedFile(const std::string &fileName)
+      {
+#ifdef _WIN32
+        HANDLE fileHandle = CreateFile(fileName.c_str(), GENERIC_READ,
+                                       FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                       FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+          throw std::runtime_error("#osp:sg: could not open '"+fileName+"'");
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize)) {
+          CloseHandle(fileHandle);
+          throw std::runtime_error("#osp:sg: could not stat '"+fileName+"'");
+        }
+        numBytes = fileSize.QuadPart;
+
+        if (numBytes > 0) {
+          HANDLE fileMappingHandle =
+            CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+          if (fileMappingHandle != nullptr) {
+            data = (const char *)MapViewOfFile(fileMappingHandle, FILE_MAP_READ,
+                                               0, 0, numBytes);
+            CloseHandle(fileMappingHandle);
+          }
+        }
+        CloseHandle(fileHandle);
+#else
+        int fd = ::open(fileName.c_str(), O_LARGEFILE | O_RDONLY);
+        if (fd == -1)
+          throw std::runtime_error("#osp:sg: could not open '"+fileName+"'");
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+          ::close(fd);
+          throw std::runtime_error("#osp:sg: could not stat '"+fileName+"'");
+        }
+        numBytes = st.st_size;
+
+        if (numBytes > 0) {
+          void *mem = mmap(nullptr, numBytes, PROT_READ, MAP_SHARED, fd, 0);
+          if (mem != MAP_FAILED) {
+            data = (const char *)mem;
+            // the whole file gets streamed through exactly once
+            madvise(mem, numBytes, MADV_SEQUENTIAL);
+          }
+        }
+        ::close(fd);
+#endif
+        if (numBytes > 0 && !data)
+          throw std::runtime_error("#osp:sg: could not map '"+fileName+"'");
+      }
+
+      MappedFile::~MappedFile()
+      {
+        if (!data)
+          return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap((void *)data, numBytes);
+#endif
+      }
+
+      bool parseFloat(const char *&s, const char *end, float &f)
+      {
+        static const double pow10[] = {
+          1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+          1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+          1e22
+        };
+
+        const char *p = skipBlanks(s, end);
+        const char *begin = p;
+
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+'))
+          neg = (*p++ == '-');
+
+        // up to 19 significant digits fit into the 64-bit mantissa, any
+        // digits beyond that only affect the exponent
+        uint64_t mantissa = 0;
+        int numDigits = 0;
+        int exponent = 0;
+        bool anyDigits = false;
+
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+          anyDigits = true;
+          if (numDigits < 19) {
+            mantissa = 10 * mantissa + (*p - '0');
+            numDigits += (mantissa != 0);
+          } else
+            exponent++;
+        }
+        if (p < end && *p == '.') {
+          for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+            anyDigits = true;
+            if (numDigits < 19) {
+              mantissa = 10 * mantissa + (*p - '0');
+              numDigits += (mantissa != 0);
+              exponent--;
+            }
+          }
+        }
+
+        if (!anyDigits) {
+          // inf, nan, ... - rare enough to take the slow path
+          char buf[64];
+          size_t len = 0;
+          while (begin + len < end && len < sizeof(buf) - 1 &&
+                 begin[len] != '\n' && !isBlank(begin[len]))
+            len++;
+          memcpy(buf, begin, len);
+          buf[len] = 0;
+          char *bufEnd = nullptr;
+          const double v = strtod(buf, &bufEnd);
+          if (bufEnd == buf)
+            return false;
+          f = float(v);
+          s = begin + (bufEnd - buf);
+          return true;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+          const char *q = p + 1;
+          bool negExp = false;
+          if (q < end && (*q == '-' || *q == '+'))
+            negExp = (*q++ == '-');
+          if (q < end && *q >= '0' && *q <= '9') {
+            int e = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; q++)
+              e = std::min(10 * e + (*q - '0'), 100000);
+            exponent += negExp ? -e : e;
+            p = q;
+          }
+        }
+
+        double v = double(mantissa);
+        if (mantissa == 0)
+          v = 0.0;
+        else if (exponent >= 0 && exponent <= 22)
+          v *= pow10[exponent];
+        else if (exponent < 0 && exponent >= -22)
+          v /= pow10[-exponent];
+        else
+          v *= std::pow(10.0, exponent);
+
+        f = float(neg ? -v : v);
+        s = p;
+        return true;
+      }
+
+      ChunkedLines::ChunkedLines(const char *begin, const char *end,
+                                 size_t chunkSize)
+      {
+        for (const char *s = begin; s < end;) {
+          const char *e = s + std::min<size_t>(chunkSize, end - s);
+          if (e < end)
+            e = nextLine(e - 1, end);
+          chunk.push_back({s, e});
+          s = e;
+        }
+
+        firstLine.resize(chunk.size());
+        ospcommon::tasking::parallel_for(chunk.size(), [&](size_t chunkID) {
+          size_t count = 0;
+          const char *s = chunk[chunkID].begin;
+          const char *end = chunk[chunkID].end;
+          while (s < end) {
+            const char *lineBegin = skipBlanks(s, end);
+            s = nextLine(lineBegin, end);
+            count += (lineBegin < end && *lineBegin != '\n');
+          }
+          firstLine[chunkID] = count;
+        });
+
+        for (auto &first : firstLine) {
+          const size_t count = first;
+          first = numLines;
+          numLines += count;
+        }
+      }
+
+    } // ::ospray::sg::ascii
+  } // ::ospray::sg
+} // ::ospray
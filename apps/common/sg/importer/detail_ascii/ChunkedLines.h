@@ -0,0 +1,180 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+// ospcommon
+#include "ospcommon/common.h"
+#include "ospcommon/tasking/parallel_for.h"
+// stl
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/*! \file detail_ascii/ChunkedLines.h helpers for parsing (large)
+    line-based ascii files in parallel: the file gets memory-mapped,
+    split into line-aligned chunks, and the chunks get parsed in
+    parallel, directly into pre-sized output arrays */
+
+namespace ospray {
+  namespace sg {
+    namespace ascii {
+
+      /*! read-only memory mapping of an entire file; unmapped again on
+          destruction. throws if the file cannot be opened */
+      struct MappedFile
+      {
+        MappedFile(const std::string &fileName);
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        const char *begin() const { return data; }
+        const char *end()   const { return data + numBytes; }
+        size_t      size()  const { return numBytes; }
+
+      private:
+        const char *data {nullptr};
+        size_t numBytes {0};
+      };
+
+      inline bool isBlank(char c)
+      {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+      }
+
+      /*! advance 's' over blanks (but not over the end of the line) */
+      inline const char *skipBlanks(const char *s, const char *end)
+      {
+        while (s < end && isBlank(*s)) s++;
+        return s;
+      }
+
+      /*! returns a pointer to the beginning of the line following 's' */
+      inline const char *nextLine(const char *s, const char *end)
+      {
+        const char *eol = (const char *)memchr(s, '\n', end - s);
+        return eol ? eol + 1 : end;
+      }
+
+      /*! parse a (locale-independent) floating point number starting at
+          's', skipping leading blanks; on success 's' points past the
+          number. way faster than strtof/sscanf for the plain
+          '[-]digits[.digits][e[-]digits]' case; anything else (inf,
+          nan, hex floats, ...) gets handed to strtod */
+      bool parseFloat(const char *&s, const char *end, float &f);
+
+      /*! parse a decimal integer starting at 's', skipping leading blanks */
+      inline bool parseInt(const char *&s, const char *end, int64_t &i)
+      {
+        const char *p = skipBlanks(s, end);
+        bool neg = false;
+        if (p < end && (*p == '-' || *p == '+'))
+          neg = (*p++ == '-');
+        if (p >= end || *p < '0' || *p > '9')
+          return false;
+        int64_t v = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+          v = 10 * v + (*p++ - '0');
+        i = neg ? -v : v;
+        s = p;
+        return true;
+      }
+
+      /*! parse the next blank-separated token (e.g., a name) starting at
+          's'; 'delim' is an additional (optional) separator */
+      inline bool parseToken(const char *&s, const char *end,
+                             std::string &token, char delim = ' ')
+      {
+        const char *p = skipBlanks(s, end);
+        const char *b = p;
+        while (p < end && *p != '\n' && *p != delim && !isBlank(*p)) p++;
+        if (p == b)
+          return false;
+        token.assign(b, p);
+        s = p;
+        return true;
+      }
+
+      /*! a line-aligned range of the file */
+      struct Chunk
+      {
+        const char *begin;
+        const char *end;
+      };
+
+      /*! the non-blank lines of [begin,end), split into line-aligned
+          chunks that get processed in parallel. lines are numbered
+          consecutively over all chunks, ignoring blank lines */
+      struct ChunkedLines
+      {
+        ChunkedLines(const char *begin, const char *end,
+                     size_t chunkSize = size_t(4) << 20);
+
+        /*! calls 'parseLine(lineBegin, lineEnd, lineID, chunkID)' for
+            each of the first 'maxLines' non-blank lines, in parallel
+            over all chunks. returns the number of leading lines that
+            were successfully parsed, i.e., the ID of the first line
+            for which 'parseLine' returned false (if any) */
+        template <typename ParseLine>
+        size_t parse(size_t maxLines, const ParseLine &parseLine) const;
+
+        size_t numLines {0};
+        std::vector<Chunk> chunk;
+        /*! ID of the first (non-blank) line in each chunk */
+        std::vector<size_t> firstLine;
+      };
+
+      // Inlined definitions //////////////////////////////////////////////////
+
+      template <typename ParseLine>
+      inline size_t ChunkedLines::parse(size_t maxLines,
+                                        const ParseLine &parseLine) const
+      {
+        maxLines = std::min(maxLines, numLines);
+        std::atomic<size_t> firstInvalid(maxLines);
+
+        ospcommon::tasking::parallel_for(chunk.size(), [&](size_t chunkID) {
+          size_t lineID = firstLine[chunkID];
+          const char *s = chunk[chunkID].begin;
+          const char *end = chunk[chunkID].end;
+          while (s < end && lineID < firstInvalid) {
+            const char *lineBegin = skipBlanks(s, end);
+            const char *next = nextLine(lineBegin, end);
+            const char *lineEnd = (next > lineBegin && next[-1] == '\n')
+                                  ? next - 1 : next;
+            s = next;
+            if (lineBegin == lineEnd)
+              continue;
+            if (!parseLine(lineBegin, lineEnd, lineID, chunkID)) {
+              size_t current = firstInvalid;
+              while (lineID < current &&
+                     !firstInvalid.compare_exchange_weak(current, lineID));
+              break;
+            }
+            lineID++;
+          }
+        });
+
+        return firstInvalid;
+      }
+
+    } // ::ospray::sg::ascii
+  } // ::ospray::sg
+} // ::ospray
@@ -15,8 +15,10 @@
 // ======================================================================== //
 
 #include "Model.h"
+#include "../detail_ascii/ChunkedLines.h"
 // stl
-#include <sstream>
+#include <iostream>
+#include <limits>
 
 namespace ospray {
   namespace particle {
@@ -49,146 +51,201 @@ namespace ospray {
       return it->second;
     }
 
-    void Model::loadXYZ(const std::string &fileName)
+    /*! parses the atom lines in [begin,end) (at most 'maxAtoms' of
+        them) in parallel over line-aligned chunks of the file.
+        'parseAtom(lineBegin,lineEnd,position,typeName)' parses a
+        single line. atom types get registered in order of their first
+        appearance in the file, and atoms get appended to the per-type
+        atom lists in file order */
+    template <typename ParseAtom>
+    inline void loadAtoms(Model &model,
+                          const std::string &fileName,
+                          const char *begin,
+                          const char *end,
+                          size_t maxAtoms,
+                          bool useTypeRadius,
+                          const ParseAtom &parseAtom)
     {
-      FILE *file = fopen(fileName.c_str(),"r");
-      if (!file)
-        throw std::runtime_error("could not open input file " + fileName);
+      sg::ascii::ChunkedLines lines(begin, end);
+      const size_t numChunks = lines.chunk.size();
+
+      /* while parsing, atom types are only known per chunk (in order of
+         their first appearance in that chunk) */
+      std::vector<std::map<std::string, int>> chunkTypeID(numChunks);
+      std::vector<std::vector<std::string>> chunkTypeName(numChunks);
+
+      std::vector<Model::Atom> atoms(std::min(maxAtoms, lines.numLines));
+      const size_t numAtoms =
+        lines.parse(atoms.size(),
+                    [&](const char *lineBegin, const char *lineEnd,
+                        size_t lineID, size_t chunkID) {
+          std::string typeName;
+          Model::Atom &a = atoms[lineID];
+          if (!parseAtom(lineBegin, lineEnd, a.position, typeName))
+            return false;
+          auto &typeID = chunkTypeID[chunkID];
+          auto it = typeID.find(typeName);
+          if (it == typeID.end()) {
+            const int newID = chunkTypeName[chunkID].size();
+            it = typeID.insert({typeName, newID}).first;
+            chunkTypeName[chunkID].push_back(typeName);
+          }
+          a.type = it->second;
+          return true;
+        });
+
+      if (numAtoms < atoms.size()) {
+        std::cout << "warning: in " << fileName << " (atom " << numAtoms
+                  << "): could not parse data line" << std::endl;
+      }
 
-      int numAtoms;
-      int rc = fscanf(file,"%i\n",&numAtoms);
-      PRINT(numAtoms);
+      // map the per-chunk atom types to the model's ones, in file order
+      std::vector<std::vector<int>> chunkTypeMap(numChunks);
+      for (size_t c = 0; c < numChunks; c++)
+        for (const auto &name : chunkTypeName[c])
+          chunkTypeMap[c].push_back(model.getAtomType(name));
+
+      const size_t numTypes = model.atomType.size();
+      auto chunkAtoms = [&](size_t c) {
+        const size_t first = std::min(lines.firstLine[c], numAtoms);
+        const size_t last  = c + 1 < numChunks
+                             ? std::min(lines.firstLine[c+1], numAtoms)
+                             : numAtoms;
+        return std::make_pair(first, last);
+      };
+
+      // count the atoms of each type per chunk...
+      std::vector<size_t> offset(numChunks * numTypes, 0);
+      tasking::parallel_for(numChunks, [&](size_t c) {
+        const auto range = chunkAtoms(c);
+        for (size_t i = range.first; i < range.second; i++) {
+          Model::Atom &a = atoms[i];
+          a.type = chunkTypeMap[c][a.type];
+          a.radius = useTypeRadius ? model.atomType[a.type]->radius : 0.f;
+          if (useTypeRadius && a.radius == 0.f)
+            a.radius = Model::defaultRadius;
+          offset[c * numTypes + a.type]++;
+        }
+      });
+
+      // ... size each type's atom list once...
+      std::vector<Model::Atom *> dest(numTypes, nullptr);
+      for (size_t t = 0; t < numTypes; t++) {
+        size_t count = 0;
+        for (size_t c = 0; c < numChunks; c++)
+          count += offset[c * numTypes + t];
+        if (count == 0)
+          continue;
+        auto &list = model.atom[t];
+        size_t sum = list.size();
+        for (size_t c = 0; c < numChunks; c++) {
+          const size_t n = offset[c * numTypes + t];
+          offset[c * numTypes + t] = sum;
+          sum += n;
+        }
+        list.resize(sum);
+        dest[t] = list.data();
+      }
+
+      // ... and scatter the atoms into them
+      tasking::parallel_for(numChunks, [&](size_t c) {
+        const auto range = chunkAtoms(c);
+        for (size_t i = range.first; i < range.second; i++) {
+          const Model::Atom &a = atoms[i];
+          dest[a.type][offset[c * numTypes + a.type]++] = a;
+        }
+      });
+    }
 
-      if (rc != 1) {
+    /*! parses the '<numAtoms>' header line of .xyz/.xyz3 files, and
+        returns a pointer to the first atom line (after the comment line) */
+    inline const char *parseAtomCount(const sg::ascii::MappedFile &file,
+                                      const std::string &fileName,
+                                      size_t &numAtoms)
+    {
+      const char *s = file.begin();
+      int64_t count = 0;
+      if (!sg::ascii::parseInt(s, file.end(), count) || count < 0) {
         throw std::runtime_error("could not parse .dat.xyz header in "
                                  "input file " + fileName);
       }
+      numAtoms = count;
+      PRINT(numAtoms);
+
+      // skip the rest of the header line, and the comment line
+      s = sg::ascii::nextLine(s, file.end());
+      return sg::ascii::nextLine(s, file.end());
+    }
+
+    inline bool parseChar(const char *&s, const char *end, char c)
+    {
+      s = sg::ascii::skipBlanks(s, end);
+      if (s == end || *s != c)
+        return false;
+      s++;
+      return true;
+    }
+
+    void Model::loadXYZ(const std::string &fileName)
+    {
+      sg::ascii::MappedFile file(fileName);
 
-      char line[10000];
-      if (!fgets(line,10000,file))
-        throw std::runtime_error("could not fgets");
+      size_t numAtoms = 0;
+      const char *atomLines = parseAtomCount(file, fileName, numAtoms);
 
       std::cout << "#" << fileName << " (.dat.xyz format): expecting "
                 << numAtoms << " atoms" << std::endl;
 
-      for (int i = 0; i < numAtoms; i++) {
-        char atomName[110];
-        Atom a;
-        vec3f n;
-        if (!fgets(line,10000,file)) {
-          std::stringstream ss;
-          ss << "in " << fileName << " (line " << (i+2) << "): "
-             << "unexpected end of file!?" << std::endl;
-#if 1
-          std::cout << "warning: " << ss.str() << std::endl;
-          break;
-#endif
-        }
-
-        rc = sscanf(line, "%100s %f %f %f %f %f %f\n", atomName,
-                    &a.position.x, &a.position.y, &a.position.z,
-                    &n.x, &n.y, &n.z);
-
-        if (rc != 7 && rc != 4) {
-          std::stringstream ss;
-          PRINT(rc);
-          PRINT(line);
-          ss << "in " << fileName << " (line " << (i+2) << "): "
-             << "could not parse .dat.xyz data line" << std::endl;
-#if 1
-          std::cout << "warning: " << ss.str() << std::endl;
-          break;
-#endif
-        }
-        a.type = getAtomType(atomName);
-        a.radius = atomType[a.type]->radius;
-        if (a.radius == 0.f)
-          a.radius = defaultRadius;
-        atom[a.type].push_back(a);
-      }
+      // "<type> <x> <y> <z> [<nx> <ny> <nz>]"; normals are ignored
+      loadAtoms(*this, fileName, atomLines, file.end(), numAtoms, true,
+                [](const char *s, const char *end,
+                   vec3f &pos, std::string &typeName) {
+                  return sg::ascii::parseToken(s, end, typeName)
+                      && sg::ascii::parseFloat(s, end, pos.x)
+                      && sg::ascii::parseFloat(s, end, pos.y)
+                      && sg::ascii::parseFloat(s, end, pos.z);
+                });
     }
 
     /*! load xyz files in which there is *no* atom count, but just a
         list of "type x y z" lines */
     void Model::loadXYZ2(const std::string &fileName)
     {
-      FILE *file = fopen(fileName.c_str(), "r");
-      if (!file)
-        throw std::runtime_error("could not open input file " + fileName);
-
-      int rc = 0;
-      char atomTypeName[1000];
-      vec3f pos;
-
-      while ((rc = fscanf(file, "%s %f %f %f\n",
-                          atomTypeName, &pos.x, &pos.y, &pos.z)) == 4) {
-        Atom a = {pos, 0, getAtomType(atomTypeName)};
-        atom[a.type].push_back(a);
-      }
-
-      if (rc != 4) {
-        std::cout << "#" << fileName << " (.xyz format): file may be truncated"
-                  << std::endl;
-      }
+      sg::ascii::MappedFile file(fileName);
+
+      loadAtoms(*this, fileName, file.begin(), file.end(),
+                std::numeric_limits<size_t>::max(), false,
+                [](const char *s, const char *end,
+                   vec3f &pos, std::string &typeName) {
+                  return sg::ascii::parseToken(s, end, typeName)
+                      && sg::ascii::parseFloat(s, end, pos.x)
+                      && sg::ascii::parseFloat(s, end, pos.y)
+                      && sg::ascii::parseFloat(s, end, pos.z);
+                });
     }
 
     void Model::loadXYZ3(const std::string &fileName)
     {
-      FILE *file = fopen(fileName.c_str(),"r");
-
-      if (!file)
-        throw std::runtime_error("could not open input file "+fileName);
+      sg::ascii::MappedFile file(fileName);
 
-      int numAtoms;
-
-      int rc = fscanf(file, "%i\n", &numAtoms);
-      PRINT(numAtoms);
-      if (rc != 1) {
-        throw std::runtime_error("could not parse .dat.xyz header in "
-                                 "input file "+fileName);
-      }
-
-      char line[10000];
-      if (!fgets(line,10000,file))
-        throw std::runtime_error("could not fgets");
+      size_t numAtoms = 0;
+      const char *atomLines = parseAtomCount(file, fileName, numAtoms);
 
       std::cout << "#" << fileName << " (.dat.xyz format): expecting "
                 << numAtoms << " atoms" << std::endl;
 
-      for (int i=0;i<numAtoms;i++) {
-        char atomName[110];
-        Atom a;
-        vec3f n;
-        if (!fgets(line,10000,file)) {
-          std::stringstream ss;
-          ss << "in " << fileName << " (line " << (i+2) << "): "
-             << "unexpected end of file!?" << std::endl;
-#if 1
-          std::cout << "warning: " << ss.str() << std::endl;
-          break;
-#endif
-        }
-
-        rc = sscanf(line, "%f,%f,%f,%s\n",
-                    &a.position.x, &a.position.y, &a.position.z, atomName);
-
-        if (rc != 7 && rc != 4) {
-          std::stringstream ss;
-          PRINT(rc);
-          PRINT(line);
-          ss << "in " << fileName << " (line " << (i+2) << "): "
-             << "could not parse .dat.xyz data line" << std::endl;
-#if 1
-          std::cout << "warning: " << ss.str() << std::endl;
-          break;
-#endif
-        }
-        a.type = getAtomType(atomName);
-        a.radius = atomType[a.type]->radius;
-        if (a.radius == 0.f)
-          a.radius = defaultRadius;
-        atom[a.type].push_back(a);
-      }
+      // "<x>,<y>,<z>,<type>"
+      loadAtoms(*this, fileName, atomLines, file.end(), numAtoms, true,
+                [](const char *s, const char *end,
+                   vec3f &pos, std::string &typeName) {
+                  return sg::ascii::parseFloat(s, end, pos.x)
+                      && parseChar(s, end, ',')
+                      && sg::ascii::parseFloat(s, end, pos.y)
+                      && parseChar(s, end, ',')
+                      && sg::ascii::parseFloat(s, end, pos.z)
+                      && parseChar(s, end, ',')
+                      && sg::ascii::parseToken(s, end, typeName);
+                });
     }
 
   } // ::ospray::particle
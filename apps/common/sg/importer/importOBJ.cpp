@@ -24,8 +24,13 @@
 #define TINYOBJLOADER_IMPLEMENTATION  // define this in only *one* .cc
 #include "../3rdParty/tiny_obj_loader.h"
 
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+
+#include <algorithm>
 #include <cstring>
 #include <sstream>
+#include <unordered_map>
 
 #define USE_INSTANCES 0
 
@@ -159,6 +164,102 @@ namespace ospray {
       return sgMaterials;
     }
 
+    /*! an indexed triangle mesh built from one tinyobj shape */
+    struct OBJMesh
+    {
+      std::vector<vec3f> vertex;
+      std::vector<vec3f> normal;
+      std::vector<vec2f> texcoord;
+      std::vector<vec3i> index;
+    };
+
+    struct OBJIndexHash
+    {
+      size_t operator()(const tinyobj::index_t &i) const
+      {
+        size_t h = std::hash<int>()(i.vertex_index);
+        h ^= std::hash<int>()(i.normal_index) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int>()(i.texcoord_index) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+      }
+    };
+
+    struct OBJIndexEqual
+    {
+      bool operator()(const tinyobj::index_t &a,
+                      const tinyobj::index_t &b) const
+      {
+        return a.vertex_index == b.vertex_index
+            && a.normal_index == b.normal_index
+            && a.texcoord_index == b.texcoord_index;
+      }
+    };
+
+    /*! turn a (triangulated) tinyobj mesh into an indexed mesh, where
+        all face corners referring to the same (position, normal,
+        texcoord) triple share a single vertex */
+    static OBJMesh buildIndexedMesh(const tinyobj::attrib_t &attrib,
+                                    const tinyobj::mesh_t &objMesh)
+    {
+      const auto &indices = objMesh.indices;
+
+      // only use normals/texcoords if every face corner has one
+      const bool hasNormals = !attrib.normals.empty()
+          && std::all_of(indices.begin(), indices.end(),
+                         [](const tinyobj::index_t &i) {
+                           return i.normal_index != -1;
+                         });
+      const bool hasTexcoords = !attrib.texcoords.empty()
+          && std::all_of(indices.begin(), indices.end(),
+                         [](const tinyobj::index_t &i) {
+                           return i.texcoord_index != -1;
+                         });
+
+      std::unordered_map<tinyobj::index_t, int, OBJIndexHash, OBJIndexEqual>
+          vertexIDs;
+      vertexIDs.reserve(indices.size());
+
+      OBJMesh mesh;
+      mesh.index.reserve(indices.size() / 3);
+
+      auto weldVertex = [&](tinyobj::index_t idx) {
+        if (!hasNormals)
+          idx.normal_index = -1;
+        if (!hasTexcoords)
+          idx.texcoord_index = -1;
+
+        auto inserted = vertexIDs.emplace(idx, int(mesh.vertex.size()));
+        if (inserted.second) {
+          mesh.vertex.push_back(vec3f(attrib.vertices[idx.vertex_index * 3 + 0],
+                                      attrib.vertices[idx.vertex_index * 3 + 1],
+                                      attrib.vertices[idx.vertex_index * 3 + 2]));
+          if (hasNormals) {
+            mesh.normal.push_back(vec3f(attrib.normals[idx.normal_index * 3 + 0],
+                                        attrib.normals[idx.normal_index * 3 + 1],
+                                        attrib.normals[idx.normal_index * 3 + 2]));
+          }
+          if (hasTexcoords) {
+            mesh.texcoord.push_back(
+                vec2f(attrib.texcoords[idx.texcoord_index * 2 + 0],
+                      attrib.texcoords[idx.texcoord_index * 2 + 1]));
+          }
+        }
+        return inserted.first->second;
+      };
+
+      for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        mesh.index.push_back(vec3i(weldVertex(indices[i + 0]),
+                                   weldVertex(indices[i + 1]),
+                                   weldVertex(indices[i + 2])));
+      }
+
+      mesh.vertex.shrink_to_fit();
+      mesh.normal.shrink_to_fit();
+      mesh.texcoord.shrink_to_fit();
+
+      return mesh;
+    }
+
     void importOBJ(const std::shared_ptr<Node> &world, const FileName &fileName)
     {
       tinyobj::attrib_t attrib;
@@ -203,6 +304,12 @@ namespace ospray {
       auto objInstance = createNode("instance", "Instance");
       world->add(objInstance);
 #endif
+      // assemble indexed, vertex-welded meshes for all shapes in parallel
+      std::vector<OBJMesh> meshes(numShapes);
+      tasking::parallel_for(numShapes, [&](size_t shapeID) {
+        meshes[shapeID] = buildIndexedMesh(attrib, shapes[shapeID].mesh);
+      });
+
       for (auto &shape : shapes) {
         for (int numVertsInFace : shape.mesh.num_face_vertices) {
           if (numVertsInFace != 3) {
@@ -214,63 +321,23 @@ namespace ospray {
         if (shapeCounter++ > (increment * incrementer + 1))
           std::cout << incrementer++ * 10 << "%\n";
 
+        auto &objMesh = meshes[shapeId];
+
         auto name = base_name + std::to_string(shapeId++) + '_' + shape.name;
         auto mesh = createNode(name, "TriangleMesh")->nodeAs<TriangleMesh>();
 
         auto v = createNode("vertex", "DataVector3f")->nodeAs<DataVector3f>();
-        auto numSrcIndices = shape.mesh.indices.size();
-        v->v.reserve(numSrcIndices);
+        v->v = std::move(objMesh.vertex);
 
         auto vi = createNode("index", "DataVector3i")->nodeAs<DataVector3i>();
-        vi->v.reserve(numSrcIndices / 3);
+        vi->v = std::move(objMesh.index);
 
         auto vn = createNode("normal", "DataVector3f")->nodeAs<DataVector3f>();
-        vn->v.reserve(numSrcIndices);
+        vn->v = std::move(objMesh.normal);
 
         auto vt =
             createNode("texcoord", "DataVector2f")->nodeAs<DataVector2f>();
-        vt->v.reserve(numSrcIndices);
-
-        for (size_t i = 0; i < shape.mesh.indices.size(); i += 3) {
-          auto idx0 = shape.mesh.indices[i + 0];
-          auto idx1 = shape.mesh.indices[i + 1];
-          auto idx2 = shape.mesh.indices[i + 2];
-
-          auto prim = vec3i(i + 0, i + 1, i + 2);
-          vi->push_back(prim);
-
-          v->push_back(vec3f(attrib.vertices[idx0.vertex_index * 3 + 0],
-                             attrib.vertices[idx0.vertex_index * 3 + 1],
-                             attrib.vertices[idx0.vertex_index * 3 + 2]));
-          v->push_back(vec3f(attrib.vertices[idx1.vertex_index * 3 + 0],
-                             attrib.vertices[idx1.vertex_index * 3 + 1],
-                             attrib.vertices[idx1.vertex_index * 3 + 2]));
-          v->push_back(vec3f(attrib.vertices[idx2.vertex_index * 3 + 0],
-                             attrib.vertices[idx2.vertex_index * 3 + 1],
-                             attrib.vertices[idx2.vertex_index * 3 + 2]));
-
-          // TODO create missing normals&texcoords if only some faces have them
-          if (!attrib.normals.empty() && idx0.normal_index != -1) {
-            vn->push_back(vec3f(attrib.normals[idx0.normal_index * 3 + 0],
-                                attrib.normals[idx0.normal_index * 3 + 1],
-                                attrib.normals[idx0.normal_index * 3 + 2]));
-            vn->push_back(vec3f(attrib.normals[idx1.normal_index * 3 + 0],
-                                attrib.normals[idx1.normal_index * 3 + 1],
-                                attrib.normals[idx1.normal_index * 3 + 2]));
-            vn->push_back(vec3f(attrib.normals[idx2.normal_index * 3 + 0],
-                                attrib.normals[idx2.normal_index * 3 + 1],
-                                attrib.normals[idx2.normal_index * 3 + 2]));
-          }
-
-          if (!attrib.texcoords.empty() && idx0.texcoord_index != -1) {
-            vt->push_back(vec2f(attrib.texcoords[idx0.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx0.texcoord_index * 2 + 1]));
-            vt->push_back(vec2f(attrib.texcoords[idx1.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx1.texcoord_index * 2 + 1]));
-            vt->push_back(vec2f(attrib.texcoords[idx2.texcoord_index * 2 + 0],
-                                attrib.texcoords[idx2.texcoord_index * 2 + 1]));
-          }
-        }
+        vt->v = std::move(objMesh.texcoord);
 
         mesh->add(v);
         mesh->add(vi);
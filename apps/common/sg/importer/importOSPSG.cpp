@@ -23,6 +23,53 @@
 namespace ospray {
   namespace sg {
 
+    /*! element type (e.g. "3f") of a DataVector/DataArray node type, or
+        an empty string if the type is not a data node */
+    static std::string dataElementType(const std::string &type)
+    {
+      for (const std::string prefix : {"DataVector", "DataArray"}) {
+        if (type.compare(0, prefix.size(), prefix) == 0)
+          return type.substr(prefix.size());
+      }
+      return "";
+    }
+
+    /*! create a data array of the given (DataVector/DataArray) node type
+        on top of 'num' elements in the mapped binary file, without
+        copying them; returns NULL for types that can not be mapped */
+    static std::shared_ptr<DataBuffer> createMappedData(const std::string &type,
+                                                        const unsigned char *ptr,
+                                                        size_t num)
+    {
+      const std::string elementType = dataElementType(type);
+      void *data = (void*)ptr;
+
+      if (elementType == "1uc")
+        return make_shared_aligned<DataArray1uc>(data, num);
+      else if (elementType == "1f")
+        return make_shared_aligned<DataArray1f>(data, num);
+      else if (elementType == "2f")
+        return make_shared_aligned<DataArray2f>(data, num);
+      else if (elementType == "3f")
+        return make_shared_aligned<DataArray3f>(data, num);
+      else if (elementType == "3fa")
+        return make_shared_aligned<DataArray3fa>(data, num);
+      else if (elementType == "4f")
+        return make_shared_aligned<DataArray4f>(data, num);
+      else if (elementType == "1i")
+        return make_shared_aligned<DataArray1i>(data, num);
+      else if (elementType == "2i")
+        return make_shared_aligned<DataArray2i>(data, num);
+      else if (elementType == "3i")
+        return make_shared_aligned<DataArray3i>(data, num);
+      else if (elementType == "4i")
+        return make_shared_aligned<DataArray4i>(data, num);
+      else if (elementType == "RAW")
+        return make_shared_aligned<DataArrayRAW>(data, num);
+
+      return nullptr;
+    }
+
     std::shared_ptr<sg::Node> parseXMLNode(const xml::Node &node,
                       const unsigned char *binBasePtr, std::shared_ptr<sg::Node> sgNode)
     {
@@ -63,6 +110,21 @@ namespace ospray {
       }
       for (const auto &child : node.child)
       {
+        // data stored in the binary file gets used directly from the mapping
+        const std::string ofs = child.getProp("ofs");
+        if (ofs != "" && binBasePtr)
+        {
+          auto data = createMappedData(child.getProp("type"),
+                                       binBasePtr + std::stoll(ofs),
+                                       std::stoll(child.getProp("num")));
+          if (data)
+          {
+            data->setName(child.name);
+            sgNode->add(data);
+            continue;
+          }
+        }
+
         if (sgNode->hasChild(child.name))
         {
           parseXMLNode(child, binBasePtr, sgNode->child(child.name).shared_from_this());
@@ -121,7 +183,7 @@ namespace ospray {
       node->traverse(MarkAllAsModified{});
     }
 
-    void writeNode(const std::string ptrName, const std::shared_ptr<sg::Node> &node, FILE* out, const int indent)
+    void writeNode(const std::string ptrName, const std::shared_ptr<sg::Node> &node, FILE* out, FILE* bin, const int indent)
     {
       for (int i=0;i<indent;i++)
         fprintf(out,"  ");
@@ -132,6 +194,27 @@ namespace ospray {
         fprintf(out, "<%s nodeName=\"%s\" type=\"%s\"",ptrName.c_str(), node->name().c_str(), type.c_str());
       else
     	  fprintf(out, "<%s type=\"%s\"",node->name().c_str(), type.c_str());
+
+      // write data arrays to the binary file, so they can be mapped when loading
+      auto data = std::dynamic_pointer_cast<DataBuffer>(node);
+      // (only types that createMappedData() can map back are written)
+      if (data && !data->empty() && createMappedData(type, nullptr, 0))
+      {
+        // keep all arrays 16-byte aligned in the binary file
+        // (64-bit offsets; 'long' is only 32 bits on Windows)
+        long long ofs =
+#ifdef _WIN32
+          _ftelli64(bin);
+#else
+          ftello(bin);
+#endif
+        while (ofs % 16) {
+          fputc(0, bin);
+          ofs++;
+        }
+        fwrite(data->base(), data->bytesPerElement(), data->size(), bin);
+        fprintf(out, " ofs=\"%lld\" num=\"%zu\"", ofs, data->size());
+      }
     	if (node->children().empty())
     	  fprintf(out, ">");
     	else
@@ -162,7 +245,7 @@ namespace ospray {
 
       for(auto child : node->children())
       {
-        writeNode(child.first, child.second, out, indent+1);
+        writeNode(child.first, child.second, out, bin, indent+1);
       }
       if (!node->children().empty())
       {
@@ -183,14 +266,15 @@ namespace ospray {
         throw std::runtime_error("ospray::XML error: could not open file for writing '"
                                  + fileName +"'");
       }
-      FILE *fbin = fopen((fileName+".bin").c_str(),"w");
+      // same naming as expected by loadOSPSG()
+      FILE *fbin = fopen((fileName+"bin").c_str(),"wb");
       if (!fbin) {
         throw std::runtime_error("ospray::XML error: could not open file for writing '"
                                  + fileName +"'");
       }
       fprintf(file,"<?xml version=\"%s\"?>\n","1.0");
       fprintf(file,"<!-- OSPRay Version 1.2.3 -->\n");
-      writeNode(root->name(), root, file, 1);
+      writeNode(root->name(), root, file, fbin, 1);
       fclose(file);
       fclose(fbin);
     }
@@ -29,8 +29,11 @@
 #include "SceneGraph.h"
 #include "sg/common/Texture2D.h"
 #include "sg/geometry/TriangleMesh.h"
+#include "detail_ascii/ChunkedLines.h"
 //
 #include "../3rdParty/ply.h"
+// stl
+#include <atomic>
 
 namespace ospray {
   namespace sg {
@@ -113,6 +116,197 @@ namespace ospray {
       };
 
 
+      /*! element of an ascii PLY file, and which of its properties we
+          keep: 'slot' maps each property to x/y/z/nx/ny/nz (vertices),
+          or to the vertex index list (faces); -1 means 'skip' */
+      struct ASCIIElement
+      {
+        enum { OTHER, VERTEX, FACE } kind;
+        PlyElement *element;
+        size_t firstLine;
+        std::vector<int> slot;
+      };
+
+      /*! reads the body of an (uncompressed) ascii PLY file, the header
+          of which was already parsed into 'ply'. each element is a
+          single line, so the file gets mapped, split into line-aligned
+          chunks, and parsed in parallel, directly into the (pre-sized)
+          vertex, normal and index arrays */
+      void readASCII(const std::string &fileName, PlyFile *ply,
+                     DataVector3f &pos, DataVector3f &nor, DataVector3i &idx)
+      {
+        ascii::MappedFile file(fileName);
+        const char *end = file.end();
+
+        const char *body = nullptr;
+        for (const char *s = file.begin(); s < end && !body;
+             s = ascii::nextLine(s, end)) {
+          if (end - s >= 10 && !strncmp(s, "end_header", 10))
+            body = ascii::nextLine(s, end);
+        }
+        if (!body) {
+          throw std::runtime_error("#osp:sg:ply: could not find end of "
+                                   "header in '"+fileName+"'");
+        }
+
+        std::vector<ASCIIElement> elements;
+        size_t numLines = 0;
+        size_t numVertices = 0;
+        size_t numFaces = 0;
+        bool hasNormals = false;
+
+        for (int i=0; i<ply->nelems; i++) {
+          PlyElement *e = ply->elems[i];
+          ASCIIElement element {ASCIIElement::OTHER, e, numLines,
+                                std::vector<int>(e->nprops, -1)};
+          if (equal_strings("vertex", e->name)) {
+            static const char *names[] = {"x", "y", "z", "nx", "ny", "nz"};
+            int found = 0;
+            for (int j=0; j<e->nprops; j++) {
+              for (int k=0; k<6; k++) {
+                if (!e->props[j]->is_list &&
+                    equal_strings((char*)names[k], e->props[j]->name)) {
+                  element.slot[j] = k;
+                  found |= 1 << k;
+                }
+              }
+            }
+            if ((found & 7) != 7) {
+              throw std::runtime_error("#osp:sg:ply: vertices don't have "
+                                       "x, y, and z in '"+fileName+"'");
+            }
+            hasNormals = (found & 0x38) == 0x38;
+            element.kind = ASCIIElement::VERTEX;
+            numVertices = e->num;
+          } else if (equal_strings("face", e->name)) {
+            bool found = false;
+            for (int j=0; j<e->nprops; j++) {
+              if (e->props[j]->is_list &&
+                  (equal_strings("vertex_indices", e->props[j]->name) ||
+                   equal_strings("vertex_index", e->props[j]->name))) {
+                element.slot[j] = 0;
+                found = true;
+              }
+            }
+            if (!found) {
+              throw std::runtime_error("#osp:sg:ply: faces must have vertex "
+                                       "indices in '"+fileName+"'");
+            }
+            element.kind = ASCIIElement::FACE;
+            numFaces = e->num;
+          }
+          numLines += e->num;
+          elements.push_back(element);
+        }
+
+        ascii::ChunkedLines lines(body, end);
+        if (lines.numLines < numLines) {
+          throw std::runtime_error("#osp:sg:ply: '"+fileName+"' is truncated");
+        }
+
+        pos.v.resize(numVertices);
+        if (hasNormals)
+          nor.v.resize(numVertices);
+        idx.v.resize(numFaces);
+
+        std::atomic<bool> nonTriangle(false);
+
+        const size_t numParsed =
+          lines.parse(numLines, [&](const char *s, const char *lineEnd,
+                                    size_t lineID, size_t) {
+            auto el = elements.begin();
+            while (el + 1 != elements.end() && (el + 1)->firstLine <= lineID)
+              ++el;
+            if (el->kind == ASCIIElement::OTHER)
+              return true;
+
+            const size_t i = lineID - el->firstLine;
+            float value[6];
+            int64_t vtx[3];
+            for (int j=0; j<el->element->nprops; j++) {
+              const int slot = el->slot[j];
+              float skip;
+              if (el->element->props[j]->is_list) {
+                int64_t n;
+                if (!ascii::parseInt(s, lineEnd, n))
+                  return false;
+                if (slot >= 0 && n != 3) {
+                  nonTriangle = true;
+                  return false;
+                }
+                for (int64_t k=0; k<n; k++) {
+                  if (slot >= 0 ? !ascii::parseInt(s, lineEnd, vtx[k])
+                                : !ascii::parseFloat(s, lineEnd, skip))
+                    return false;
+                }
+              } else if (!ascii::parseFloat(s, lineEnd,
+                                            slot >= 0 ? value[slot] : skip)) {
+                return false;
+              }
+            }
+
+            if (el->kind == ASCIIElement::VERTEX) {
+              pos.v[i] = vec3f(value[0], value[1], value[2]);
+              if (hasNormals)
+                nor.v[i] = vec3f(value[3], value[4], value[5]);
+            } else
+              idx.v[i] = vec3i(vtx[0], vtx[1], vtx[2]);
+            return true;
+          });
+
+        if (nonTriangle)
+          FATAL("can only read ply files made up of triangles...");
+        if (numParsed < numLines) {
+          throw std::runtime_error("#osp:sg:ply: could not parse line "
+                                   + std::to_string(numParsed)
+                                   + " of '" + fileName + "'");
+        }
+      }
+
+
+      /*! closes 'ply', and adds the arrays read from it to 'mesh' */
+      void finishFile(PlyFile *ply, std::shared_ptr<sg::TriangleMesh> mesh,
+                      std::shared_ptr<DataVector3f> pos,
+                      std::shared_ptr<DataVector3f> nor,
+                      std::shared_ptr<DataVector3i> idx)
+      {
+        int num_comments;
+
+        int num_obj_info;
+
+
+        ply_get_comments (ply, &num_comments);
+        ply_get_obj_info (ply, &num_obj_info);
+
+        ply_close (ply);
+
+        for (int i=0;i<ply->nelems;i++) {
+          if (ply->elems[i]) continue;
+          PlyElement *e = ply->elems[i];
+          if(!e) continue;
+          FREE(e->name);
+          FREE(e->store_prop);
+          if (e->props) {
+            for (int j=0;j<e->nprops;j++) {
+              PlyProperty *p = e->props[j];
+              if (!p) continue;
+              FREE(p->name);
+              FREE(p);
+            }
+            FREE(e->props);
+          }
+          FREE(e);
+        }
+
+        free(ply->elems);
+
+        mesh->add(idx);
+        mesh->add(pos);
+        if (!nor->v.empty())
+          mesh->add(nor);
+      }
+
+
       void readFile(const std::string &fileName, std::shared_ptr<sg::TriangleMesh> mesh)
       {
         int nprops;
@@ -139,7 +333,9 @@ namespace ospray {
         const char *filename = fileName.c_str();
         FILE *file;
 
-        if (strlen(filename) > 7 && !strcmp(filename+strlen(filename)-7,".ply.gz")) {
+        const bool gzipped =
+          strlen(filename) > 7 && !strcmp(filename+strlen(filename)-7,".ply.gz");
+        if (gzipped) {
 #ifdef _WIN32
           THROW_SG_ERROR("#osp:sg:ply: gzipped file not supported yet on Windows");
 #else
@@ -162,6 +358,14 @@ namespace ospray {
 
         ply_get_info (ply, &version, &file_type);
 
+        // uncompressed ascii files are parsed in parallel, everything
+        // else goes through the ply library
+        if (file_type == PLY_ASCII && !gzipped) {
+          readASCII(fileName, ply, *pos, *nor, *idx);
+          finishFile(ply, mesh, pos, nor, idx);
+          return;
+        }
+
         for (int i=0; i<nelems; i++) {
           int num_elems;
 
@@ -297,40 +501,7 @@ namespace ospray {
         }
 
 
-        int num_comments;
-
-        int num_obj_info;
-
-
-        ply_get_comments (ply, &num_comments);
-        ply_get_obj_info (ply, &num_obj_info);
-
-        ply_close (ply);
-
-        for (int i=0;i<ply->nelems;i++) {
-          if (ply->elems[i]) continue;
-          PlyElement *e = ply->elems[i];
-          if(!e) continue;
-          FREE(e->name);
-          FREE(e->store_prop);
-          if (e->props) {
-            for (int j=0;j<e->nprops;j++) {
-              PlyProperty *p = e->props[j];
-              if (!p) continue;
-              FREE(p->name);
-              FREE(p);
-            }
-            FREE(e->props);
-          }
-          FREE(e);
-        }
-
-        free(ply->elems);
-
-        mesh->add(idx);
-        mesh->add(pos);
-        if (!nor->v.empty())
-          mesh->add(nor);
+        finishFile(ply, mesh, pos, nor, idx);
       }
 
     } // ::ospray::sg::ply
@@ -16,6 +16,7 @@
 
 #include "Importer.h"
 #include "common/sg/SceneGraph.h"
+#include "detail_ascii/ChunkedLines.h"
 #include <memory>
 
 /*! \file sg/module/Importer.cpp Defines the interface for writing
@@ -70,17 +71,11 @@ namespace ospray {
       std::vector<vec3f> color;
     };
 
-    bool readOne(FILE *file, float *f, int N, bool ascii)
+    /*! parse one ascii record of 'N' floats from the given line */
+    inline bool parseRecord(const char *s, const char *end, float *f, int N)
     {
-      if (!ascii)
-        return fread(f,sizeof(float),N,file) == size_t(N);
-
-      // ascii:
-      for (int i=0;i<N;i++) {
-        int rc = fscanf(file,"%f",f+i);
-        if (rc == 0) return (i == 0);
-        rc = fscanf(file,"\n");
-      }
+      for (int i=0;i<N;i++)
+        if (!ascii::parseFloat(s,end,f[i])) return false;
       return true;
     }
 
@@ -98,9 +93,7 @@ namespace ospray {
       std::cout << "#osp.sg: importer for 'points': " << url.str() << std::endl;
 
       FormatURL fu(url.str());
-      FILE *file = fopen(fu.fileName.c_str(),"rb");
-      if (!file)
-        throw std::runtime_error("could not open file "+fu.fileName);
+      ascii::MappedFile file(fu.fileName);
 
       // read the data vector
       auto sphereData = std::make_shared<DataVectorT<Sphere,OSP_RAW>>();
@@ -133,16 +126,11 @@ namespace ospray {
       if (zPos == std::string::npos)
         throw std::runtime_error("invalid points format: no z component");
 
-      float * const f = (float *)alloca(sizeof(float)*numFloatsPerSphere);
-      box3f bounds;
-
       std::vector<float> mappedScalarVector;
-      float mappedScalarMin = +std::numeric_limits<float>::infinity();
-      float mappedScalarMax = -std::numeric_limits<float>::infinity();
 
-      while (readOne(file,f,numFloatsPerSphere,ascii)) {
-        // read one more sphere ....
-        Sphere s;
+      // converts one record to a sphere (and its mapped scalar)
+      auto setSphere = [&](size_t i, const float *f) {
+        Sphere &s = sphereData->v[i];
         s.position.x = f[xPos];
         s.position.y = f[yPos];
         s.position.z = f[zPos];
@@ -150,18 +138,58 @@ namespace ospray {
           = (rPos == std::string::npos)
           ? radius
           : f[rPos];
-        sphereData->v.push_back(s);
+        if (sPos != std::string::npos)
+          mappedScalarVector[i] = f[sPos];
+      };
+
+      size_t numSpheres = 0;
+      if (ascii) {
+        /* ascii files have one record per line; lines get parsed in
+           parallel, directly into the (pre-sized) data vector */
+        ascii::ChunkedLines lines(file.begin(),file.end());
+        sphereData->v.resize(lines.numLines);
+        if (sPos != std::string::npos)
+          mappedScalarVector.resize(lines.numLines);
+
+        numSpheres = lines.parse(lines.numLines,
+                                 [&](const char *begin, const char *end,
+                                     size_t lineID, size_t) {
+          float * const f = (float *)alloca(sizeof(float)*numFloatsPerSphere);
+          if (!parseRecord(begin,end,f,numFloatsPerSphere))
+            return false;
+          setSphere(lineID,f);
+          return true;
+        });
+      } else {
+        const size_t recordSize = sizeof(float)*numFloatsPerSphere;
+        numSpheres = file.size() / recordSize;
+        sphereData->v.resize(numSpheres);
+        if (sPos != std::string::npos)
+          mappedScalarVector.resize(numSpheres);
+
+        const float *records = (const float *)file.begin();
+        tasking::parallel_for(numSpheres, [&](size_t i) {
+          setSphere(i,records + i*numFloatsPerSphere);
+        });
+      }
+
+      // truncated at the first unreadable record; shrinking doesn't reallocate
+      sphereData->v.resize(numSpheres);
+      if (sPos != std::string::npos)
+        mappedScalarVector.resize(numSpheres);
+
+      box3f bounds;
+      for (const auto &s : sphereData->v) {
         bounds.extend(s.position-s.radius);
         bounds.extend(s.position+s.radius);
-
-        if (sPos != std::string::npos) {
-          mappedScalarVector.push_back(f[sPos]);
-          mappedScalarMin = std::min(mappedScalarMin,f[sPos]);
-          mappedScalarMax = std::max(mappedScalarMax,f[sPos]);
-        }
       }
 
-      fclose(file);
+      float mappedScalarMin = +std::numeric_limits<float>::infinity();
+      float mappedScalarMax = -std::numeric_limits<float>::infinity();
+      for (const auto &f : mappedScalarVector) {
+        mappedScalarMin = std::min(mappedScalarMin,f);
+        mappedScalarMax = std::max(mappedScalarMax,f);
+      }
 
       // create the node
       auto &sphereObject = world->createChild("spheres", "Spheres");
@@ -178,8 +206,10 @@ namespace ospray {
                   << std::endl;
         ColorMap cm(mappedScalarMin,mappedScalarMax);
         auto colorData = std::make_shared<DataVectorT<vec4f,OSP_RAW>>();
-        for (size_t i = 0; i < mappedScalarVector.size(); i++)
-          colorData->v.push_back(cm.colorFor(mappedScalarVector[i]));
+        colorData->v.resize(mappedScalarVector.size());
+        tasking::parallel_for(mappedScalarVector.size(), [&](size_t i) {
+          colorData->v[i] = cm.colorFor(mappedScalarVector[i]);
+        });
         colorData->setName("colorData");
         sphereObject.add(colorData);
       }
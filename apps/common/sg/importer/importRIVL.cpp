@@ -93,29 +93,31 @@ namespace ospray {
       txt->channels = channels;
       txt->depth = depth;
 
+      const size_t sz = size_t(width) * height;
+      const void *texels = (const char*)binBasePtr + ofs;
       if (channels == 4) { // RIVL bin stores alpha channel inverted, fix here
-        size_t sz = width * height;
         if (depth == 1) { // char
+          const vec4uc *src = (const vec4uc*)texels;
           vec4uc *texel = new vec4uc[sz];
-          memcpy(texel, (char*)binBasePtr+ofs, sz*sizeof(vec4uc));
           for (size_t p = 0; p < sz; p++)
-            texel[p].w = 255 - texel[p].w;
+            texel[p] = vec4uc(src[p].x, src[p].y, src[p].z, 255 - src[p].w);
           txt->texelData = std::make_shared<DataArray1uc>((unsigned char*)texel,
-                                                          width*height*sizeof(vec4uc),true);
+                                                          sz*sizeof(vec4uc),true);
         } else { // float
+          const vec4f *src = (const vec4f*)texels;
           vec4f *texel = new vec4f[sz];
-          memcpy(texel, (char*)binBasePtr+ofs, sz*sizeof(vec4f));
           for (size_t p = 0; p < sz; p++)
-            texel[p].w = 1.0f - texel[p].w;
+            texel[p] = vec4f(src[p].x, src[p].y, src[p].z, 1.0f - src[p].w);
           txt->texelData = std::make_shared<DataArray1uc>((unsigned char*)texel,
-                                                          width*height*sizeof(vec4f),true);
+                                                          sz*sizeof(vec4f),true);
         }
-      } else
-        txt->texelData = std::make_shared<DataArray1uc>((unsigned char*)(binBasePtr)+ofs,
-                                                       width*height*3,false);
+      } else {
+        // use the texels directly from the mapped binary file
+        txt->texelData = std::make_shared<DataArray1uc>((unsigned char*)texels,
+                                                        sz*channels*depth,false);
+      }
     }
 
-
     void parseMaterialTextures(std::shared_ptr<sg::Material> mat, const xml::Node &node)
     {
       size_t num = std::stoll(node.getProp("num"));
@@ -338,8 +340,7 @@ namespace ospray {
           if (!binBasePtr)
             throw std::runtime_error("xml file mapping to binary file, but binary file not present");
           auto normal =
-            std::make_shared<DataArray3f>((vec3f*)((char*)binBasePtr+ofs),
-                                          num, false);
+            make_shared_aligned<DataArray3f>((char*)binBasePtr+ofs, num);
           normal->setName("normal");
           mesh->add(normal);
         } else if (child.name == "texcoord") {
@@ -348,8 +349,7 @@ namespace ospray {
           if (!binBasePtr)
             throw std::runtime_error("xml file mapping to binary file, but binary file not present");
           auto texcoord =
-            std::make_shared<DataArray2f>((vec2f*)((char*)binBasePtr+ofs),
-                                          num, false);
+            make_shared_aligned<DataArray2f>((char*)binBasePtr+ofs, num);
           texcoord->setName("texcoord");
           mesh->add(texcoord);
         } else if (child.name == "prim") {
@@ -366,6 +366,7 @@ namespace ospray {
             createNode("prim.materialID",
                        "DataVector1i")->nodeAs<DataVector1i>();
 
+          primIDList->v.reserve(index->size());
           for(size_t i = 0; i < index->size(); i++)
             primIDList->v.push_back((*index)[i].w >> 16);
 
@@ -59,13 +59,21 @@ namespace ospray {
         vertices =
             createNode("vertices", "DataVector3f")->nodeAs<DataVector3f>();
         field = createNode("field", "DataVector1f")->nodeAs<DataVector1f>();
-        indices =
-            createNode("indices", "DataVector4i")->nodeAs<DataVector4i>();
+        tetrahedra =
+            createNode("tetrahedra", "DataVector4i")->nodeAs<DataVector4i>();
+        hexahedra =
+            createNode("hexahedra", "DataVector4i")->nodeAs<DataVector4i>();
+        wedges  = createNode("wedges", "DataVector1i")->nodeAs<DataVector1i>();
+        pyramids =
+            createNode("pyramids", "DataVector1i")->nodeAs<DataVector1i>();
       }
 
       std::shared_ptr<DataVector3f> vertices;
       std::shared_ptr<DataVector1f> field;
-      std::shared_ptr<DataVector4i> indices;
+      std::shared_ptr<DataVector4i> tetrahedra;
+      std::shared_ptr<DataVector4i> hexahedra;  // two vec4i per cell
+      std::shared_ptr<DataVector1i> wedges;
+      std::shared_ptr<DataVector1i> pyramids;
 
       template <class TReader>
       vtkDataSet *readVTKFile(const FileName &fileName)
@@ -97,22 +105,31 @@ namespace ospray {
           vtkCell *cell = dataSet->GetCell(i);
 
           if (cell->GetCellType() == VTK_TETRA) {
-            indices->push_back(vec4i(-1, -1, -1, -1));
-            indices->push_back(vec4i(cell->GetPointId(0),
-                                     cell->GetPointId(1),
-                                     cell->GetPointId(2),
-                                     cell->GetPointId(3)));
+            tetrahedra->push_back(vec4i(cell->GetPointId(0),
+                                        cell->GetPointId(1),
+                                        cell->GetPointId(2),
+                                        cell->GetPointId(3)));
           }
 
           if (cell->GetCellType() == VTK_HEXAHEDRON) {
-            indices->push_back(vec4i(cell->GetPointId(0),
-                                     cell->GetPointId(1),
-                                     cell->GetPointId(2),
-                                     cell->GetPointId(3)));
-            indices->push_back(vec4i(cell->GetPointId(4),
-                                     cell->GetPointId(5),
-                                     cell->GetPointId(6),
-                                     cell->GetPointId(7)));
+            hexahedra->push_back(vec4i(cell->GetPointId(0),
+                                       cell->GetPointId(1),
+                                       cell->GetPointId(2),
+                                       cell->GetPointId(3)));
+            hexahedra->push_back(vec4i(cell->GetPointId(4),
+                                       cell->GetPointId(5),
+                                       cell->GetPointId(6),
+                                       cell->GetPointId(7)));
+          }
+
+          if (cell->GetCellType() == VTK_WEDGE) {
+            for (int j = 0; j < 6; j++)
+              wedges->push_back(cell->GetPointId(j));
+          }
+
+          if (cell->GetCellType() == VTK_PYRAMID) {
+            for (int j = 0; j < 5; j++)
+              pyramids->push_back(cell->GetPointId(j));
           }
         }
 
@@ -153,8 +170,7 @@ namespace ospray {
         int c0, c1, c2, c3;
         for (int i = 0; i < nTetrahedra; i++) {
           in >> c0 >> c1 >> c2 >> c3;
-          indices->push_back(vec4i(-1, -1, -1, -1));
-          indices->push_back(vec4i(c0, c1, c2, c3));
+          tetrahedra->push_back(vec4i(c0, c1, c2, c3));
         }
       }
 
@@ -180,8 +196,17 @@ namespace ospray {
       auto &v = world->createChild("unstructured_volume", "UnstructuredVolume");
 
       v.add(mesh.vertices);
-      v.add(mesh.indices);
       v.add(mesh.field);
+
+      // only hand over the cell types actually present in the file
+      if (!mesh.tetrahedra->v.empty())
+        v.add(mesh.tetrahedra);
+      if (!mesh.hexahedra->v.empty())
+        v.add(mesh.hexahedra);
+      if (!mesh.wedges->v.empty())
+        v.add(mesh.wedges);
+      if (!mesh.pyramids->v.empty())
+        v.add(mesh.pyramids);
     }
 
   }  // ::ospray::sg
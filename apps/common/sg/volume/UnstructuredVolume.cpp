@@ -26,6 +26,8 @@ namespace ospray {
       createChild("hexMethod", "string", std::string("planar"))
         .setWhiteList({std::string("planar"),
               std::string("nonplanar")});
+      createChild("cellStep", "bool", false, NodeFlags::none,
+                  "adapt the ray marching step size to the current cell");
     }
 
     std::string UnstructuredVolume::toString() const
@@ -35,31 +37,21 @@ namespace ospray {
 
     void UnstructuredVolume::preCommit(RenderContext &)
     {
-      auto ospVolume = valueAs<OSPVolume>();
-
-      if (ospVolume) {
-        ospCommit(ospVolume);
-        if (child("isosurfaceEnabled").valueAs<bool>() == true
-            && isosurfacesGeometry) {
-          OSPData isovaluesData = ospNewData(1, OSP_FLOAT,
-            &child("isosurface").valueAs<float>());
-          ospSetData(isosurfacesGeometry, "isovalues", isovaluesData);
-          ospCommit(isosurfacesGeometry);
-        }
+      if (commitExistingVolume())
         return;
-      }
 
       setValue(ospNewVolume("unstructured_volume"));
 
       if (!hasChild("vertices"))
         throw std::runtime_error("#osp:sg UnstructuredVolume -> no 'vertices' array!");
-      else if (!hasChild("indices"))
-        throw std::runtime_error("#osp:sg UnstructuredVolume -> no 'indices' array!");
+      else if (!hasChild("indices") && !hasChild("tetrahedra")
+               && !hasChild("hexahedra") && !hasChild("wedges")
+               && !hasChild("pyramids"))
+        throw std::runtime_error("#osp:sg UnstructuredVolume -> no cell arrays!");
       else if (!hasChild("field"))
         throw std::runtime_error("#osp:sg UnstructuredVolume -> no 'field' array!");
 
       auto vertices   = child("vertices").nodeAs<DataBuffer>();
-      auto indices    = child("indices").nodeAs<DataBuffer>();
       auto field      = child("field").nodeAs<DataBuffer>();
 
       ospcommon::box3f bounds;
@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "Volume.h"
+#include "../common/Data.h"
 #include "../common/Model.h"
 // core ospray
 #include "ospray/common/OSPCommon.h"
@@ -105,6 +106,7 @@ namespace ospray {
                   -std::numeric_limits<float>::infinity(),
                   NodeFlags::valid_min_max |
                   NodeFlags::gui_slider).setMinMax(0.f,255.f);
+      createChild("isosurfaceExtract", "bool", false);
     }
 
     std::string Volume::toString() const
@@ -136,6 +138,26 @@ namespace ospray {
       }
     }
 
+    bool Volume::commitExistingVolume()
+    {
+      auto ospVolume = valueAs<OSPVolume>();
+      if (!ospVolume)
+        return false;
+
+      ospCommit(ospVolume);
+      if (child("isosurfaceEnabled").valueAs<bool>() == true
+          && isosurfacesGeometry) {
+        OSPData isovaluesData = ospNewData(1, OSP_FLOAT,
+          &child("isosurface").valueAs<float>());
+        ospSetData(isosurfacesGeometry, "isovalues", isovaluesData);
+        ospRelease(isovaluesData);
+        ospSet1i(isosurfacesGeometry, "extract",
+                 child("isosurfaceExtract").valueAs<bool>());
+        ospCommit(isosurfacesGeometry);
+      }
+      return true;
+    }
+
     // =======================================================
     // structured volume class
     // =======================================================
@@ -153,6 +175,53 @@ namespace ospray {
               vec3f(dimensions)*child("gridSpacing").valueAs<vec3f>()};
     }
 
+    void StructuredVolume::preCommit(RenderContext &)
+    {
+      if (commitExistingVolume())
+        return;
+
+      // without in-memory voxels there is nothing to create (yet)
+      if (!hasChild("voxelData"))
+        return;
+
+      if (dimensions.x <= 0 || dimensions.y <= 0 || dimensions.z <= 0)
+        THROW_SG_ERROR("invalid volume dimensions");
+
+      auto voxels = child("voxelData").nodeAs<DataBuffer>();
+      const size_t nVoxels =
+          (size_t)dimensions.x * (size_t)dimensions.y * (size_t)dimensions.z;
+      if (voxels->size() != nVoxels)
+        THROW_SG_ERROR("'voxelData' does not match the volume dimensions");
+
+      voxelType = stringForType(voxels->getType());
+
+      OSPVolume ospVolume = ospNewVolume("shared_structured_volume");
+
+      if (!ospVolume)
+        THROW_SG_ERROR("could not allocate volume");
+
+      isosurfacesGeometry = ospNewGeometry("isosurfaces");
+      ospSetObject(isosurfacesGeometry, "volume", ospVolume);
+
+      setValue(ospVolume);
+
+      ospSetString(ospVolume,"voxelType",voxelType.c_str());
+      ospSetVec3i(ospVolume,"dimensions",(const osp::vec3i&)dimensions);
+
+      vec2f voxelRange(std::numeric_limits<float>::infinity(),
+                       -std::numeric_limits<float>::infinity());
+      extendVoxelRange(voxelRange, voxels->getType(),
+                       (const unsigned char *)voxels->base(), nVoxels);
+
+      child("voxelRange") = voxelRange;
+      child("transferFunction")["valueRange"] = voxelRange;
+
+      child("isosurface").setMinMax(voxelRange.x, voxelRange.y);
+      float iso = child("isosurface").valueAs<float>();
+      if (iso < voxelRange.x || iso > voxelRange.y)
+        child("isosurface") = (voxelRange.y - voxelRange.x) / 2.f;
+    }
+
     OSP_REGISTER_SG_NODE(StructuredVolume);
 
     // =======================================================
@@ -168,28 +237,16 @@ namespace ospray {
 
     void StructuredVolumeFromFile::preCommit(RenderContext &)
     {
-      auto ospVolume = valueAs<OSPVolume>();
-
-      if (ospVolume) {
-        ospCommit(ospVolume);
-        if (child("isosurfaceEnabled").valueAs<bool>() == true
-            && isosurfacesGeometry) {
-          OSPData isovaluesData = ospNewData(1, OSP_FLOAT,
-            &child("isosurface").valueAs<float>());
-          ospSetData(isosurfacesGeometry, "isovalues", isovaluesData);
-          ospCommit(isosurfacesGeometry);
-        }
+      if (commitExistingVolume())
         return;
-      }
 
-      if (dimensions.x <= 0 || dimensions.y <= 0 || dimensions.z <= 0) {
-        throw std::runtime_error("StructuredVolume::render(): "
-                                 "invalid volume dimensions");
-      }
+      if (dimensions.x <= 0 || dimensions.y <= 0 || dimensions.z <= 0)
+        THROW_SG_ERROR("invalid volume dimensions");
 
       bool useBlockBricked = true;
-      ospVolume = ospNewVolume(useBlockBricked ? "block_bricked_volume" :
-                                                 "shared_structured_volume");
+      OSPVolume ospVolume =
+          ospNewVolume(useBlockBricked ? "block_bricked_volume" :
+                                         "shared_structured_volume");
 
       if (!ospVolume)
         THROW_SG_ERROR("could not allocate volume");
@@ -36,13 +36,22 @@ namespace ospray {
       virtual void postRender(RenderContext &ctx) override;
 
       OSPGeometry isosurfacesGeometry{nullptr};
+
+    protected:
+
+      /*! commit the already created volume and update its isosurfaces,
+          returns false if there is no volume yet */
+      bool commitExistingVolume();
     };
 
-    /*! a plain old structured volume */
+    /*! a plain old structured volume; the voxels are taken from a
+        'voxelData' (data buffer) child, if present */
     struct OSPSG_INTERFACE StructuredVolume : public Volume
     {
       std::string toString() const override;
 
+      void preCommit(RenderContext &ctx) override;
+
       //! return bounding box of all primitives
       box3f bounds() const override;
 
@@ -0,0 +1,100 @@
+// ======================================================================== //
+// Copyright 2016-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file testMessageRate Measures the message rate of maml: every
+    rank sends a given number of (small) messages to every other rank,
+    and waits until it has received all messages sent to it. Run with
+    different MAML_COALESCE_* settings to compare the rates with and
+    without message coalescing, e.g.
+
+      mpirun -n 4 ./ospray_test_mamlTestMessageRate --messages 100000 --size 64
+*/
+
+#include "ospcommon/tasking/tasking_system_handle.h"
+#include "maml/maml.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+static std::atomic<size_t> numReceived;
+
+struct CountHandler : public maml::MessageHandler
+{
+  void incoming(const std::shared_ptr<maml::Message> &) override
+  {
+    ++numReceived;
+  }
+};
+
+extern "C" int main(int ac, char **av)
+{
+  MPI_CALL(Init(&ac, &av));
+  ospcommon::tasking::initTaskingSystem();
+
+  int rank = -1;
+  int numRanks = 0;
+  MPI_CALL(Comm_size(MPI_COMM_WORLD, &numRanks));
+  MPI_CALL(Comm_rank(MPI_COMM_WORLD, &rank));
+
+  size_t numMessages = 10000;
+  size_t payloadSize = 64;
+
+  for (int i = 1; i < ac; ++i) {
+    const std::string arg = av[i];
+    if (arg == "--messages" && i + 1 < ac)
+      numMessages = std::stoul(av[++i]);
+    else if (arg == "--size" && i + 1 < ac)
+      payloadSize = std::stoul(av[++i]);
+  }
+
+  const size_t expected = (numRanks - 1) * numMessages;
+
+  CountHandler handler;
+  maml::registerHandlerFor(MPI_COMM_WORLD, &handler);
+
+  maml::start();
+  MPI_CALL(Barrier(MPI_COMM_WORLD));
+
+  double t0 = ospcommon::getSysTime();
+  for (size_t mID = 0; mID < numMessages; mID++) {
+    for (int r = 0; r < numRanks; r++) {
+      if (r == rank)
+        continue;
+      auto msg = maml::newMessage(payloadSize);
+      memset(msg->data, mID & 0xff, payloadSize);
+      maml::sendTo(MPI_COMM_WORLD, r, msg);
+    }
+  }
+
+  while (numReceived < expected)
+    std::this_thread::yield();
+  double t1 = ospcommon::getSysTime();
+
+  maml::stop();
+  MPI_CALL(Barrier(MPI_COMM_WORLD));
+
+  const double secs = t1 - t0;
+  printf("rank %i: received %zu messages of %zu bytes in %lf secs;"
+         " that is %s messages/s, %sB/s\n",
+         rank, (size_t)numReceived, payloadSize, secs,
+         ospcommon::prettyNumber(numReceived / secs).c_str(),
+         ospcommon::prettyNumber(numReceived * payloadSize / secs).c_str());
+
+  MPI_CALL(Finalize());
+  return 0;
+}
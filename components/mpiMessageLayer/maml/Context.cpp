@@ -15,7 +15,11 @@
 // ======================================================================== //
 
 #include "Context.h"
+#include "MessagePool.h"
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <thread>
 
 #include "ospcommon/memory/malloc.h"
 #include "ospcommon/tasking/async.h"
@@ -32,6 +36,128 @@ namespace maml {
   /*! the singleton object that handles all the communication */
   std::unique_ptr<Context> Context::singleton = make_unique<Context>();
 
+  // Batches of coalesced messages ////////////////////////////////////////////
+  //
+  // A batch is sent with maml's reserved tag, and consists of the number
+  // of messages (as uint64) plus one BatchEntry header per message,
+  // followed by the payloads of all messages. The headers and each
+  // payload are padded to a multiple of BATCH_ALIGNMENT bytes, so that
+  // received messages can point right into the batch and still keep the
+  // alignment of a freshly allocated message (receivers, e.g., read tiles
+  // in place with aligned vector loads).
+
+  namespace {
+
+    struct BatchEntry
+    {
+      int32_t  tag;
+      uint32_t size;
+    };
+
+    static const size_t BATCH_ALIGNMENT = 64;
+
+    inline size_t paddedSize(size_t size)
+    {
+      return (size + BATCH_ALIGNMENT - 1) & ~(BATCH_ALIGNMENT - 1);
+    }
+
+    inline size_t batchHeaderSize(size_t numMessages)
+    {
+      return paddedSize(sizeof(uint64_t) + numMessages * sizeof(BatchEntry));
+    }
+
+    inline size_t batchEntrySize(const Message &msg)
+    {
+      return sizeof(BatchEntry) + paddedSize(msg.size);
+    }
+
+    /*! a message that was received as part of a batch; keeps the batch
+        alive, and does not own its payload */
+    struct BatchedMessage : public Message
+    {
+      BatchedMessage(const std::shared_ptr<Message> &batch,
+                     ospcommon::byte_t *payload, size_t size)
+        : batch(batch)
+      {
+        data = payload;
+        this->size = size;
+      }
+
+      /* set data to null to keep the parent from deleting it */
+      ~BatchedMessage() override
+      {
+        data = nullptr;
+      }
+
+      std::shared_ptr<Message> batch;
+    };
+
+  } // ::maml::<anonymous>
+
+  // Context::RequestSlots definitions ////////////////////////////////////////
+
+  void Context::RequestSlots::resize(size_t numSlots)
+  {
+    requests.assign(numSlots, MPI_REQUEST_NULL);
+    messages.assign(numSlots, nullptr);
+    done.resize(numSlots);
+    freeSlots.resize(numSlots);
+    // hand out low slots first, so used slots stay close together
+    for (size_t i = 0; i < numSlots; ++i)
+      freeSlots[i] = int(numSlots - 1 - i);
+  }
+
+  MPI_Request *Context::RequestSlots::acquire(std::shared_ptr<Message> msg)
+  {
+    const int slot = freeSlots.back();
+    freeSlots.pop_back();
+    messages[slot] = std::move(msg);
+    return &requests[slot];
+  }
+
+  size_t
+  Context::RequestSlots::complete(std::vector<std::shared_ptr<Message>> &completed)
+  {
+    return completeSome(completed, false);
+  }
+
+  size_t
+  Context::RequestSlots::waitSome(std::vector<std::shared_ptr<Message>> &completed)
+  {
+    return completeSome(completed, true);
+  }
+
+  size_t
+  Context::RequestSlots::completeSome(std::vector<std::shared_ptr<Message>> &completed,
+                                      bool wait)
+  {
+    if (empty())
+      return 0;
+
+    int numDone = 0;
+    if (wait) {
+      MPI_CALL(Waitsome(requests.size(), requests.data(), &numDone,
+                        done.data(), MPI_STATUSES_IGNORE));
+    } else {
+      MPI_CALL(Testsome(requests.size(), requests.data(), &numDone,
+                        done.data(), MPI_STATUSES_IGNORE));
+    }
+
+    if (numDone == MPI_UNDEFINED)
+      return 0;
+
+    for (int i = 0; i < numDone; ++i) {
+      const int slot = done[i];
+      requests[slot] = MPI_REQUEST_NULL;
+      completed.push_back(std::move(messages[slot]));
+      freeSlots.push_back(slot);
+    }
+
+    return numDone;
+  }
+
+  // Context definitions //////////////////////////////////////////////////////
+
   Context::~Context()
   {
     stop();
@@ -59,7 +185,80 @@ namespace maml {
     stopped */
   void Context::send(std::shared_ptr<Message> msg)
   {
-    outbox.push_back(msg);
+    if (directSends && tasksAreRunning) {
+      std::lock_guard<std::mutex> lock(directSendMutex);
+      while (directSendSlots.full())
+        completeDirectSendRequests(true);
+
+      auto &m = *msg;
+      MPI_Request *request = directSendSlots.acquire(std::move(msg));
+      MPI_CALL(Isend(m.data, m.size, MPI_BYTE, m.rank,
+                     m.tag, m.comm, request));
+    } else {
+      outbox.push_back(std::move(msg));
+      wakeUp();
+    }
+  }
+
+  void Context::wakeUp()
+  {
+    if (sleeping) {
+      std::lock_guard<std::mutex> lock(wakeMutex);
+      wakeCondition.notify_one();
+    }
+  }
+
+  bool Context::progress()
+  {
+    bool didWork = sendMessagesFromOutbox();
+    didWork |= completeSendRequests();
+    didWork |= postQueuedSends();
+    didWork |= pollForAndRecieveMessages();
+    didWork |= completeRecvRequests();
+
+    if (directSends) {
+      // don't hold up threads that are sending right now
+      std::unique_lock<std::mutex> lock(directSendMutex, std::try_to_lock);
+      if (lock.owns_lock())
+        didWork |= completeDirectSendRequests(false);
+    }
+
+    return didWork;
+  }
+
+  void Context::idle()
+  {
+    ++idleIterations;
+
+    if (idleIterations <= idleSpinIterations)
+      return;
+
+    if (idleIterations <= 2 * idleSpinIterations) {
+      std::this_thread::yield();
+      return;
+    }
+
+    const int shift = std::min(idleIterations - 2 * idleSpinIterations, 20);
+    int sleepUs = std::min(1 << shift, maxIdleSleepUs);
+
+    // requests in flight need MPI calls to progress, and pending batches
+    // must not be held back for longer than the coalescing window
+    if (!sendQueue.empty() || !sendSlots.empty() || !recvSlots.empty())
+      sleepUs = std::min(sleepUs, 50);
+
+    for (const auto &it : batches) {
+      if (!it.second.messages.empty()) {
+        sleepUs = std::min(sleepUs, int(coalesceWindow * 1e6));
+        break;
+      }
+    }
+
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    sleeping = true;
+    wakeCondition.wait_for(lock, std::chrono::microseconds(sleepUs), [&]() {
+      return !outbox.empty() || !tasksAreRunning;
+    });
+    sleeping = false;
   }
 
   void Context::processInboxMessages()
@@ -74,109 +273,240 @@ namespace maml {
     }
   }
 
-  void Context::sendMessagesFromOutbox()
+  void Context::isend(std::shared_ptr<Message> msg)
+  {
+    sendQueue.push_back(std::move(msg));
+  }
+
+  bool Context::postQueuedSends()
+  {
+    bool posted = false;
+
+    while (!sendQueue.empty() && !sendSlots.full()) {
+      auto msg = std::move(sendQueue.front());
+      sendQueue.pop_front();
+
+      auto &m = *msg;
+      MPI_Request *request = sendSlots.acquire(std::move(msg));
+      MPI_CALL(Isend(m.data, m.size, MPI_BYTE, m.rank,
+                     m.tag, m.comm, request));
+      posted = true;
+    }
+
+    return posted;
+  }
+
+  bool Context::sendMessagesFromOutbox()
   {
-    if (!outbox.empty()) {
+    const bool hasOutgoing = !outbox.empty();
+
+    if (hasOutgoing) {
       auto outgoingMessages = outbox.consume();
 
       for (auto &msg : outgoingMessages) {
-        MPI_Request request;
-        MPI_CALL(Isend(msg->data, msg->size, MPI_BYTE, msg->rank,
-                       msg->tag, msg->comm, &request));
-        pendingSends.push_back(request);
-        sendCache.push_back(std::move(msg));
+        if (msg->size > maxCoalescedMessageSize) {
+          // send anything queued for this destination first, to keep
+          // the order of messages
+          flushBatch(msg->comm, msg->rank);
+          isend(std::move(msg));
+          continue;
+        }
+
+        auto &batch = batches[std::make_pair(msg->comm, msg->rank)];
+        if (batch.messages.empty())
+          batch.firstQueued = ospcommon::getSysTime();
+
+        batch.numBytes += batchEntrySize(*msg);
+        batch.messages.push_back(std::move(msg));
+
+        if (batch.numBytes >= maxBatchSize)
+          flushBatch(batch.messages.back()->comm, batch.messages.back()->rank);
       }
     }
+
+    flushBatches(false);
+
+    return hasOutgoing;
   }
 
-  void Context::pollForAndRecieveMessages()
+  void Context::flushBatch(MPI_Comm comm, int rank)
   {
+    auto found = batches.find(std::make_pair(comm, rank));
+    if (found == batches.end() || found->second.messages.empty())
+      return;
+
+    auto &batch = found->second;
+
+    if (batch.messages.size() == 1) {
+      isend(std::move(batch.messages.front()));
+    } else {
+      const uint64_t numMessages = batch.messages.size();
+      const size_t headerSize = batchHeaderSize(numMessages);
+      size_t payloadSize = 0;
+      for (const auto &m : batch.messages)
+        payloadSize += paddedSize(m->size);
+
+      auto msg = MessagePool::instance()->newMessage(headerSize + payloadSize);
+      msg->comm = comm;
+      msg->rank = rank;
+      msg->tag  = RESERVED_BATCH_TAG;
+
+      auto *header = msg->data;
+      memcpy(header, &numMessages, sizeof(numMessages));
+      header += sizeof(numMessages);
+
+      auto *out = msg->data + headerSize;
+      for (const auto &m : batch.messages) {
+        BatchEntry entry;
+        entry.tag  = m->tag;
+        entry.size = m->size;
+        memcpy(header, &entry, sizeof(entry));
+        header += sizeof(entry);
+        memcpy(out, m->data, m->size);
+        out += paddedSize(m->size);
+      }
+
+      isend(std::move(msg));
+    }
+
+    batch.messages.clear();
+    batch.numBytes = 0;
+  }
+
+  void Context::flushBatches(bool force)
+  {
+    if (batches.empty())
+      return;
+
+    const double now = ospcommon::getSysTime();
+    for (auto &it : batches) {
+      const auto &batch = it.second;
+      if (!batch.messages.empty() &&
+          (force || now - batch.firstQueued >= coalesceWindow)) {
+        flushBatch(it.first.first, it.first.second);
+      }
+    }
+  }
+
+  void Context::unpackBatch(const std::shared_ptr<Message> &batch)
+  {
+    auto *header = batch->data;
+    uint64_t numMessages = 0;
+    memcpy(&numMessages, header, sizeof(numMessages));
+    header += sizeof(numMessages);
+
+    auto *in = batch->data + batchHeaderSize(numMessages);
+    for (uint64_t i = 0; i < numMessages; ++i) {
+      BatchEntry entry;
+      memcpy(&entry, header, sizeof(entry));
+      header += sizeof(entry);
+
+      auto msg = std::make_shared<BatchedMessage>(batch, in, entry.size);
+      msg->rank = batch->rank;
+      msg->tag  = entry.tag;
+      msg->comm = batch->comm;
+      inbox.push_back(std::move(msg));
+
+      in += paddedSize(entry.size);
+    }
+  }
+
+  bool Context::pollForAndRecieveMessages()
+  {
+    bool received = false;
+
     for (auto &it : handlers) {
       MPI_Comm comm = it.first;
 
-      /* probe if there's something incoming on this handler's comm */
-      int hasIncoming = 0;
-      MPI_Status status;
-      MPI_CALL(Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG,
-                      comm, &hasIncoming, &status));
+      /* probe if there's something incoming on this handler's comm, as
+         long as there are receive slots left */
+      while (!recvSlots.full()) {
+        int hasIncoming = 0;
+        MPI_Status status;
+        MPI_CALL(Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG,
+                        comm, &hasIncoming, &status));
+
+        if (!hasIncoming)
+          break;
 
-      if (hasIncoming) {
         int size;
         MPI_CALL(Get_count(&status, MPI_BYTE, &size));
 
-        auto msg = std::make_shared<Message>(size);
+        auto msg = MessagePool::instance()->newMessage(size);
         msg->rank = status.MPI_SOURCE;
         msg->tag  = status.MPI_TAG;
         msg->comm = comm;
 
-        MPI_Request request;
-        MPI_CALL(Irecv(msg->data, size, MPI_BYTE, msg->rank,
-                       msg->tag, msg->comm, &request));
-        pendingRecvs.push_back(request);
-        recvCache.push_back(std::move(msg));
+        auto &m = *msg;
+        MPI_Request *request = recvSlots.acquire(std::move(msg));
+        MPI_CALL(Irecv(m.data, size, MPI_BYTE, m.rank,
+                       m.tag, m.comm, request));
+        received = true;
       }
     }
+
+    return received;
   }
 
-  void Context::waitOnSomeSendRequests()
+  bool Context::completeSendRequests()
   {
-    if (!pendingSends.empty()) {
-      int numDone = 0;
-      int *done = STACK_BUFFER(int, pendingSends.size());
-
-      MPI_CALL(Testsome(pendingSends.size(), pendingSends.data(), &numDone,
-                        done, MPI_STATUSES_IGNORE));
-
-      for (int i = 0; i < numDone; ++i) {
-        int pendingSendCompletedIndex = done[i];
-        pendingSends[pendingSendCompletedIndex] = MPI_REQUEST_NULL;
-        sendCache[pendingSendCompletedIndex].reset();
-      }
-
-      sendCache.erase(std::remove(sendCache.begin(),
-                                  sendCache.end(),
-                                  nullptr), sendCache.end());
-
-      pendingSends.erase(std::remove(pendingSends.begin(),
-                                     pendingSends.end(),
-                                     MPI_REQUEST_NULL), pendingSends.end());
-    }
+    completed.clear();
+    const size_t numDone = sendSlots.complete(completed);
+    completed.clear();
+    return numDone > 0;
   }
 
-  void Context::waitOnSomeRecvRequests()
+  bool Context::completeRecvRequests(bool block)
   {
-    if (!pendingRecvs.empty()) {
-      int numDone = 0;
-      int *done = STACK_BUFFER(int, pendingRecvs.size());
-
-      MPI_CALL(Waitsome(pendingRecvs.size(), pendingRecvs.data(), &numDone,
-                        done, MPI_STATUSES_IGNORE));
+    completed.clear();
+    const size_t numDone = block ? recvSlots.waitSome(completed)
+                                 : recvSlots.complete(completed);
+    if (numDone == 0)
+      return false;
+
+    for (auto &msg : completed) {
+      if (msg->tag == RESERVED_BATCH_TAG)
+        unpackBatch(msg);
+      else
+        inbox.push_back(std::move(msg));
+    }
+    completed.clear();
 
-      for (int i = 0; i < numDone; ++i) {
-        int pendingRecvCompletedIndex = done[i];
-        pendingRecvs[pendingRecvCompletedIndex] = MPI_REQUEST_NULL;
-        inbox.push_back(std::move(recvCache[pendingRecvCompletedIndex]));
-      }
+    std::lock_guard<std::mutex> lock(inboxMutex);
+    inboxCondition.notify_one();
 
-      recvCache.erase(std::remove(recvCache.begin(),
-                                  recvCache.end(),
-                                  nullptr), recvCache.end());
+    return true;
+  }
 
-      pendingRecvs.erase(std::remove(pendingRecvs.begin(),
-                                     pendingRecvs.end(),
-                                     MPI_REQUEST_NULL), pendingRecvs.end());
-    }
+  /*! NOTE: the caller has to hold 'directSendMutex' */
+  bool Context::completeDirectSendRequests(bool block)
+  {
+    directSendsCompleted.clear();
+    const size_t numDone = block ? directSendSlots.waitSome(directSendsCompleted)
+                                 : directSendSlots.complete(directSendsCompleted);
+    directSendsCompleted.clear();
+    return numDone > 0;
   }
 
   void Context::flushRemainingMessages()
   {
     sendMessagesFromOutbox();
+    flushBatches(true);
 
-    while (!pendingRecvs.empty() && !pendingSends.empty() && !inbox.empty()) {
-      waitOnSomeRecvRequests();
-      waitOnSomeSendRequests();
-      processInboxMessages();
+    completeSendRequests();
+    postQueuedSends();
+
+    // receives that were already posted will complete without help
+    // from other ranks
+    while (!recvSlots.empty())
+      completeRecvRequests(true);
+
+    if (directSends) {
+      std::lock_guard<std::mutex> lock(directSendMutex);
+      completeDirectSendRequests(false);
     }
+
+    processInboxMessages();
   }
 
   /*! start the service; from this point on maml is free to use MPI
@@ -186,7 +516,48 @@ namespace maml {
   void Context::start()
   {
     if (!isRunning()) {
-      tasksAreRunning = true;
+      auto maxMessageSize =
+        getEnvVar<int>("MAML_COALESCE_MAX_MESSAGE_SIZE");
+      if (maxMessageSize)
+        maxCoalescedMessageSize = std::max(maxMessageSize.value(), 0);
+
+      auto batchSize = getEnvVar<int>("MAML_COALESCE_MAX_BATCH_SIZE");
+      if (batchSize)
+        maxBatchSize = std::max(batchSize.value(), 0);
+
+      auto windowUs = getEnvVar<int>("MAML_COALESCE_WINDOW_US");
+      if (windowUs)
+        coalesceWindow = std::max(windowUs.value(), 0) * 1e-6;
+
+      auto maxPending = getEnvVar<int>("MAML_MAX_PENDING_REQUESTS");
+      const size_t numSlots =
+        maxPending ? std::max(maxPending.value(), 1) : 128;
+      if (sendSlots.empty())
+        sendSlots.resize(numSlots);
+      if (recvSlots.empty())
+        recvSlots.resize(numSlots);
+
+      auto spin = getEnvVar<int>("MAML_IDLE_SPIN");
+      if (spin)
+        idleSpinIterations = std::max(spin.value(), 0);
+
+      auto maxSleepUs = getEnvVar<int>("MAML_MAX_IDLE_SLEEP_US");
+      if (maxSleepUs)
+        maxIdleSleepUs = std::max(maxSleepUs.value(), 0);
+
+      directSends = false;
+      auto MAML_DIRECT_SENDS = getEnvVar<int>("MAML_DIRECT_SENDS");
+      if (MAML_DIRECT_SENDS && MAML_DIRECT_SENDS.value()) {
+        int threadLevel = 0;
+        MPI_CALL(Query_thread(&threadLevel));
+        directSends = threadLevel == MPI_THREAD_MULTIPLE;
+        if (!directSends) {
+          std::cerr << "#maml: MAML_DIRECT_SENDS requires MPI_THREAD_MULTIPLE,"
+                    << " sending through the outbox instead" << std::endl;
+        } else if (directSendSlots.empty()) {
+          directSendSlots.resize(numSlots);
+        }
+      }
 
       auto launchMethod = AsyncLoop::LaunchMethod::AUTO;
 
@@ -198,20 +569,30 @@ namespace maml {
 
       if (!sendReceiveThread.get()) {
         sendReceiveThread = make_unique<AsyncLoop>([&](){
-          sendMessagesFromOutbox();
-          pollForAndRecieveMessages();
-
-          waitOnSomeSendRequests();
-          waitOnSomeRecvRequests();
+          if (progress())
+            idleIterations = 0;
+          else
+            idle();
         }, launchMethod);
       }
 
       if (!processInboxThread.get()) {
         processInboxThread = make_unique<AsyncLoop>([&](){
+          {
+            std::unique_lock<std::mutex> lock(inboxMutex);
+            inboxCondition.wait_for(lock,
+                                    std::chrono::microseconds(maxIdleSleepUs),
+                                    [&]() {
+                                      return !inbox.empty() || !tasksAreRunning;
+                                    });
+          }
           processInboxMessages();
         }, launchMethod);
       }
 
+      idleIterations = 0;
+      tasksAreRunning = true;
+
       sendReceiveThread->start();
       processInboxThread->start();
     }
@@ -230,8 +611,20 @@ namespace maml {
   void Context::stop()
   {
     tasksAreRunning = false;
-    sendReceiveThread->stop();
-    processInboxThread->stop();
+
+    if (sendReceiveThread) {
+      wakeUp();
+      sendReceiveThread->stop();
+    }
+
+    if (processInboxThread) {
+      {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inboxCondition.notify_one();
+      }
+      processInboxThread->stop();
+    }
+
     flushRemainingMessages();
   }
 
@@ -21,6 +21,9 @@
 #include "ospcommon/AsyncLoop.h"
 #include "ospcommon/containers/TransactionalBuffer.h"
 //stl
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
 #include <map>
 #include <mutex>
@@ -57,11 +60,46 @@ namespace maml {
 
     /*! put the given message in the outbox. note that this can be
         done even if the actual sending mechanism is currently
-        stopped */
+        stopped. with direct sends enabled (see 'directSends'), the
+        message gets sent right away from the calling thread instead */
     void send(std::shared_ptr<Message> msg);
 
   private:
 
+    /*! a fixed number of slots for MPI requests that are in flight,
+        along with the messages they send/receive into. completed
+        requests free their slot again */
+    struct RequestSlots
+    {
+      void resize(size_t numSlots);
+
+      bool empty() const { return freeSlots.size() == requests.size(); }
+      bool full()  const { return freeSlots.empty(); }
+
+      /*! reserve a free slot for 'msg'; returns the request to be
+          filled in by the MPI call. must not be called if 'full()' */
+      MPI_Request *acquire(std::shared_ptr<Message> msg);
+
+      /*! test for completed requests (without blocking); the messages
+          of completed requests are appended to 'completed', and their
+          slots get freed */
+      size_t complete(std::vector<std::shared_ptr<Message>> &completed);
+
+      /*! like 'complete()', but blocks until at least one request is
+          done (if any is pending) */
+      size_t waitSome(std::vector<std::shared_ptr<Message>> &completed);
+
+    private:
+
+      size_t completeSome(std::vector<std::shared_ptr<Message>> &completed,
+                          bool wait);
+
+      std::vector<MPI_Request> requests;
+      std::vector<std::shared_ptr<Message>> messages;
+      std::vector<int> freeSlots;
+      std::vector<int> done;
+    };
+
     // Helper functions //
 
     /*! the thread (function) that executes all MPI commands to
@@ -85,39 +123,117 @@ namespace maml {
     */
     void mpiSendAndRecieveTask();
 
+    /*! one iteration of the send/receive thread; returns whether any
+        progress was made */
+    bool progress();
+
+    /*! back off after 'progress()' did not do anything: spin for a
+        few iterations, then yield, then sleep for increasingly long
+        times (until woken up by a new outgoing message) */
+    void idle();
+
     /*! the thread that executes messages that the receiver thread
         put into the inbox */
     void processInboxTask();
 
     void processInboxMessages();
 
-    void sendMessagesFromOutbox();
-    void pollForAndRecieveMessages();
-
-    void waitOnSomeSendRequests();
-    void waitOnSomeRecvRequests();
+    bool sendMessagesFromOutbox();
+    bool pollForAndRecieveMessages();
+
+    /*! queue the given message for sending; it is sent as soon as a
+        send slot is available */
+    void isend(std::shared_ptr<Message> msg);
+    /*! post MPI_Isends for queued messages, as long as there are free
+        send slots */
+    bool postQueuedSends();
+
+    /*! send the queued small messages to the given destination as a
+        single batch */
+    void flushBatch(MPI_Comm comm, int rank);
+    /*! flush all batches older than the coalescing window (or all
+        non-empty batches, if 'force' is set) */
+    void flushBatches(bool force);
+    /*! split a received batch into its messages, and put them into the
+        inbox */
+    void unpackBatch(const std::shared_ptr<Message> &batch);
+
+    bool completeSendRequests();
+    bool completeRecvRequests(bool block = false);
+    bool completeDirectSendRequests(bool block);
+
+    /*! wake up the send/receive thread, if it is sleeping */
+    void wakeUp();
 
     void flushRemainingMessages();
 
     // Data members //
 
-    bool tasksAreRunning {false};
+    std::atomic<bool> tasksAreRunning {false};
 
     ospcommon::TransactionalBuffer<std::shared_ptr<Message>> inbox;
     ospcommon::TransactionalBuffer<std::shared_ptr<Message>> outbox;
 
-    // NOTE(jda) - sendCache/pendingSends MUST correspond with each other by
-    //             their index in their respective vectors...
-    std::vector<std::shared_ptr<Message>> sendCache;
-    std::vector<MPI_Request>              pendingSends;
+    /*! messages waiting for a free send slot, in sending order */
+    std::deque<std::shared_ptr<Message>> sendQueue;
+
+    /*! requests in flight; the number of slots is configurable through
+        MAML_MAX_PENDING_REQUESTS. no new receives are posted while all
+        receive slots are in use */
+    RequestSlots sendSlots;
+    RequestSlots recvSlots;
+
+    /*! scratch space for messages of completed requests */
+    std::vector<std::shared_ptr<Message>> completed;
+
+    /*! send messages directly from the calling thread, rather than
+        through the outbox; requires MPI_THREAD_MULTIPLE, and is
+        enabled through MAML_DIRECT_SENDS. bypasses coalescing */
+    bool directSends {false};
+    RequestSlots directSendSlots;
+    std::mutex   directSendMutex;
+    std::vector<std::shared_ptr<Message>> directSendsCompleted;
 
-    // NOTE(jda) - recvCache/pendingRecvs MUST correspond with each other by
-    //             their index in their respective vectors...
-    std::vector<std::shared_ptr<Message>> recvCache;
-    std::vector<MPI_Request>              pendingRecvs;
+    // Back-off when idle //
+
+    /*! number of consecutive iterations without any progress */
+    int idleIterations {0};
+    /*! idle iterations spent spinning (and then yielding) before
+        starting to sleep; configurable through MAML_IDLE_SPIN */
+    int idleSpinIterations {64};
+    /*! longest time (in microseconds) to sleep when idle; configurable
+        through MAML_MAX_IDLE_SLEEP_US */
+    int maxIdleSleepUs {1000};
+
+    std::atomic<bool>       sleeping {false};
+    std::mutex              wakeMutex;
+    std::condition_variable wakeCondition;
+
+    std::mutex              inboxMutex;
+    std::condition_variable inboxCondition;
 
     std::map<MPI_Comm, MessageHandler *> handlers;
 
+    /*! small messages waiting to be sent as a batch to one destination */
+    struct Batch
+    {
+      std::vector<std::shared_ptr<Message>> messages;
+      size_t numBytes {0};
+      double firstQueued {0.0};
+    };
+
+    std::map<std::pair<MPI_Comm, int>, Batch> batches;
+
+    /*! messages up to this size get coalesced (0 disables coalescing);
+        configurable through MAML_COALESCE_MAX_MESSAGE_SIZE */
+    size_t maxCoalescedMessageSize {32 * 1024};
+    /*! batches get sent once they reach this size (in bytes);
+        configurable through MAML_COALESCE_MAX_BATCH_SIZE */
+    size_t maxBatchSize {512 * 1024};
+    /*! maximum time (in seconds) small messages are held back for
+        coalescing; configurable through MAML_COALESCE_WINDOW_US */
+    double coalesceWindow {100e-6};
+
     bool useTaskingSystem {true};
 
     // NOTE(jda) - these are only used when _not_ using the tasking sytem...
@@ -0,0 +1,107 @@
+// ======================================================================== //
+// Copyright 2016-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "MessagePool.h"
+
+namespace maml {
+
+  /*! a message whose payload belongs to the pool; the pool is kept alive
+      for as long as any of its messages are */
+  struct MessagePool::PooledMessage : public Message
+  {
+    PooledMessage(const std::shared_ptr<MessagePool> &pool, size_t size)
+      : pool(pool)
+    {
+      data = pool->allocate(size, sizeClass);
+      this->size = size;
+    }
+
+    /* hand the payload back to the pool, and set data to null to keep
+       the parent from deleting it */
+    ~PooledMessage() override
+    {
+      pool->release(data, sizeClass);
+      data = nullptr;
+    }
+
+    std::shared_ptr<MessagePool> pool;
+    int sizeClass {-1};
+  };
+
+  MessagePool::~MessagePool()
+  {
+    for (auto &buffers : freeBuffers)
+      for (auto *buffer : buffers)
+        free(buffer);
+  }
+
+  std::shared_ptr<MessagePool> MessagePool::instance()
+  {
+    static std::shared_ptr<MessagePool> pool = std::make_shared<MessagePool>();
+    return pool;
+  }
+
+  std::shared_ptr<Message> MessagePool::newMessage(size_t size)
+  {
+    return std::make_shared<PooledMessage>(instance(), size);
+  }
+
+  ospcommon::byte_t *MessagePool::allocate(size_t size, int &sizeClass)
+  {
+    sizeClass = -1;
+    for (int c = 0; c < NUM_CLASSES; c++) {
+      if (size <= (size_t(1) << (c + MIN_CLASS_BITS))) {
+        sizeClass = c;
+        break;
+      }
+    }
+
+    // too large to be pooled
+    if (sizeClass < 0)
+      return (ospcommon::byte_t *)malloc(size);
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto &buffers = freeBuffers[sizeClass];
+      if (!buffers.empty()) {
+        auto *buffer = buffers.back();
+        buffers.pop_back();
+        freeBytes -= size_t(1) << (sizeClass + MIN_CLASS_BITS);
+        return buffer;
+      }
+    }
+
+    return (ospcommon::byte_t *)
+      malloc(size_t(1) << (sizeClass + MIN_CLASS_BITS));
+  }
+
+  void MessagePool::release(ospcommon::byte_t *buffer, int sizeClass)
+  {
+    if (sizeClass >= 0) {
+      std::lock_guard<std::mutex> lock(mutex);
+      const size_t bufferSize = size_t(1) << (sizeClass + MIN_CLASS_BITS);
+      if (freeBytes + bufferSize <= MAX_FREE_BYTES) {
+        freeBuffers[sizeClass].push_back(buffer);
+        freeBytes += bufferSize;
+        return;
+      }
+    }
+
+    free(buffer);
+  }
+
+} // ::maml
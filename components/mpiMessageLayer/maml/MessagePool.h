@@ -0,0 +1,62 @@
+// ======================================================================== //
+// Copyright 2016-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+#include "maml.h"
+#include <mutex>
+#include <vector>
+
+namespace maml {
+
+  /*! a pool of message payload buffers, in power-of-two size classes.
+      buffers of (pooled) messages go back to the pool when the message
+      dies, so steady streams of similarly sized messages (e.g., tiles)
+      do not hit the heap for every message. the free buffers are
+      capped by their total size, not per size class */
+  struct MessagePool
+  {
+    ~MessagePool();
+
+    /*! the pool used by maml (never destroyed before the last message) */
+    static std::shared_ptr<MessagePool> instance();
+
+    /*! create a message with (at least) 'size' bytes of payload storage,
+        and its size set to 'size' */
+    std::shared_ptr<Message> newMessage(size_t size);
+
+  private:
+
+    ospcommon::byte_t *allocate(size_t size, int &sizeClass);
+    void release(ospcommon::byte_t *buffer, int sizeClass);
+
+    struct PooledMessage;
+
+    // Data members //
+
+    static constexpr int MIN_CLASS_BITS = 8;   // 256 bytes
+    static constexpr int MAX_CLASS_BITS = 24;  // 16 MB
+    static constexpr int NUM_CLASSES = MAX_CLASS_BITS - MIN_CLASS_BITS + 1;
+    //! max number of bytes kept in free buffers, over all size classes
+    static constexpr size_t MAX_FREE_BYTES = size_t(64) << 20;
+
+    std::mutex mutex;
+    std::vector<ospcommon::byte_t *> freeBuffers[NUM_CLASSES];
+    size_t freeBytes {0};
+  };
+
+} // ::maml
@@ -16,6 +16,7 @@
 
 #include "maml.h"
 #include "Context.h"
+#include "MessagePool.h"
 
 namespace maml {
 
@@ -59,10 +60,17 @@ namespace maml {
   {
     if (!(rank >= 0 && msg.get()))
       OSPRAY_THROW("Incorrect argument values given to maml::sendTo(...)");
+    if (msg->tag == RESERVED_BATCH_TAG)
+      OSPRAY_THROW("maml::sendTo(...): message uses maml's reserved tag");
 
     msg->rank = rank;
     msg->comm = comm;
     Context::singleton->send(msg);
   }
   
+  std::shared_ptr<Message> newMessage(size_t size)
+  {
+    return MessagePool::instance()->newMessage(size);
+  }
+
 } // ::maml
@@ -82,4 +82,14 @@ namespace maml {
                                     int rank,
                                     std::shared_ptr<Message> msg);
 
+  /*! create a new message with 'size' bytes of payload. the payload
+      storage comes from (and goes back to, once the message dies) a
+      pool of buffers maml also uses for received messages, so prefer
+      this over allocating messages directly for frequent messages */
+  OSPRAY_MAML_INTERFACE std::shared_ptr<Message> newMessage(size_t size);
+
+  /*! tag reserved by maml for batches of coalesced small messages; it
+      must not be used for messages sent through maml */
+  static const int RESERVED_BATCH_TAG = 32767;
+
 } // ::maml
@@ -133,6 +133,11 @@ namespace ospcommon
     }
     
     socket_t bind(unsigned short port)
+    {
+      return bind(nullptr, port);
+    }
+
+    socket_t bind(const char* host, unsigned short port)
     {
       initialize();
 
@@ -155,6 +160,13 @@ namespace ospcommon
       serv_addr.sin_port = (unsigned short) htons(port);
       serv_addr.sin_addr.s_addr = INADDR_ANY;
 
+      /*! perform DNS lookup of the interface to bind to */
+      if (host) {
+        struct hostent* server = ::gethostbyname(host);
+        if (server == nullptr) THROW_RUNTIME_ERROR("host "+std::string(host)+" not found");
+        memcpy((char*)&serv_addr.sin_addr.s_addr, (char*)server->h_addr, server->h_length);
+      }
+
       if (::bind(sockfd, (struct sockaddr*) &serv_addr, sizeof(serv_addr)) < 0)
         THROW_RUNTIME_ERROR("binding to port "+std::to_string((long long)port)+" failed");
       
@@ -40,6 +40,10 @@ namespace ospcommon
   /*! creates a socket bound to a port */
   OSPCOMMON_INTERFACE socket_t bind(unsigned short port);
 
+  /*! creates a socket bound to a port on the interface of the given
+      host address only */
+  OSPCOMMON_INTERFACE socket_t bind(const char* host, unsigned short port);
+
   /*! listens for an incoming connection and accepts that connection */
   OSPCOMMON_INTERFACE socket_t listen(socket_t sockfd);
 
@@ -0,0 +1,54 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "SocketFabric.h"
+
+namespace ospcommon {
+  namespace networking {
+
+    SocketFabric::SocketFabric(socket_t socket)
+      : socket(socket)
+    {
+    }
+
+    SocketFabric::~SocketFabric()
+    {
+      ospcommon::close(socket);
+    }
+
+    void SocketFabric::send(void *mem, size_t size)
+    {
+      const uint64_t size64 = size;
+      ospcommon::write(socket, &size64, sizeof(size64));
+      ospcommon::write(socket, mem, size);
+      ospcommon::flush(socket);
+    }
+
+    size_t SocketFabric::read(void *&mem)
+    {
+      uint64_t size64 = 0;
+      ospcommon::read(socket, &size64, sizeof(size64));
+
+      buffer.resize(size64);
+      ospcommon::read(socket, buffer.data(), size64);
+
+      mem = buffer.data();
+      return size64;
+    }
+
+  } // ::ospcommon::networking
+} // ::ospcommon
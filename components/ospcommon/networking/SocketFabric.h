@@ -0,0 +1,51 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+#include "Fabric.h"
+#include "Socket.h"
+// stl
+#include <vector>
+
+namespace ospcommon {
+  namespace networking {
+
+    /*! a fabric over a (connected) TCP socket, between exactly two
+        peers. every block of data is sent with its size up front, so
+        the receiving side gets back the very same blocks. the fabric
+        takes ownership of the socket and closes it on destruction */
+    struct OSPCOMMON_INTERFACE SocketFabric : public Fabric
+    {
+      SocketFabric(socket_t socket);
+      ~SocketFabric() override;
+
+      /*! send exact number of bytes, and flush the socket */
+      void   send(void *mem, size_t size) override;
+
+      /*! receive the next block of data the other side has sent; the
+          returned memory stays valid until the next call to 'read()' */
+      size_t read(void *&mem) override;
+
+    private:
+
+      socket_t socket;
+      std::vector<byte_t> buffer;
+    };
+
+  } // ::ospcommon::networking
+} // ::ospcommon
@@ -212,11 +212,13 @@ namespace ospray {
       OSPPickResult pick(OSPRenderer renderer,
                          const vec2f &screenPos) override;
 
-    private:
+    protected:
 
       void initializeDevice();
 
-      void processWork(work::Work &work, bool flushWriteStream = false);
+      /*! send the work item to the workers, and run its master side */
+      virtual void processWork(work::Work &work,
+                               bool flushWriteStream = false);
 
       /*! This only exists to support getting the voxel type for setRegion */
       int getString(OSPObject object, const char *name, char **value);
@@ -0,0 +1,223 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "mpi/RemoteDevice.h"
+// ospcommon
+#include "ospcommon/networking/BufferedDataStreaming.h"
+// std
+#include <chrono>
+#include <thread>
+
+namespace ospray {
+  namespace mpi {
+
+    RemoteDevice::~RemoteDevice()
+    {
+      if (writeStream) {
+        // tell the server this client is done; it may be gone already
+        try {
+          work::CommandFinalize work;
+          processWork(work, true);
+        } catch (const std::exception &) {
+        }
+      }
+
+      readStream.reset();
+      writeStream.reset();
+    }
+
+    void RemoteDevice::commit()
+    {
+      Device::commit();
+
+      if (!initialized)
+        connect();
+    }
+
+    void RemoteDevice::connect()
+    {
+      const auto host = getParam<std::string>("host", "localhost");
+      const int  port = getParam<int>("port", REMOTE_DEFAULT_PORT);
+      const float timeout = getParam<float>("connectTimeout", 5.f);
+
+      postStatusMsg(OSPRAY_MPI_VERBOSE_LEVEL)
+          << "#osp:remote: connecting to render server at "
+          << host << ":" << port;
+
+      socket_t socket = nullptr;
+      const double startTime = getSysTime();
+      while (!socket) {
+        try {
+          socket = ospcommon::connect(host.c_str(), port);
+        } catch (const std::runtime_error &) {
+          if (getSysTime() - startTime > timeout) {
+            throw std::runtime_error("#osp:remote: could not connect to "
+                                     "render server at " + host + ":"
+                                     + std::to_string(port));
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+      }
+
+      socketFabric = make_unique<networking::SocketFabric>(socket);
+      readStream   = make_unique<networking::BufferedReadStream>(*socketFabric);
+      writeStream  = make_unique<networking::BufferedWriteStream>(*socketFabric);
+
+      initialized = true;
+    }
+
+    OSPFrameBuffer
+    RemoteDevice::frameBufferCreate(const vec2i &size,
+                                    const OSPFrameBufferFormat mode,
+                                    const uint32 channels)
+    {
+      ObjectHandle handle = allocateHandle();
+      work::CreateFrameBuffer work(handle, size, mode, channels);
+      processWork(work);
+
+      // the server starts out from a zeroed copy, too
+      auto &copy = frameBuffers[handle.i64];
+      copy.size      = size;
+      copy.pixelSize = bytesPerPixel(mode);
+      const size_t numPixels = size.x * size_t(size.y);
+      copy.color.assign(numPixels * copy.pixelSize / sizeof(uint32), 0);
+      if (channels & OSP_FB_DEPTH)
+        copy.depth.assign(numPixels, 0.f);
+
+      return (OSPFrameBuffer)(int64)handle;
+    }
+
+    const void *RemoteDevice::frameBufferMap(OSPFrameBuffer _fb,
+                                             OSPFrameBufferChannel channel)
+    {
+      const ObjectHandle handle = (const ObjectHandle &)_fb;
+      auto found = frameBuffers.find(handle.i64);
+      if (found == frameBuffers.end())
+        throw std::runtime_error("#osp:remote: unknown frame buffer");
+
+      auto &copy = found->second;
+
+      switch (channel) {
+      case OSP_FB_COLOR: return copy.color.empty() ? nullptr : copy.color.data();
+      case OSP_FB_DEPTH: return copy.depth.empty() ? nullptr : copy.depth.data();
+      default: return nullptr;
+      }
+    }
+
+    void RemoteDevice::frameBufferUnmap(const void *mapped, OSPFrameBuffer _fb)
+    {
+      // the local copy stays around until the frame buffer is released
+      UNUSED(mapped, _fb);
+    }
+
+    int RemoteDevice::setRegion(OSPVolume _volume, const void *source,
+                                const vec3i &index, const vec3i &count)
+    {
+      const ObjectHandle handle = (const ObjectHandle &)_volume;
+      auto found = voxelTypes.find(handle.i64);
+      if (found == voxelTypes.end()) {
+        throw std::runtime_error("#osp:remote: the 'voxelType' of a volume "
+                                 "has to be set before calling setRegion()");
+      }
+
+      work::SetRegion work(_volume, index, count, source, found->second);
+      processWork(work);
+      return true;
+    }
+
+    void RemoteDevice::setString(OSPObject _object,
+                                 const char *bufName,
+                                 const char *s)
+    {
+      if (std::string(bufName) == "voxelType")
+        voxelTypes[((const ObjectHandle &)_object).i64] = typeForString(s);
+
+      MPIOffloadDevice::setString(_object, bufName, s);
+    }
+
+    float RemoteDevice::renderFrame(OSPFrameBuffer _fb,
+                                    OSPRenderer _renderer,
+                                    const uint32 fbChannelFlags)
+    {
+      const ObjectHandle handle = (const ObjectHandle &)_fb;
+      auto found = frameBuffers.find(handle.i64);
+      if (found == frameBuffers.end())
+        throw std::runtime_error("#osp:remote: unknown frame buffer");
+
+      auto &copy = found->second;
+
+      work::RenderFrame work(_fb, _renderer, fbChannelFlags);
+      processWork(work, true);
+
+      float variance = 0.f;
+      *readStream >> variance;
+
+      if (copy.pixelSize > 0) {
+        decodeFrameDelta(*readStream, copy.color.data(),
+                         copy.size, copy.pixelSize);
+      }
+      if (!copy.depth.empty()) {
+        decodeFrameDelta(*readStream, copy.depth.data(),
+                         copy.size, sizeof(float));
+      }
+
+      return variance;
+    }
+
+    int RemoteDevice::loadModule(const char *name)
+    {
+      work::LoadModule work(name);
+      processWork(work, true);
+      *readStream >> work.errorCode;
+      return work.errorCode;
+    }
+
+    void RemoteDevice::release(OSPObject _obj)
+    {
+      const ObjectHandle handle = (const ObjectHandle &)_obj;
+      frameBuffers.erase(handle.i64);
+      voxelTypes.erase(handle.i64);
+
+      MPIOffloadDevice::release(_obj);
+    }
+
+    OSPPickResult RemoteDevice::pick(OSPRenderer renderer,
+                                     const vec2f &screenPos)
+    {
+      work::Pick work(renderer, screenPos);
+      processWork(work, true);
+      *readStream >> work.pickResult;
+      return work.pickResult;
+    }
+
+    void RemoteDevice::processWork(work::Work &work, bool flushWriteStream)
+    {
+      if (!writeStream)
+        throw std::runtime_error("#osp:remote: device was not committed");
+
+      auto tag = typeIdOf(work);
+      writeStream->write(&tag, sizeof(tag));
+      work.serialize(*writeStream);
+
+      if (flushWriteStream)
+        writeStream->flush();
+    }
+
+    OSP_REGISTER_DEVICE(RemoteDevice, remote);
+
+  } // ::ospray::mpi
+} // ::ospray
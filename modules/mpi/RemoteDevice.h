@@ -0,0 +1,133 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#pragma once
+
+#include "MPIOffloadDevice.h"
+#include "common/FrameDelta.h"
+// ospcommon
+#include "ospcommon/networking/SocketFabric.h"
+// stl
+#include <map>
+
+/*! \file RemoteDevice.h Implements the "remote" device, which drives a
+    render server (see 'runRemoteWorker()') over a TCP connection */
+
+namespace ospray {
+  namespace mpi {
+
+    /*! default port of the remote render server */
+    static const unsigned short REMOTE_DEFAULT_PORT = 3142;
+
+    /*! interface the render server listens on by default; only local
+        clients can connect unless it is explicitly told otherwise */
+    static const char *const REMOTE_DEFAULT_HOST = "127.0.0.1";
+
+    /*! \brief a device that sends all API calls to a remote render
+        server, and streams frame buffers back
+
+      API calls get encoded as the same work items the MPI offload
+      device uses, but are sent over a plain TCP socket, so neither
+      side needs an MPI runtime. After each rendered frame, the server
+      sends back only the tiles that changed since the previous frame
+      (see FrameDelta.h), which the device applies to its local copy of
+      the frame buffer.
+
+      Parameters:
+      <dl>
+      <dt><code>string host = "localhost"</code></dt><dd>Host the render server runs on</dd>
+      <dt><code>int    port = 3142</code></dt><dd>Port the render server listens on</dd>
+      <dt><code>float  connectTimeout = 5</code></dt><dd>Seconds to keep retrying to connect</dd>
+      </dl>
+    */
+    struct RemoteDevice : public MPIOffloadDevice
+    {
+      RemoteDevice() = default;
+      ~RemoteDevice() override;
+
+      // ManagedObject Implementation /////////////////////////////////////////
+
+      void commit() override;
+
+      // Device Implementation ////////////////////////////////////////////////
+
+      OSPFrameBuffer
+      frameBufferCreate(const vec2i &size,
+                        const OSPFrameBufferFormat mode,
+                        const uint32 channels) override;
+
+      const void *frameBufferMap(OSPFrameBuffer fb,
+                                 OSPFrameBufferChannel channel) override;
+
+      void frameBufferUnmap(const void *mapped, OSPFrameBuffer fb) override;
+
+      int setRegion(OSPVolume object, const void *source,
+                    const vec3i &index, const vec3i &count) override;
+
+      void setString(OSPObject object,
+                     const char *bufName,
+                     const char *s) override;
+
+      float renderFrame(OSPFrameBuffer _sc,
+                        OSPRenderer _renderer,
+                        const uint32 fbChannelFlags) override;
+
+      int loadModule(const char *name) override;
+
+      void release(OSPObject _obj) override;
+
+      OSPPickResult pick(OSPRenderer renderer,
+                         const vec2f &screenPos) override;
+
+    private:
+
+      void connect();
+
+      /*! send the work item to the server; nothing is run locally */
+      void processWork(work::Work &work,
+                       bool flushWriteStream = false) override;
+
+      /*! the client side copy of a frame buffer */
+      struct FrameBufferCopy
+      {
+        vec2i size;
+        size_t pixelSize;
+        std::vector<uint32> color;
+        std::vector<float>  depth;
+      };
+
+      std::map<int64, FrameBufferCopy> frameBuffers;
+
+      /*! voxel types of volumes, as needed to encode 'setRegion()' */
+      std::map<int64, OSPDataType> voxelTypes;
+
+      std::unique_ptr<networking::Fabric> socketFabric;
+    };
+
+    /*! run a remote render server on the calling thread: accept
+        connections from remote devices on 'port' of the interface
+        'host' (loopback by default), and execute the work items they
+        send on the current (local) device. serves one client at a
+        time; returns once a client disconnected if 'serveOnce' is set,
+        and never returns otherwise */
+    OSPRAY_DLLEXPORT void runRemoteWorker(unsigned short port,
+                                          bool serveOnce = false,
+                                          const std::string &host
+                                            = REMOTE_DEFAULT_HOST);
+
+  } // ::ospray::mpi
+} // ::ospray
@@ -0,0 +1,280 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "mpi/RemoteDevice.h"
+#include "common/OSPWork.h"
+#include "fb/LocalFB.h"
+#include "render/Renderer.h"
+// ospcommon
+#include "ospcommon/networking/BufferedDataStreaming.h"
+// std
+#include <set>
+
+namespace ospray {
+  namespace mpi {
+
+    // defined in MPIOffloadWorker.cpp
+    std::unique_ptr<work::Work> readWork(work::WorkTypeRegistry &registry,
+                                         networking::ReadStream &readStream);
+
+    /*! one connection to a remote device; executes the work items it
+        sends on the current device, and answers the ones the device
+        waits for a reply to */
+    struct RemoteSession
+    {
+      RemoteSession(socket_t socket)
+        : fabric(socket), readStream(fabric), writeStream(fabric)
+      {
+        work::registerOSPWorkItems(registry);
+      }
+
+      /*! releases the objects the client did not release itself */
+      ~RemoteSession();
+
+      /*! process work items until the client finalizes or disconnects */
+      void run();
+
+    private:
+
+      void trackCreatedObject(const work::Work &work);
+      void createFrameBuffer(work::CreateFrameBuffer &work);
+      void renderFrame(work::RenderFrame &work);
+      void pick(work::Pick &work);
+      void loadModule(work::LoadModule &work);
+
+      /*! per frame buffer, the state the client has seen so far */
+      struct FrameBufferEncoders
+      {
+        bool hasColor {false};
+        bool hasDepth {false};
+        FrameDeltaEncoder color;
+        FrameDeltaEncoder depth;
+      };
+
+      networking::SocketFabric         fabric;
+      networking::BufferedReadStream   readStream;
+      networking::BufferedWriteStream  writeStream;
+      work::WorkTypeRegistry           registry;
+      std::map<int64, FrameBufferEncoders> frameBuffers;
+      /*! handles of the objects created by the client */
+      std::set<int64> handles;
+    };
+
+    namespace {
+
+      template <typename T>
+      bool createdHandle(const work::Work &work, int64 &handle)
+      {
+        auto *create = dynamic_cast<const T*>(&work);
+        if (create)
+          handle = create->handle.i64;
+        return create != nullptr;
+      }
+
+    } // ::ospray::mpi::<anonymous>
+
+    RemoteSession::~RemoteSession()
+    {
+      // the objects must not outlive the connection, also since the next
+      // client starts numbering its handles from scratch
+      for (const int64 handle : handles) {
+        const ObjectHandle object(handle);
+        if (object.defined())
+          object.freeObject();
+      }
+    }
+
+    void RemoteSession::trackCreatedObject(const work::Work &work)
+    {
+      int64 handle = 0;
+      if (createdHandle<work::NewModel>(work, handle) ||
+          createdHandle<work::NewPixelOp>(work, handle) ||
+          createdHandle<work::NewRenderer>(work, handle) ||
+          createdHandle<work::NewCamera>(work, handle) ||
+          createdHandle<work::NewVolume>(work, handle) ||
+          createdHandle<work::NewGeometry>(work, handle) ||
+          createdHandle<work::NewTransferFunction>(work, handle) ||
+          createdHandle<work::NewMaterial>(work, handle) ||
+          createdHandle<work::NewMaterial2>(work, handle) ||
+          createdHandle<work::NewLight>(work, handle) ||
+          createdHandle<work::NewLight2>(work, handle) ||
+          createdHandle<work::NewData>(work, handle) ||
+          createdHandle<work::NewTexture2d>(work, handle)) {
+        handles.insert(handle);
+      }
+    }
+
+    void RemoteSession::run()
+    {
+      while (true) {
+        auto work = readWork(registry, readStream);
+        const auto tag = typeIdOf(work);
+
+        if (tag == typeIdOf<work::CommandFinalize>())
+          return;
+
+        // work items the client waits for an answer to have to send one
+        // even if they fail, everything else just reports the error
+        try {
+          if (tag == typeIdOf<work::CreateFrameBuffer>()) {
+            createFrameBuffer(dynamic_cast<work::CreateFrameBuffer&>(*work));
+          } else if (tag == typeIdOf<work::RenderFrame>()) {
+            renderFrame(dynamic_cast<work::RenderFrame&>(*work));
+          } else if (tag == typeIdOf<work::Pick>()) {
+            pick(dynamic_cast<work::Pick&>(*work));
+          } else if (tag == typeIdOf<work::LoadModule>()) {
+            loadModule(dynamic_cast<work::LoadModule&>(*work));
+          } else if (tag == typeIdOf<work::CommandRelease>()) {
+            auto &release = dynamic_cast<work::CommandRelease&>(*work);
+            frameBuffers.erase(release.handle.i64);
+            handles.erase(release.handle.i64);
+            release.run();
+          } else if (tag != typeIdOf<work::SetLoadBalancer>()) {
+            // (load balancing is left to the local device)
+            work->run();
+            trackCreatedObject(*work);
+          }
+        } catch (const ospcommon::Disconnect &) {
+          throw;
+        } catch (const std::exception &e) {
+          postStatusMsg() << "#osp:remote: error executing "
+                          << typeString(work) << ": " << e.what();
+        }
+      }
+    }
+
+    void RemoteSession::createFrameBuffer(work::CreateFrameBuffer &work)
+    {
+      const bool hasDepthBuffer    = work.channels & OSP_FB_DEPTH;
+      const bool hasAccumBuffer    = work.channels & OSP_FB_ACCUM;
+      const bool hasVarianceBuffer = work.channels & OSP_FB_VARIANCE;
+
+      auto &encoders = frameBuffers[work.handle.i64];
+      const size_t pixelSize = bytesPerPixel(work.format);
+      encoders.hasColor = pixelSize > 0;
+      encoders.hasDepth = hasDepthBuffer;
+      if (encoders.hasColor)
+        encoders.color = FrameDeltaEncoder(work.dimensions, pixelSize);
+      if (encoders.hasDepth)
+        encoders.depth = FrameDeltaEncoder(work.dimensions, sizeof(float));
+
+      FrameBuffer *fb = new LocalFrameBuffer(work.dimensions, work.format,
+                                             hasDepthBuffer, hasAccumBuffer,
+                                             hasVarianceBuffer);
+      work.handle.assign(fb);
+      handles.insert(work.handle.i64);
+    }
+
+    void RemoteSession::renderFrame(work::RenderFrame &work)
+    {
+      float variance = inf;
+      try {
+        work.run();
+        variance = work.varianceResult;
+      } catch (const std::exception &e) {
+        postStatusMsg() << "#osp:remote: error rendering frame: " << e.what();
+      }
+
+      writeStream << variance;
+
+      // the client expects an update for each channel it knows of; if
+      // the frame buffer is gone, neither side has a copy of it anymore
+      auto found = frameBuffers.find(work.fbHandle.i64);
+      FrameBuffer *fb = work.fbHandle.defined()
+                        ? (FrameBuffer*)work.fbHandle.lookup() : nullptr;
+      if (found != frameBuffers.end() && fb) {
+        auto &encoders = found->second;
+        if (encoders.hasColor) {
+          const void *color = fb->mapColorBuffer();
+          encoders.color.encode(writeStream, color);
+          fb->unmap(color);
+        }
+        if (encoders.hasDepth) {
+          const void *depth = fb->mapDepthBuffer();
+          encoders.depth.encode(writeStream, depth);
+          fb->unmap(depth);
+        }
+      }
+
+      writeStream.flush();
+    }
+
+    void RemoteSession::pick(work::Pick &work)
+    {
+      work.pickResult = OSPPickResult();
+
+      try {
+        Renderer *renderer = (Renderer*)work.rendererHandle.lookup();
+        if (renderer)
+          work.pickResult = renderer->pick(work.screenPos);
+      } catch (const std::exception &e) {
+        postStatusMsg() << "#osp:remote: error picking: " << e.what();
+      }
+
+      writeStream << work.pickResult;
+      writeStream.flush();
+    }
+
+    void RemoteSession::loadModule(work::LoadModule &work)
+    {
+      // clients may only name modules, not arbitrary libraries to load
+      if (work.name.empty()
+          || work.name.find_first_of("/\\:") != std::string::npos) {
+        postStatusMsg() << "#osp:remote: refusing to load module '"
+                        << work.name << "'";
+        work.errorCode = OSP_INVALID_ARGUMENT;
+      } else {
+        try {
+          work.run();
+        } catch (const std::exception &e) {
+          postStatusMsg() << "#osp:remote: error loading module '"
+                          << work.name << "': " << e.what();
+          work.errorCode = OSP_INVALID_OPERATION;
+        }
+      }
+
+      writeStream << work.errorCode;
+      writeStream.flush();
+    }
+
+    void runRemoteWorker(unsigned short port, bool serveOnce,
+                         const std::string &host)
+    {
+      socket_t listenSocket = ospcommon::bind(host.c_str(), port);
+      postStatusMsg(OSPRAY_MPI_VERBOSE_LEVEL)
+          << "#osp:remote: render server listening on "
+          << host << ":" << port;
+
+      do {
+        RemoteSession session(ospcommon::listen(listenSocket));
+        postStatusMsg(OSPRAY_MPI_VERBOSE_LEVEL)
+            << "#osp:remote: client connected";
+
+        try {
+          session.run();
+        } catch (const ospcommon::Disconnect &) {
+          postStatusMsg() << "#osp:remote: client disconnected unexpectedly";
+        } catch (const std::exception &e) {
+          // the stream is out of sync, nothing to do but to drop the client
+          postStatusMsg() << "#osp:remote: dropping client: " << e.what();
+        }
+      } while (!serveOnce);
+
+      ospcommon::close(listenSocket);
+    }
+
+  } // ::ospray::mpi
+} // ::ospray
@@ -0,0 +1,190 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+/*! \file ospRemoteLoopbackTest.cpp runs a render server in a child
+    process, renders a small scene through a "remote" device connected
+    to it over the loopback interface, and checks that the frames that
+    get streamed back match the ones of a local device */
+
+#include "ospray/ospray.h"
+#include "mpi/RemoteDevice.h"
+// std
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+// posix
+#include <sys/wait.h>
+#include <unistd.h>
+
+static const unsigned short port = ospray::mpi::REMOTE_DEFAULT_PORT + 1;
+static const int width  = 64;
+static const int height = 48;
+
+static int runServer(int ac, const char *av[])
+{
+  ospInit(&ac, av);
+  ospray::mpi::runRemoteWorker(port, true);
+  return 0;
+}
+
+static OSPRenderer createScene(OSPCamera camera)
+{
+  float vertex[] = { -1.f, -1.f, 0.f,
+                      1.f, -1.f, 0.f,
+                      0.f,  1.f, 0.f };
+  int   index[]  = { 0, 1, 2 };
+
+  OSPGeometry mesh = ospNewGeometry("triangles");
+  OSPData data = ospNewData(3, OSP_FLOAT3, vertex);
+  ospSetData(mesh, "vertex", data);
+  ospRelease(data);
+  data = ospNewData(1, OSP_INT3, index);
+  ospSetData(mesh, "index", data);
+  ospRelease(data);
+  ospCommit(mesh);
+
+  OSPModel model = ospNewModel();
+  ospAddGeometry(model, mesh);
+  ospCommit(model);
+  ospRelease(mesh);
+
+  OSPRenderer renderer = ospNewRenderer("scivis");
+  ospSetObject(renderer, "model",  model);
+  ospSetObject(renderer, "camera", camera);
+  ospSet3f(renderer, "bgColor", 0.f, 0.f, 0.f);
+  ospCommit(renderer);
+  ospRelease(model);
+
+  return renderer;
+}
+
+static void setCamera(OSPCamera camera, float x)
+{
+  ospSetf(camera, "aspect", width / float(height));
+  ospSet3f(camera, "pos", x, 0.f, 3.f);
+  ospSet3f(camera, "dir", 0.f, 0.f, -1.f);
+  ospSet3f(camera, "up",  0.f, 1.f, 0.f);
+  ospCommit(camera);
+}
+
+struct Frame
+{
+  std::vector<uint32_t> color;
+  std::vector<float>    depth;
+};
+
+/*! renders the scene on the current device, with accumulated frames
+    (which only transfer what changed) and a camera moved in between,
+    and returns the frame buffer contents after each frame */
+static std::vector<Frame> renderFrames()
+{
+  OSPCamera camera = ospNewCamera("perspective");
+  setCamera(camera, 0.f);
+  OSPRenderer renderer = createScene(camera);
+
+  const uint32_t channels = OSP_FB_COLOR | OSP_FB_DEPTH | OSP_FB_ACCUM;
+  OSPFrameBuffer fb = ospNewFrameBuffer(osp::vec2i{width, height},
+                                        OSP_FB_SRGBA, channels);
+
+  std::vector<Frame> frames;
+  float cameraX = 0.f;
+  for (float x : {0.f, 0.f, 0.5f, 0.5f, -0.25f}) {
+    if (x != cameraX) {
+      cameraX = x;
+      setCamera(camera, x);
+      ospFrameBufferClear(fb, OSP_FB_ACCUM);
+    }
+    ospRenderFrame(fb, renderer, channels);
+
+    const auto *color = (const uint32_t *)ospMapFrameBuffer(fb, OSP_FB_COLOR);
+    const auto *depth = (const float *)ospMapFrameBuffer(fb, OSP_FB_DEPTH);
+    frames.push_back({std::vector<uint32_t>(color, color + width * height),
+                      std::vector<float>(depth, depth + width * height)});
+    ospUnmapFrameBuffer(depth, fb);
+    ospUnmapFrameBuffer(color, fb);
+  }
+
+  ospRelease(fb);
+  ospRelease(renderer);
+  ospRelease(camera);
+  return frames;
+}
+
+static bool showsScene(const Frame &frame)
+{
+  const int center = height / 2 * width + width / 2;
+  return frame.color[center] != frame.color[0]
+         && std::isfinite(frame.depth[center])
+         && !std::isfinite(frame.depth[0]);
+}
+
+static int runClient()
+{
+  OSPDevice device = ospNewDevice("remote");
+  ospDeviceSet1i(device, "port", port);
+  ospDeviceCommit(device);
+  ospSetCurrentDevice(device);
+
+  const std::vector<Frame> remote = renderFrames();
+
+  // switching devices destroys the remote one, which ends the session
+  OSPDevice local = ospNewDevice("default");
+  ospDeviceCommit(local);
+  ospSetCurrentDevice(local);
+
+  // the server renders the same way as the local device, thus the
+  // streamed frames have to match the local ones exactly
+  const std::vector<Frame> reference = renderFrames();
+
+  if (!showsScene(remote[0])) {
+    std::cerr << "remote frame does not show the scene" << std::endl;
+    return 1;
+  }
+  for (size_t i = 0; i < remote.size(); i++) {
+    if (remote[i].color != reference[i].color
+        || memcmp(remote[i].depth.data(), reference[i].depth.data(),
+                  remote[i].depth.size() * sizeof(float)) != 0) {
+      std::cerr << "remote frame " << i << " differs from the local one"
+                << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int ac, const char *av[])
+{
+  const pid_t server = fork();
+  if (server < 0) {
+    std::cerr << "could not start the render server" << std::endl;
+    return 1;
+  }
+  if (server == 0)
+    return runServer(ac, av);
+
+  const int result = runClient();
+
+  int status = 0;
+  waitpid(server, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::cerr << "render server did not shut down cleanly" << std::endl;
+    return 1;
+  }
+
+  return result;
+}
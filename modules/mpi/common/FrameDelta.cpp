@@ -0,0 +1,182 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "FrameDelta.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+// stl
+#include <cstring>
+
+namespace ospray {
+  namespace mpi {
+
+    // The update of a frame consists of the number of changed tiles,
+    // followed by the index and the encoded size (in words) of each
+    // changed tile, and its encoded words. A tile is encoded as the XOR
+    // of its (32-bit) words with their previous contents, row by row;
+    // the XOR is a sequence of runs, each consisting of a header word
+    // (number of zero words << 16 | number of literal words) and the
+    // literal words.
+
+    static const uint32 MAX_RUN = 0xffff;
+
+    size_t bytesPerPixel(OSPFrameBufferFormat format)
+    {
+      switch (format) {
+      case OSP_FB_NONE:    return 0;
+      case OSP_FB_RGBA8:
+      case OSP_FB_SRGBA:   return sizeof(uint32);
+      case OSP_FB_RGBA32F: return sizeof(vec4f);
+      default:
+        throw std::runtime_error("#osp:remote: unknown frame buffer format");
+      }
+    }
+
+    FrameDeltaEncoder::FrameDeltaEncoder(const vec2i &size, size_t pixelSize)
+      : size(size),
+        wordsPerPixel(pixelSize / sizeof(uint32)),
+        numTiles(divRoundUp(size, vec2i(TILE_SIZE))),
+        previous(size.x * size_t(size.y) * wordsPerPixel, 0),
+        encodedTile(numTiles.x * size_t(numTiles.y))
+    {
+    }
+
+    void FrameDeltaEncoder::encode(WriteStream &out, const void *pixels)
+    {
+      const uint32 *current = (const uint32 *)pixels;
+      const size_t rowWords = size.x * wordsPerPixel;
+
+      tasking::parallel_for(encodedTile.size(), [&](size_t tileID) {
+        auto &encoded = encodedTile[tileID];
+        encoded.clear();
+
+        const vec2i tile(tileID % numTiles.x, tileID / numTiles.x);
+        const vec2i begin = tile * TILE_SIZE;
+        const vec2i end   = min(begin + vec2i(TILE_SIZE), size);
+        const size_t tileRowWords = (end.x - begin.x) * wordsPerPixel;
+
+        bool changed = false;
+        for (int y = begin.y; y < end.y && !changed; y++) {
+          const size_t ofs = y * rowWords + begin.x * wordsPerPixel;
+          changed = memcmp(current + ofs, previous.data() + ofs,
+                           tileRowWords * sizeof(uint32)) != 0;
+        }
+
+        if (!changed)
+          return;
+
+        uint32 zeros = 0;
+        size_t header = 0;
+        bool   inLiterals = false;
+
+        for (int y = begin.y; y < end.y; y++) {
+          const size_t ofs = y * rowWords + begin.x * wordsPerPixel;
+          for (size_t i = 0; i < tileRowWords; i++) {
+            const uint32 x = current[ofs + i] ^ previous[ofs + i];
+            previous[ofs + i] = current[ofs + i];
+
+            if (x == 0) {
+              if (inLiterals || zeros == MAX_RUN) {
+                if (!inLiterals)
+                  encoded.push_back(zeros << 16);
+                inLiterals = false;
+                zeros = 0;
+              }
+              zeros++;
+            } else {
+              if (!inLiterals || (encoded[header] & MAX_RUN) == MAX_RUN) {
+                header = encoded.size();
+                encoded.push_back(zeros << 16);
+                inLiterals = true;
+                zeros = 0;
+              }
+              encoded[header]++;
+              encoded.push_back(x);
+            }
+          }
+        }
+
+        if (!inLiterals && zeros > 0)
+          encoded.push_back(zeros << 16);
+      });
+
+      numTilesSent = 0;
+      for (const auto &encoded : encodedTile)
+        numTilesSent += !encoded.empty();
+
+      out << uint32(numTilesSent);
+      for (size_t tileID = 0; tileID < encodedTile.size(); tileID++) {
+        const auto &encoded = encodedTile[tileID];
+        if (encoded.empty())
+          continue;
+        out << uint32(tileID) << uint32(encoded.size());
+        out.write(encoded.data(), encoded.size() * sizeof(uint32));
+      }
+    }
+
+    void decodeFrameDelta(ReadStream &in, void *pixels,
+                          const vec2i &size, size_t pixelSize)
+    {
+      uint32 *current = (uint32 *)pixels;
+      const size_t wordsPerPixel = pixelSize / sizeof(uint32);
+      const size_t rowWords = size.x * wordsPerPixel;
+      const vec2i numTiles = divRoundUp(size, vec2i(TILE_SIZE));
+
+      uint32 numChanged = 0;
+      in >> numChanged;
+
+      std::vector<uint32> encoded;
+      for (uint32 t = 0; t < numChanged; t++) {
+        uint32 tileID = 0, numWords = 0;
+        in >> tileID >> numWords;
+        if (tileID >= numTiles.x * size_t(numTiles.y))
+          throw std::runtime_error("#osp:remote: frame update with invalid tile");
+
+        const vec2i tile(tileID % numTiles.x, tileID / numTiles.x);
+        const vec2i begin = tile * TILE_SIZE;
+        const vec2i end   = min(begin + vec2i(TILE_SIZE), size);
+        const size_t tileRowWords = (end.x - begin.x) * wordsPerPixel;
+        const size_t tileWords    = (end.y - begin.y) * tileRowWords;
+
+        // at worst, every literal word comes with its own header
+        if (numWords > 2 * tileWords)
+          throw std::runtime_error("#osp:remote: frame update exceeds tile");
+        encoded.resize(numWords);
+        in.read(encoded.data(), numWords * sizeof(uint32));
+
+        // position within the tile, as flat word index
+        size_t pos = 0;
+        auto xorWord = [&](uint32 x) {
+          const size_t y = pos / tileRowWords;
+          const size_t i = pos - y * tileRowWords;
+          current[(begin.y + y) * rowWords + begin.x * wordsPerPixel + i] ^= x;
+        };
+
+        for (size_t w = 0; w < encoded.size();) {
+          const uint32 run = encoded[w++];
+          pos += run >> 16;
+          const uint32 numLiterals = run & MAX_RUN;
+          if (numLiterals > encoded.size() - w || pos + numLiterals > tileWords)
+            throw std::runtime_error("#osp:remote: frame update exceeds tile");
+          for (uint32 l = 0; l < numLiterals; l++, pos++)
+            xorWord(encoded[w++]);
+        }
+      }
+    }
+
+  } // ::ospray::mpi
+} // ::ospray
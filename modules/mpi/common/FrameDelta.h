@@ -0,0 +1,68 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+/*! \file FrameDelta.h compressed frame buffer updates for the remote
+    device: only tiles that changed since the previous update get sent,
+    each as run-length encoded XOR against its previous contents */
+
+#pragma once
+
+#include "common/OSPCommon.h"
+#include "ospcommon/networking/DataStreaming.h"
+// stl
+#include <vector>
+
+namespace ospray {
+  namespace mpi {
+
+    using namespace ospcommon::networking;
+
+    /*! number of bytes per pixel of a color buffer of the given format */
+    size_t bytesPerPixel(OSPFrameBufferFormat format);
+
+    /*! keeps the state of a frame buffer channel the other side has
+        seen so far, and encodes updates of it */
+    struct FrameDeltaEncoder
+    {
+      FrameDeltaEncoder() = default;
+      FrameDeltaEncoder(const vec2i &size, size_t pixelSize);
+
+      /*! write the changes between the last state sent and 'pixels'
+          (of the size and pixel size given on construction) to
+          'out'; afterwards, 'pixels' is the last state sent */
+      void encode(WriteStream &out, const void *pixels);
+
+      /*! number of tiles that were sent by the last 'encode()' */
+      size_t numTilesSent {0};
+
+    private:
+
+      vec2i  size {0};
+      size_t wordsPerPixel {0};
+      vec2i  numTiles {0};
+      std::vector<uint32> previous;
+      /*! per tile, the encoded changes (empty if unchanged) */
+      std::vector<std::vector<uint32>> encodedTile;
+    };
+
+    /*! apply an update written by 'FrameDeltaEncoder::encode()' to
+        'pixels', which has to hold the state the encoder had before */
+    void decodeFrameDelta(ReadStream &in, void *pixels,
+                          const vec2i &size, size_t pixelSize);
+
+  } // ::ospray::mpi
+} // ::ospray
@@ -138,7 +138,7 @@ namespace ospray {
         msgSize += sizeof(float) * TILE_SIZE * TILE_SIZE;
         command = command | MASTER_TILE_HAS_DEPTH;
       }
-      message = std::make_shared<mpicommon::Message>(msgSize);
+      message = maml::newMessage(msgSize);
       header = reinterpret_cast<MasterTileMessage_NONE*>(message->data);
       header->command = command;
       header->coords = coords;
@@ -583,8 +583,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
 
   void DFB::sendAllTilesDoneMessage()
   {
-      auto msg = std::make_shared<mpicommon::Message>
-              (AllTilesDoneMessage::size(tileErrors.size()));
+      auto msg = maml::newMessage(AllTilesDoneMessage::size(tileErrors.size()));
 
       auto out = msg->data;
       int val = WORKER_ALL_TILES_DONE;
@@ -638,8 +637,8 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
       memcpy(&msgPayload.tile, &tile, sizeof(ospray::Tile));
       msgPayload.command = WORKER_WRITE_TILE;
 
-      auto msg = std::make_shared<mpicommon::Message>(&msgPayload,
-                                                      sizeof(msgPayload));
+      auto msg = maml::newMessage(sizeof(msgPayload));
+      memcpy(msg->data, &msgPayload, sizeof(msgPayload));
 
       int dstRank = tileDesc->ownerID;
       DBG(printf("rank %i: send tile %i,%i to %i\n",mpicommon::globalRank(),
@@ -723,6 +722,7 @@ void DFB::processMessage(AllTilesDoneMessage *msg, ospcommon::byte_t* data)
   {
     mpi::messaging::disableAsyncMessaging();
     memset(tileInstances, 0, sizeof(int32)*getTotalTiles()); // XXX needed?
+    frameArena.reset();
     if (mpicommon::IamTheMaster()) // only refine on master
       return tileErrorRegion.refine(errorThreshold);
     else // slaves will get updated error with next sync() anyway
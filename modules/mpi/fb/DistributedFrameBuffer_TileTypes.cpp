@@ -76,7 +76,9 @@ namespace ospray {
     written into / composited into this dfb tile */
   void AlphaBlendTile_simple::process(const ospray::Tile &tile)
   {
-    BufferedTile *addTile = new BufferedTile;
+    // (default-initialized, as it gets overwritten right away)
+    BufferedTile *addTile =
+      new (dfb->frameArena.allocate(sizeof(BufferedTile))) BufferedTile;
     memcpy(&addTile->tile,&tile,sizeof(tile));
     computeSortOrder(addTile);
 
@@ -119,10 +121,12 @@ namespace ospray {
         this->final.fbSize = tile.fbSize;
         this->final.rcp_fbSize = tile.rcp_fbSize;
         accumulate(bufferedTile[0]->tile);
-        dfb->tileIsCompleted(this);
+        // release the fragments before the frame can end, which resets
+        // the frame arena
         for (auto &tile : bufferedTile)
-          delete tile;
+          dfb->frameArena.destroy(tile);
         bufferedTile.clear();
+        dfb->tileIsCompleted(this);
       }
     }
   }
@@ -0,0 +1,50 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "ospray/ospray.h"
+#include "mpi/RemoteDevice.h"
+// std
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+/*! render server for the "remote" device: executes the API calls of
+    remote devices connecting to it on the local (default) device */
+int main(int ac, const char *av[])
+{
+  ospInit(&ac, av);
+
+  unsigned short port = ospray::mpi::REMOTE_DEFAULT_PORT;
+  // only accept local clients unless told to listen on another interface
+  std::string host = ospray::mpi::REMOTE_DEFAULT_HOST;
+  for (int i = 1; i < ac; i++) {
+    if (!strcmp(av[i], "--port") && i + 1 < ac) {
+      port = (unsigned short)atoi(av[++i]);
+    } else if (!strcmp(av[i], "--host") && i + 1 < ac) {
+      host = av[++i];
+    } else {
+      std::cerr << "usage: " << av[0] << " [--port <port>]"
+                << " [--host <interface address, 0.0.0.0 for all>]"
+                << std::endl;
+      return 1;
+    }
+  }
+
+  ospray::mpi::runRemoteWorker(port, false, host);
+
+  return 0;
+}
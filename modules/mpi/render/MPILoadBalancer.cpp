@@ -93,19 +93,28 @@ namespace ospray {
           if (fb->tileError(tileId) <= renderer->errorThreshold)
             return;
 
+          const int32 pixelsPerSample =
+              renderer->pixelsPerSample(fb, tileId, accumID);
+
 #if TILE_SIZE > MAX_TILE_SIZE
-          auto tilePtr = make_unique<Tile>(tileId, fb->size, accumID);
-          auto &tile   = *tilePtr;
+          auto *tilePtr = fb->frameArena.create<Tile>(tileId, fb->size,
+                                                      accumID,
+                                                      pixelsPerSample);
+          auto &tile    = *tilePtr;
 #else
-          Tile __aligned(64) tile(tileId, fb->size, accumID);
+          Tile __aligned(64) tile(tileId, fb->size, accumID, pixelsPerSample);
 #endif
 
-          tasking::parallel_for(numJobs(renderer->spp, accumID),
+          tasking::parallel_for(numJobs(tile),
                                 [&](size_t tid) {
             renderer->renderTile(perFrameData, tile, tid);
           });
 
           fb->setTile(tile);
+
+#if TILE_SIZE > MAX_TILE_SIZE
+          fb->frameArena.destroy(tilePtr);
+#endif
         });
 
         dfb->waitUntilFinished();
@@ -182,7 +191,8 @@ namespace ospray {
           task.tilesExhausted = false;
         }
 
-        auto answer = std::make_shared<mpicommon::Message>(&task, sizeof(task));
+        auto answer = maml::newMessage(sizeof(task));
+        memcpy(answer->data, &task, sizeof(task));
         mpi::messaging::sendTo(globalRankFromWorkerRank(worker), myId, answer);
       }
 
@@ -328,16 +338,22 @@ namespace ospray {
 
       void Slave::tileTask(const TileTask &task)
       {
+        const int32 pixelsPerSample =
+            renderer->pixelsPerSample(fb, task.tileId, task.accumId);
+
 #if TILE_SIZE > MAX_TILE_SIZE
-        auto tilePtr = make_unique<Tile>(task.tileId, fb->size, task.accumId);
-        auto &tile   = *tilePtr;
+        auto *tilePtr = fb->frameArena.create<Tile>(task.tileId, fb->size,
+                                                    task.accumId,
+                                                    pixelsPerSample);
+        auto &tile    = *tilePtr;
 #else
-        Tile __aligned(64) tile(task.tileId, fb->size, task.accumId);
+        Tile __aligned(64) tile(task.tileId, fb->size, task.accumId,
+                                pixelsPerSample);
 #endif
 
         while (!frameActive);// PRINT(frameActive); // XXX busy wait for valid perFrameData
 
-        tasking::parallel_for(numJobs(renderer->spp, task.accumId),
+        tasking::parallel_for(numJobs(tile),
                               [&](size_t tid) {
           renderer->renderTile(perFrameData, tile, tid);
         });
@@ -347,6 +363,9 @@ namespace ospray {
 
         fb->setTile(tile);
 
+#if TILE_SIZE > MAX_TILE_SIZE
+        fb->frameArena.destroy(tilePtr);
+#endif
 
         SCOPED_LOCK(mutex);
         if (--tilesScheduled == 0)
@@ -356,8 +375,8 @@ namespace ospray {
       void Slave::requestTile()
       {
         int requester = mpi::globalRank();
-        auto msg =
-            std::make_shared<mpicommon::Message>(&requester, sizeof(requester));
+        auto msg = maml::newMessage(sizeof(requester));
+        memcpy(msg->data, &requester, sizeof(requester));
         mpi::messaging::sendTo(mpi::masterRank(), myId, msg);
       }
 
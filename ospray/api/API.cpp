@@ -913,3 +913,35 @@ OSPRAY_CATCH_BEGIN
                                (const vec3f*)&worldCoordinates, count);
 }
 OSPRAY_CATCH_END()
+
+extern "C" void ospSampleVolumeSoA(OSPVolume volume,
+                                   const float *x,
+                                   const float *y,
+                                   const float *z,
+                                   size_t count,
+                                   float *results,
+                                   float *gradientX,
+                                   float *gradientY,
+                                   float *gradientZ)
+OSPRAY_CATCH_BEGIN
+{
+  ASSERT_DEVICE();
+  Assert2(volume, "nullptr volume passed to ospSampleVolumeSoA");
+
+  if (count == 0)
+    return;
+
+  Assert2(x && y && z, "nullptr coordinates passed to ospSampleVolumeSoA");
+  Assert2(results, "nullptr results passed to ospSampleVolumeSoA");
+
+  const bool anyGradient = gradientX || gradientY || gradientZ;
+  const bool allGradient = gradientX && gradientY && gradientZ;
+  if (anyGradient && !allGradient) {
+    throw std::runtime_error("#osp: ospSampleVolumeSoA needs either all "
+                             "three or none of the gradient arrays");
+  }
+
+  currentDevice().sampleVolumeSoA(volume, x, y, z, count, results,
+                                  gradientX, gradientY, gradientZ);
+}
+OSPRAY_CATCH_END()
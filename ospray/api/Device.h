@@ -219,6 +219,23 @@ namespace ospray {
         NOT_IMPLEMENTED;
       }
 
+      /*! sample the volume at SoA coordinates into caller-owned arrays;
+          the gradient arrays are either all valid or all nullptr */
+      virtual void sampleVolumeSoA(OSPVolume volume,
+                                   const float *x,
+                                   const float *y,
+                                   const float *z,
+                                   size_t count,
+                                   float *results,
+                                   float *gradientX,
+                                   float *gradientY,
+                                   float *gradientZ)
+      {
+        UNUSED(volume, x, y, z, count);
+        UNUSED(results, gradientX, gradientY, gradientZ);
+        NOT_IMPLEMENTED;
+      }
+
       virtual void commit();
       bool isCommitted();
 
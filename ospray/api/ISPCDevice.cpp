@@ -614,6 +614,24 @@ namespace ospray {
       volume->computeSamples(results, worldCoordinates, count);
     }
 
+    void ISPCDevice::sampleVolumeSoA(OSPVolume _volume,
+                                     const float *x,
+                                     const float *y,
+                                     const float *z,
+                                     size_t count,
+                                     float *results,
+                                     float *gradientX,
+                                     float *gradientY,
+                                     float *gradientZ)
+    {
+      Volume *volume = (Volume *)_volume;
+
+      Assert2(volume, "invalid volume handle");
+
+      volume->computeSamplesSoA(x, y, z, count, results,
+                                gradientX, gradientY, gradientZ);
+    }
+
     OSP_REGISTER_DEVICE(ISPCDevice, local_device);
     OSP_REGISTER_DEVICE(ISPCDevice, local);
     OSP_REGISTER_DEVICE(ISPCDevice, default_device);
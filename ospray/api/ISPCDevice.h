@@ -212,6 +212,16 @@ namespace ospray {
                         const vec3f *worldCoordinates,
                         const size_t &count) override;
 
+      void sampleVolumeSoA(OSPVolume volume,
+                           const float *x,
+                           const float *y,
+                           const float *z,
+                           size_t count,
+                           float *results,
+                           float *gradientX,
+                           float *gradientY,
+                           float *gradientZ) override;
+
       // Public Data //
 
       // NOTE(jda) - Keep embreeDevice static until runWorker() in MPI mode can
@@ -19,6 +19,7 @@
 #include "../common/OSPCommon.h"
 
 #include <map>
+#include <mutex>
 
 namespace ospray {
 
@@ -31,8 +32,13 @@ namespace ospray {
 
     // Function pointers corresponding to each subtype.
     static std::map<std::string, creationFunctionPointer> symbolRegistry;
+    // Objects may get created concurrently (e.g., by a parallel scene graph
+    // commit), guard the registry.
+    static std::mutex symbolRegistryMutex;
     const auto type_string = stringForType(OSP_TYPE);
 
+    std::unique_lock<std::mutex> lock(symbolRegistryMutex);
+
     // Find the creation function for the subtype if not already known.
     if (symbolRegistry.count(type) == 0) {
       postStatusMsg(2) << "#ospray: trying to look up "
@@ -55,11 +61,15 @@ namespace ospray {
       }
     }
 
+    auto creationFunction = symbolRegistry[type];
+    if (!creationFunction)
+      symbolRegistry.erase(type);
+    lock.unlock();
+
     // Create a concrete instance of the requested subtype.
-    auto *object = symbolRegistry[type] ? (*symbolRegistry[type])() : nullptr;
+    auto *object = creationFunction ? (*creationFunction)() : nullptr;
 
     if (object == nullptr) {
-      symbolRegistry.erase(type);
       throw std::runtime_error("Could not find " + type_string + " of type: "
         + type + ".  Make sure you have the correct OSPRay libraries linked.");
     }
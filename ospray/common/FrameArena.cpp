@@ -0,0 +1,183 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "FrameArena.h"
+// ospcommon
+#include "ospcommon/memory/malloc.h"
+// stl
+#include <atomic>
+#include <thread>
+
+namespace ospray {
+
+  namespace {
+
+    static const size_t ALIGNMENT  = 64;
+    static const size_t BLOCK_SIZE = size_t(4) << 20;
+
+    inline size_t alignedSize(size_t size)
+    {
+      return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    std::atomic<uint64> nextArenaID {1};
+
+  } // ::ospray::<anonymous>
+
+  /*! the blocks and free lists of a single thread */
+  struct FrameArena::ThreadArena
+  {
+    ThreadArena() : thread(std::this_thread::get_id()) {}
+
+    ~ThreadArena()
+    {
+      for (auto &block : blocks)
+        alignedFree(block.begin);
+    }
+
+    void *allocate(size_t size)
+    {
+      size = alignedSize(size);
+
+      for (auto &list : freeLists) {
+        if (list.size == size && !list.items.empty()) {
+          void *ptr = list.items.back();
+          list.items.pop_back();
+          return ptr;
+        }
+      }
+
+      while (currentBlock < blocks.size()) {
+        auto &block = blocks[currentBlock];
+        if (offset + size <= block.size) {
+          void *ptr = block.begin + offset;
+          offset += size;
+          return ptr;
+        }
+        currentBlock++;
+        offset = 0;
+      }
+
+      Block block;
+      block.size  = std::max(size, BLOCK_SIZE);
+      block.begin = (byte_t *)alignedMalloc(block.size, ALIGNMENT);
+      blocks.push_back(block);
+      offset = size;
+      return block.begin;
+    }
+
+    void release(void *ptr, size_t size)
+    {
+      size = alignedSize(size);
+
+      for (auto &list : freeLists) {
+        if (list.size == size) {
+          list.items.push_back(ptr);
+          return;
+        }
+      }
+
+      FreeList list;
+      list.size = size;
+      list.items.push_back(ptr);
+      freeLists.push_back(std::move(list));
+    }
+
+    void reset()
+    {
+      currentBlock = 0;
+      offset = 0;
+      for (auto &list : freeLists)
+        list.items.clear();
+    }
+
+    struct Block
+    {
+      byte_t *begin;
+      size_t size;
+    };
+
+    /*! released items of one (aligned) size; there are only ever a
+        handful of different sizes, so a linear search is fine */
+    struct FreeList
+    {
+      size_t size;
+      std::vector<void *> items;
+    };
+
+    const std::thread::id thread;
+    std::vector<Block> blocks;
+    size_t currentBlock {0};
+    size_t offset {0};
+    std::vector<FreeList> freeLists;
+  };
+
+  FrameArena::FrameArena() : id(nextArenaID++) {}
+
+  FrameArena::~FrameArena() = default;
+
+  FrameArena::ThreadArena &FrameArena::threadArena()
+  {
+    // remembers the arena this thread used last, which (while a frame
+    // is rendered) is almost always the one it asks for next; the id
+    // is never reused, so a destroyed arena can never match
+    struct LastUsed
+    {
+      uint64 arenaID {0};
+      ThreadArena *threadArena {nullptr};
+    };
+    static thread_local LastUsed lastUsed;
+
+    if (lastUsed.arenaID == id)
+      return *lastUsed.threadArena;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto thisThread = std::this_thread::get_id();
+    ThreadArena *found = nullptr;
+    for (auto &arena : threadArenas) {
+      if (arena->thread == thisThread) {
+        found = arena.get();
+        break;
+      }
+    }
+    if (!found) {
+      threadArenas.emplace_back(new ThreadArena);
+      found = threadArenas.back().get();
+    }
+
+    lastUsed.arenaID     = id;
+    lastUsed.threadArena = found;
+    return *found;
+  }
+
+  void *FrameArena::allocate(size_t size)
+  {
+    return threadArena().allocate(size);
+  }
+
+  void FrameArena::release(void *ptr, size_t size)
+  {
+    threadArena().release(ptr, size);
+  }
+
+  void FrameArena::reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &arena : threadArenas)
+      arena->reset();
+  }
+
+} // ::ospray
@@ -0,0 +1,97 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "common/OSPCommon.h"
+// stl
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace ospray {
+
+  /*! \brief memory for objects that live (at most) for one frame, such
+      as tiles and compositing fragments
+
+    Each frame buffer owns one arena, so frames rendered concurrently
+    into different frame buffers never share memory. Within an arena,
+    each thread allocates from its own blocks, without any locking.
+    Memory released during the frame goes onto a free list of the
+    releasing thread and is handed out again by it. 'reset()' makes the
+    memory of all threads available again once the frame is done; the
+    blocks themselves are kept, so steady-state frames neither hit the
+    heap nor fault in new pages.
+  */
+  struct OSPRAY_SDK_INTERFACE FrameArena
+  {
+    FrameArena();
+    ~FrameArena();
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /*! allocate 'size' bytes, aligned to 64 bytes */
+    void *allocate(size_t size);
+
+    /*! give memory obtained from 'allocate(size)' back for reuse
+        (within the current frame) */
+    void release(void *ptr, size_t size);
+
+    /*! make all memory of all threads available again; any memory
+        still in use becomes invalid. must only be called when no
+        other thread uses this arena, i.e., at the end of its frame */
+    void reset();
+
+    template <typename T, typename... Args>
+    T *create(Args&&... args);
+
+    template <typename T>
+    void destroy(T *object);
+
+  private:
+
+    struct ThreadArena;
+
+    /*! the arena of the calling thread, created on first use */
+    ThreadArena &threadArena();
+
+    /*! unique over the lifetime of the process, identifies this arena
+        in the per-thread lookup caches */
+    const uint64 id;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadArena>> threadArenas;
+  };
+
+  // Inlined definitions //////////////////////////////////////////////////////
+
+  template <typename T, typename... Args>
+  inline T *FrameArena::create(Args&&... args)
+  {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  inline void FrameArena::destroy(T *object)
+  {
+    object->~T();
+    release(object, sizeof(T));
+  }
+
+} // ::ospray
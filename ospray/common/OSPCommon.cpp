@@ -18,6 +18,7 @@
 #include "api/Device.h"
 
 #include <map>
+#include <mutex>
 
 namespace ospray {
 
@@ -354,6 +355,8 @@ namespace ospray {
   size_t translatedHash(size_t v)
   {
     static std::map<size_t, size_t> id_translation;
+    static std::mutex id_translation_mutex;
+    std::lock_guard<std::mutex> lock(id_translation_mutex);
 
     auto itr = id_translation.find(v);
     if (itr == id_translation.end()) {
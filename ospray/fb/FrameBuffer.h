@@ -20,6 +20,11 @@
 #include "common/Managed.h"
 #include "ospray/ospray.h"
 #include "fb/PixelOp.h"
+#include "common/FrameArena.h"
+
+/*! adaptive sampling: edge length of the pixel blocks that converge
+    individually; has to match the value used in FrameBuffer.ih */
+#define ADAPTIVE_BLOCK_SIZE 4
 
 namespace ospray {
 
@@ -93,5 +98,20 @@ namespace ospray {
     int32 frameID;
 
     Ref<PixelOp::Instance> pixelOp;
+
+    /*! memory for tiles and fragments of the frame currently rendered
+        into this frame buffer; reset at the end of each frame */
+    FrameArena frameArena;
+
+    /*! state of time-budgeted rendering into this frame buffer (see
+        Renderer::frameBudget), kept across frames */
+    struct BudgetState
+    {
+      int32 frameID {0};
+      /*! per tile, the (budgeted) frame it got rendered in last */
+      std::vector<int32> tileLastFrame;
+      /*! running average of the time it takes to render one tile */
+      double tileTime {0.0};
+    } budgetState;
   };
 } // ::ospray
@@ -65,13 +65,21 @@ namespace ospray {
                      (vec4f*)alignedMalloc(sizeof(vec4f)*size.x*size.y) :
                      nullptr;
 
+    blockConverged = nullptr;
+    if (hasAccumBuffer && hasVarianceBuffer) {
+      const vec2i numBlocks = divRoundUp(size, vec2i(ADAPTIVE_BLOCK_SIZE));
+      blockConverged = (uint8*)alignedMalloc(numBlocks.product());
+      memset(blockConverged, 0, numBlocks.product());
+    }
+
     ispcEquivalent = ispc::LocalFrameBuffer_create(this,size.x,size.y,
                                                    colorBufferFormat,
                                                    colorBuffer,
                                                    depthBuffer,
                                                    accumBuffer,
                                                    varianceBuffer,
-                                                   tileAccumID);
+                                                   tileAccumID,
+                                                   blockConverged);
   }
 
   LocalFrameBuffer::~LocalFrameBuffer()
@@ -81,6 +89,7 @@ namespace ospray {
     alignedFree(accumBuffer);
     alignedFree(varianceBuffer);
     alignedFree(tileAccumID);
+    alignedFree(blockConverged);
   }
 
   std::string LocalFrameBuffer::toString() const
@@ -97,6 +106,11 @@ namespace ospray {
       // accumulation buffers
       memset(tileAccumID, 0, getTotalTiles()*sizeof(int32));
 
+      if (blockConverged) {
+        const vec2i numBlocks = divRoundUp(size, vec2i(ADAPTIVE_BLOCK_SIZE));
+        memset(blockConverged, 0, numBlocks.product());
+      }
+
       // always also clear error buffer (if present)
       if (hasVarianceBuffer) {
         tileErrorRegion.clear();
@@ -106,6 +120,14 @@ namespace ospray {
 
   void LocalFrameBuffer::setTile(Tile &tile)
   {
+    if (tile.pixelsPerSample > 1) {
+      const size_t bytes = 4 * sizeof(float)
+                           * (TILE_SIZE*TILE_SIZE / tile.pixelsPerSample);
+      void *scratch = frameArena.allocate(bytes);
+      ispc::LocalFrameBuffer_upsampleTile(getIE(), (ispc::Tile&)tile,
+                                          (float*)scratch);
+      frameArena.release(scratch, bytes);
+    }
     if (pixelOp)
       pixelOp->preAccum(tile);
     if (accumBuffer) {
@@ -153,6 +175,10 @@ namespace ospray {
   {
     if (pixelOp)
       pixelOp->endFrame();
+    // blocks get marked as converged when accumulating the next frame,
+    // if (and only if) 'errorThreshold' is > 0
+    if (blockConverged)
+      ispc::LocalFrameBuffer_setErrorThreshold(getIE(), errorThreshold);
     return tileErrorRegion.refine(errorThreshold);
   }
 
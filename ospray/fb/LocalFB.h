@@ -32,6 +32,7 @@ namespace ospray {
     vec4f     *accumBuffer; /*!< one RGBA per pixel, may be NULL */
     vec4f     *varianceBuffer; /*!< one RGBA per pixel, may be NULL, accumulates every other sample, for variance estimation / stopping */
     int32     *tileAccumID; //< holds accumID per tile, for adaptive accumulation
+    uint8     *blockConverged; /*!< per pixel block, whether it has converged (see ADAPTIVE_BLOCK_SIZE); only with accum and variance buffers, for per-pixel adaptive sampling (which is active with an error threshold > 0 only) */
     TileError  tileErrorRegion; /*!< holds error per tile and adaptive regions, for variance estimation / stopping */
 
     LocalFrameBuffer(const vec2i &size,
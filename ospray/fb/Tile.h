@@ -54,14 +54,20 @@ namespace ospray {
     int32    generation;
     int32    children;
     int32    accumID; //!< how often has been accumulated into this tile
+    /*! number of pixels that share one sample (a power of 4; these
+        are square blocks of consecutive pixels in z-order), for
+        subsampled or foveated rendering */
+    int32    pixelsPerSample;
 
     Tile() = default;
-    Tile(const vec2i &tile, const vec2i &fbsize, const int32 accumId)
+    Tile(const vec2i &tile, const vec2i &fbsize, const int32 accumId,
+         const int32 pixelsPerSample = 1)
       : fbSize(fbsize),
         rcp_fbSize(rcp(vec2f(fbsize))),
         generation(0),
         children(0),
-        accumID(accumId)
+        accumID(accumId),
+        pixelsPerSample(pixelsPerSample)
     {
       region.lower = tile * TILE_SIZE;
       region.upper = ospcommon::min(region.lower + TILE_SIZE, fbsize);
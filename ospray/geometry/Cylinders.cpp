@@ -20,8 +20,12 @@
 #include "Cylinders.h"
 #include "common/Data.h"
 #include "common/Model.h"
+#include "ospcommon/tasking/parallel_for.h"
 // ispc-generated files
 #include "Cylinders_ispc.h"
+// std
+#include <algorithm>
+#include <limits>
 
 namespace ospray {
 
@@ -59,16 +63,50 @@ namespace ospray {
     postStatusMsg(2) << "#osp: creating 'cylinders' geometry, #cylinders = "
                      << numCylinders;
 
-    const char* cylinderPtr = (const char*)cylinderData->data;
-    bounds = empty;
-    for (uint32_t i = 0; i < numCylinders; i++, cylinderPtr += bytesPerCylinder) {
-      const float r = offset_radius < 0 ? radius : *(const float*)(cylinderPtr + offset_radius);
-      const vec3f v0 = *(const vec3f*)(cylinderPtr + offset_v0);
-      const vec3f v1 = *(const vec3f*)(cylinderPtr + offset_v1);
-      bounds.extend(box3f(v0 - r, v0 + r));
-      bounds.extend(box3f(v1 - r, v1 + r));
+    // the curve control points are addressed with 32-bit offsets
+    const bool useCurves =
+      4*numCylinders <= size_t(std::numeric_limits<int32>::max());
+    if (useCurves) {
+      curveVertex.resize(4*numCylinders);
+      curveIndex.resize(numCylinders);
+    } else {
+      curveVertex = std::vector<vec4f>();
+      curveIndex = std::vector<uint32>();
     }
 
+    // compute the bounds and convert the cylinders to (straight) curves
+    // in parallel, directly into the pre-sized curve arrays
+    const size_t blockSize = 16*1024;
+    const size_t numBlocks = divRoundUp(numCylinders, blockSize);
+    std::vector<box3f> blockBounds(numBlocks);
+    const char *cylinderBase = (const char*)cylinderData->data;
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * blockSize;
+      const size_t end = std::min(begin + blockSize, numCylinders);
+      box3f blockBox = empty;
+      for (size_t i = begin; i < end; i++) {
+        const char *cylinderPtr = cylinderBase + i * bytesPerCylinder;
+        const float r = offset_radius < 0 ? radius : *(const float*)(cylinderPtr + offset_radius);
+        const vec3f v0 = *(const vec3f*)(cylinderPtr + offset_v0);
+        const vec3f v1 = *(const vec3f*)(cylinderPtr + offset_v1);
+        blockBox.extend(box3f(v0 - r, v0 + r));
+        blockBox.extend(box3f(v1 - r, v1 + r));
+        if (useCurves) {
+          vec4f *v = &curveVertex[4*i];
+          v[0] = vec4f(v0, r);
+          v[1] = vec4f(lerp(1.f/3, v0, v1), r);
+          v[2] = vec4f(lerp(2.f/3, v0, v1), r);
+          v[3] = vec4f(v1, r);
+          curveIndex[i] = 4*i;
+        }
+      }
+      blockBounds[blockID] = blockBox;
+    });
+
+    bounds = empty;
+    for (const auto &blockBox : blockBounds)
+      bounds.extend(blockBox);
+
     auto colComps = colorData && colorData->type == OSP_FLOAT3 ? 3 : 4;
     ispc::CylindersGeometry_set(getIE(),model->getIE(),
                                 cylinderData->data,
@@ -81,7 +119,9 @@ namespace ospray {
                                 radius,materialID,
                                 offset_v0,offset_v1,
                                 offset_radius,
-                                offset_materialID,offset_colorID);
+                                offset_materialID,offset_colorID,
+                                useCurves ? (ispc::vec3fa*)curveVertex.data() : nullptr,
+                                useCurves ? curveIndex.data() : nullptr);
   }
 
 
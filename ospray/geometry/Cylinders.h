@@ -47,6 +47,15 @@ namespace ospray {
     <dt><code>Data<float>  color</code></dt><dd>Array of color (RGBA) elements accessed by indexes (per element) in 'cylinders' colorID data.</dd>
     </dl>
 
+    Each cylinder is handed to embree as a straight (cubic) Bezier
+    curve of constant radius, i.e., as an exact open cylinder that
+    embree intersects natively. Only if there are too many cylinders
+    to address the curve control points with 32-bit offsets a user
+    geometry (with one ISPC intersect callback per cylinder) is used.
+    The curves are kept in addition to the application's 'cylinders'
+    array and take 68 bytes per cylinder (four vec4f control points and
+    an index), e.g., 3.4 GB for 50M cylinders.
+
     The functionality for this geometry is implemented via the
     \ref ospray::Cylinders class.
 
@@ -81,6 +90,11 @@ namespace ospray {
     Ref<Data> cylinderData;
     Ref<Data> colorData; /*!< cylinder color array */
     Ref<Data> texcoordData;
+
+    /*! four control points (with radius in 'w') per cylinder; empty if
+        the cylinders are intersected via the user geometry */
+    std::vector<vec4f> curveVertex;
+    std::vector<uint32> curveIndex;
   };
 /*! @} */
 
@@ -0,0 +1,506 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+// ospray
+#include "IsosurfaceExtraction.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+// std
+#include <algorithm>
+#include <stdexcept>
+
+namespace ospray {
+
+  /*! offset of each voxel corner, in marching cubes order */
+  static const int cornerOffset[8][3] = {
+    {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0},
+    {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1}
+  };
+
+  /*! the grid edge each voxel edge maps to: offset of the grid point
+      owning the edge (every grid point owns its +x, +y, and +z edge),
+      followed by the edge's axis */
+  static const int edgeOwner[12][4] = {
+    {0,0,0,0}, {1,0,0,1}, {0,1,0,0}, {0,0,0,1},
+    {0,0,1,0}, {1,0,1,1}, {0,1,1,0}, {0,0,1,1},
+    {0,0,0,2}, {1,0,0,2}, {1,1,0,2}, {0,1,0,2}
+  };
+
+  /*! triangles (as triples of voxel edges, terminated by -1) for each
+      of the 256 inside/outside configurations of the voxel corners
+      (bit 'i' set if corner 'i' is below the isovalue). ambiguous
+      faces always separate the corners below the isovalue, so
+      neighboring voxels agree on their shared faces */
+  static const int8 triTable[256][16] = {
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 9, 3, 9, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 8, 2, 8,11,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3,11, 1,11,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8,11, 1,11,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3,11, 0,11,10, 0,10, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 9, 8,11, 9,11,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 4, 3, 4, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 7, 1, 2,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 9, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 9, 3, 9, 4, 3, 4, 7,-1,-1,-1,-1},
+    { 2, 3,11, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 4, 2, 4, 7, 2, 7,11,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 9, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 4, 2, 4, 7, 2, 7,11,-1,-1,-1,-1},
+    { 1, 3,11, 1,11,10, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 4, 1, 4, 7, 1, 7,11, 1,11,10,-1,-1,-1,-1},
+    { 0, 3,11, 0,11,10, 0,10, 9, 4, 7, 8,-1,-1,-1,-1},
+    { 4, 7,11, 4,11,10, 4,10, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 4, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 5, 0, 5, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 5, 3, 5, 4, 3, 4, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,10, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 5, 0, 5, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 5, 3, 5, 4, 3, 4, 8,-1,-1,-1,-1},
+    { 2, 3,11, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8,11, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 5, 0, 5, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 5, 2, 5, 4, 2, 4, 8, 2, 8,11,-1,-1,-1,-1},
+    { 1, 3,11, 1,11,10, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8,11, 1,11,10, 5, 4, 9,-1,-1,-1,-1},
+    { 0, 3,11, 0,11,10, 0,10, 5, 0, 5, 4,-1,-1,-1,-1},
+    { 5, 4, 8, 5, 8,11, 5,11,10,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 7, 8, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9, 5, 3, 5, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 5, 0, 5, 7, 0, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 5, 3, 5, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 5, 7, 8, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9, 5, 3, 5, 7, 1, 2,10,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 5, 0, 5, 7, 0, 7, 8,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 5, 3, 5, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 5, 7, 8, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 9, 2, 9, 5, 2, 5, 7, 2, 7,11,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 5, 0, 5, 7, 0, 7, 8,-1,-1,-1,-1},
+    { 2, 1, 5, 2, 5, 7, 2, 7,11,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3,11, 1,11,10, 5, 7, 8, 5, 8, 9,-1,-1,-1,-1},
+    { 1, 0, 7, 0, 9, 5, 0, 5, 7, 1, 7,11, 1,11,10,-1},
+    { 0, 3,11, 0,11,10, 0,10, 5, 0, 5, 7, 0, 7, 8,-1},
+    { 5, 7,11, 5,11,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 6, 5,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 6, 5,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 6, 5,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 8, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2, 6, 1, 6, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2, 6, 1, 6, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 2, 6, 0, 6, 5, 0, 5, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2, 6, 3, 6, 5, 3, 5, 9, 3, 9, 8,-1,-1,-1,-1},
+    { 2, 3,11, 6, 5,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8,11, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 9, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 8, 2, 8,11, 6, 5,10,-1,-1,-1,-1},
+    { 1, 3,11, 1,11, 6, 1, 6, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8,11, 1,11, 6, 1, 6, 5,-1,-1,-1,-1},
+    { 0, 3,11, 0,11, 6, 0, 6, 5, 0, 5, 9,-1,-1,-1,-1},
+    { 6, 5, 9, 6, 9, 8, 6, 8,11,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 7, 8, 6, 5,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 7, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 4, 7, 8, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 4, 3, 4, 7, 6, 5,10,-1,-1,-1,-1},
+    { 1, 2, 6, 1, 6, 5, 4, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 7, 1, 2, 6, 1, 6, 5,-1,-1,-1,-1},
+    { 0, 2, 6, 0, 6, 5, 0, 5, 9, 4, 7, 8,-1,-1,-1,-1},
+    { 3, 2, 6, 3, 6, 5, 3, 5, 9, 3, 9, 4, 3, 4, 7,-1},
+    { 2, 3,11, 4, 7, 8, 6, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 4, 2, 4, 7, 2, 7,11, 6, 5,10,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1, 9, 4, 7, 8, 6, 5,10,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 4, 2, 4, 7, 2, 7,11, 6, 5,10,-1},
+    { 1, 3,11, 1,11, 6, 1, 6, 5, 4, 7, 8,-1,-1,-1,-1},
+    { 1, 0, 4, 1, 4, 7, 1, 7,11, 1,11, 6, 1, 6, 5,-1},
+    { 0, 3,11, 0,11, 6, 0, 6, 5, 0, 5, 9, 4, 7, 8,-1},
+    { 4, 7,11, 4,11, 9,11, 6, 5,11, 5, 9,-1,-1,-1,-1},
+    { 6, 4, 9, 6, 9,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 6, 4, 9, 6, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1,10, 0,10, 6, 0, 6, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1,10, 3,10, 6, 3, 6, 4, 3, 4, 8,-1,-1,-1,-1},
+    { 1, 2, 6, 1, 6, 4, 1, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2, 6, 1, 6, 4, 1, 4, 9,-1,-1,-1,-1},
+    { 0, 2, 6, 0, 6, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2, 6, 3, 6, 4, 3, 4, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 6, 4, 9, 6, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8,11, 6, 4, 9, 6, 9,10,-1,-1,-1,-1},
+    { 2, 3,11, 0, 1,10, 0,10, 6, 0, 6, 4,-1,-1,-1,-1},
+    { 2, 1, 4, 1,10, 6, 1, 6, 4, 2, 4, 8, 2, 8,11,-1},
+    { 1, 3,11, 1,11, 6, 1, 6, 4, 1, 4, 9,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8,11, 1,11, 6, 1, 6, 4, 1, 4, 9,-1},
+    { 0, 3,11, 0,11, 6, 0, 6, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 6, 4, 8, 6, 8,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 6, 7, 8, 6, 8, 9, 6, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9,10, 3,10, 6, 3, 6, 7,-1,-1,-1,-1},
+    { 0, 1,10, 0,10, 6, 0, 6, 7, 0, 7, 8,-1,-1,-1,-1},
+    { 3, 1,10, 3,10, 6, 3, 6, 7,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2, 6, 1, 6, 7, 1, 7, 8, 1, 8, 9,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9, 6, 9, 1, 2, 9, 2, 6, 3, 6, 7,-1},
+    { 0, 2, 6, 0, 6, 7, 0, 7, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2, 6, 3, 6, 7,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3,11, 6, 7, 8, 6, 8, 9, 6, 9,10,-1,-1,-1,-1},
+    { 2, 0, 9, 2, 9, 7, 9,10, 6, 9, 6, 7, 2, 7,11,-1},
+    { 2, 3,11, 0, 1,10, 0,10, 6, 0, 6, 7, 0, 7, 8,-1},
+    { 2, 1, 7, 1,10, 6, 1, 6, 7, 2, 7,11,-1,-1,-1,-1},
+    { 1, 3,11, 1,11, 6, 1, 6, 7, 1, 7, 8, 1, 8, 9,-1},
+    { 1, 0, 9, 6, 7,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3,11, 0,11, 6, 0, 6, 7, 0, 7, 8,-1,-1,-1,-1},
+    { 6, 7,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 8, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,10, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 9, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 9, 3, 9, 8, 7, 6,11,-1,-1,-1,-1},
+    { 2, 3, 7, 2, 7, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8, 7, 2, 7, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 7, 2, 7, 6, 0, 1, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 8, 2, 8, 7, 2, 7, 6,-1,-1,-1,-1},
+    { 1, 3, 7, 1, 7, 6, 1, 6,10,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8, 7, 1, 7, 6, 1, 6,10,-1,-1,-1,-1},
+    { 0, 3, 7, 0, 7, 6, 0, 6,10, 0,10, 9,-1,-1,-1,-1},
+    { 7, 6,10, 7,10, 9, 7, 9, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 6,11, 4,11, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 6, 3, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 4, 6,11, 4,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 4, 3, 4, 6, 3, 6,11,-1,-1,-1,-1},
+    { 1, 2,10, 4, 6,11, 4,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 6, 3, 6,11, 1, 2,10,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 9, 4, 6,11, 4,11, 8,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 9, 3, 9, 4, 3, 4, 6, 3, 6,11,-1},
+    { 2, 3, 8, 2, 8, 4, 2, 4, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 4, 2, 4, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 4, 2, 4, 6, 0, 1, 9,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 4, 2, 4, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 8, 1, 8, 4, 1, 4, 6, 1, 6,10,-1,-1,-1,-1},
+    { 1, 0, 4, 1, 4, 6, 1, 6,10,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3, 6, 3, 8, 4, 3, 4, 6, 0, 6,10, 0,10, 9,-1},
+    { 4, 6,10, 4,10, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 4, 9, 7, 6,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 5, 4, 9, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 5, 0, 5, 4, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 5, 3, 5, 4, 3, 4, 8, 7, 6,11,-1,-1,-1,-1},
+    { 1, 2,10, 5, 4, 9, 7, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,10, 5, 4, 9, 7, 6,11,-1,-1,-1,-1},
+    { 0, 2,10, 0,10, 5, 0, 5, 4, 7, 6,11,-1,-1,-1,-1},
+    { 3, 2,10, 3,10, 5, 3, 5, 4, 3, 4, 8, 7, 6,11,-1},
+    { 2, 3, 7, 2, 7, 6, 5, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8, 7, 2, 7, 6, 5, 4, 9,-1,-1,-1,-1},
+    { 2, 3, 7, 2, 7, 6, 0, 1, 5, 0, 5, 4,-1,-1,-1,-1},
+    { 2, 1, 5, 2, 5, 4, 2, 4, 8, 2, 8, 7, 2, 7, 6,-1},
+    { 1, 3, 7, 1, 7, 6, 1, 6,10, 5, 4, 9,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8, 7, 1, 7, 6, 1, 6,10, 5, 4, 9,-1},
+    { 0, 3, 7, 0, 7, 6, 0, 6,10, 0,10, 5, 0, 5, 4,-1},
+    { 5, 4, 8, 5, 8,10, 8, 7, 6, 8, 6,10,-1,-1,-1,-1},
+    { 5, 6,11, 5,11, 8, 5, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9, 5, 3, 5, 6, 3, 6,11,-1,-1,-1,-1},
+    { 0, 1, 5, 0, 5, 6, 0, 6,11, 0,11, 8,-1,-1,-1,-1},
+    { 3, 1, 5, 3, 5, 6, 3, 6,11,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,10, 5, 6,11, 5,11, 8, 5, 8, 9,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9, 5, 3, 5, 6, 3, 6,11, 1, 2,10,-1},
+    { 0, 2,10, 0,10, 5, 0, 5, 6, 0, 6,11, 0,11, 8,-1},
+    { 3, 2,10, 3,10, 5, 3, 5, 6, 3, 6,11,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 9, 2, 9, 5, 2, 5, 6,-1,-1,-1,-1},
+    { 2, 0, 9, 2, 9, 5, 2, 5, 6,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 5, 8, 0, 1, 8, 1, 5, 2, 5, 6,-1},
+    { 2, 1, 5, 2, 5, 6,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 8, 1, 8, 6, 8, 9, 5, 8, 5, 6, 1, 6,10,-1},
+    { 1, 0, 6, 0, 9, 5, 0, 5, 6, 1, 6,10,-1,-1,-1,-1},
+    { 0, 3, 8, 5, 6,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 5, 6,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 5,10, 7,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 7, 5,10, 7,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1, 9, 7, 5,10, 7,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 8, 7, 5,10, 7,10,11,-1,-1,-1,-1},
+    { 1, 2,11, 1,11, 7, 1, 7, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,11, 1,11, 7, 1, 7, 5,-1,-1,-1,-1},
+    { 0, 2,11, 0,11, 7, 0, 7, 5, 0, 5, 9,-1,-1,-1,-1},
+    { 3, 2, 5, 2,11, 7, 2, 7, 5, 3, 5, 9, 3, 9, 8,-1},
+    { 2, 3, 7, 2, 7, 5, 2, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8, 7, 2, 7, 5, 2, 5,10,-1,-1,-1,-1},
+    { 2, 3, 7, 2, 7, 5, 2, 5,10, 0, 1, 9,-1,-1,-1,-1},
+    { 2, 1, 9, 2, 9, 8, 2, 8, 7, 2, 7, 5, 2, 5,10,-1},
+    { 1, 3, 7, 1, 7, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8, 7, 1, 7, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3, 7, 0, 7, 5, 0, 5, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 5, 9, 7, 9, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 4, 5,10, 4,10,11, 4,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 5, 3, 5,10, 3,10,11,-1,-1,-1,-1},
+    { 0, 1, 9, 4, 5,10, 4,10,11, 4,11, 8,-1,-1,-1,-1},
+    { 3, 1, 9, 3, 9, 4, 3, 4, 5, 3, 5,10, 3,10,11,-1},
+    { 1, 2,11, 1,11, 8, 1, 8, 4, 1, 4, 5,-1,-1,-1,-1},
+    { 3, 0, 4, 3, 4, 5, 3, 5,11, 5, 1, 2, 5, 2,11,-1},
+    { 0, 2,11, 0,11, 5,11, 8, 4,11, 4, 5, 0, 5, 9,-1},
+    { 3, 2,11, 4, 5, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 4, 2, 4, 5, 2, 5,10,-1,-1,-1,-1},
+    { 2, 0, 4, 2, 4, 5, 2, 5,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 4, 2, 4, 5, 2, 5,10, 0, 1, 9,-1},
+    { 2, 1, 9, 2, 9, 4, 2, 4, 5, 2, 5,10,-1,-1,-1,-1},
+    { 1, 3, 8, 1, 8, 4, 1, 4, 5,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 4, 1, 4, 5,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3, 5, 3, 8, 4, 3, 4, 5, 0, 5, 9,-1,-1,-1,-1},
+    { 4, 5, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 4, 9, 7, 9,10, 7,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 8, 7, 4, 9, 7, 9,10, 7,10,11,-1,-1,-1,-1},
+    { 0, 1,10, 0,10,11, 0,11, 7, 0, 7, 4,-1,-1,-1,-1},
+    { 3, 1,10, 3,10, 4,10,11, 7,10, 7, 4, 3, 4, 8,-1},
+    { 1, 2,11, 1,11, 7, 1, 7, 4, 1, 4, 9,-1,-1,-1,-1},
+    { 3, 0, 8, 1, 2,11, 1,11, 7, 1, 7, 4, 1, 4, 9,-1},
+    { 0, 2,11, 0,11, 7, 0, 7, 4,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2, 4, 2,11, 7, 2, 7, 4, 3, 4, 8,-1,-1,-1,-1},
+    { 2, 3, 7, 2, 7, 4, 2, 4, 9, 2, 9,10,-1,-1,-1,-1},
+    { 2, 0, 8, 2, 8, 7, 2, 7, 4, 2, 4, 9, 2, 9,10,-1},
+    { 2, 3, 7, 2, 7, 4, 2, 4,10, 4, 0, 1, 4, 1,10,-1},
+    { 2, 1,10, 7, 4, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 7, 1, 7, 4, 1, 4, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 8, 1, 8, 7, 1, 7, 4, 1, 4, 9,-1,-1,-1,-1},
+    { 0, 3, 7, 0, 7, 4,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 7, 4, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 8, 9,10, 8,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9,10, 3,10,11,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 1,10, 0,10,11, 0,11, 8,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 1,10, 3,10,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 2,11, 1,11, 8, 1, 8, 9,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 0, 9, 3, 9,11, 9, 1, 2, 9, 2,11,-1,-1,-1,-1},
+    { 0, 2,11, 0,11, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 3, 2,11,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8, 9, 2, 9,10,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 0, 9, 2, 9,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 2, 3, 8, 2, 8,10, 8, 0, 1, 8, 1,10,-1,-1,-1,-1},
+    { 2, 1,10,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 3, 8, 1, 8, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 1, 0, 9,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    { 0, 3, 8,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1},
+    {-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1}
+  };
+
+  static int numTriangles(int cubeCase)
+  {
+    int n = 0;
+    while (n < 5 && triTable[cubeCase][3*n] >= 0)
+      n++;
+    return n;
+  }
+
+  /*! a few consecutive slices of the grid, starting at slice 'z0' */
+  struct SliceWindow
+  {
+    SliceWindow(size_t nx, size_t ny, size_t nz) : nx(nx), ny(ny), nz(nz) {}
+
+    float operator()(size_t x, size_t y, size_t z) const
+    {
+      return values[((z - z0) * ny + y) * nx + x];
+    }
+
+    /*! marching cubes case of the voxel at (x,y,z) */
+    int cubeCase(size_t x, size_t y, size_t z, float iso) const
+    {
+      int c = 0;
+      for (int i = 0; i < 8; i++) {
+        c |= ((*this)(x + cornerOffset[i][0],
+                      y + cornerOffset[i][1],
+                      z + cornerOffset[i][2]) < iso) << i;
+      }
+      return c;
+    }
+
+    /*! load (up to) 'count' slices starting at slice 'z' */
+    void load(const LoadSlice &loadSlice, size_t z, size_t count)
+    {
+      z0 = z;
+      count = std::min(count, nz - z);
+      values.resize(count * nx * ny);
+      for (size_t i = 0; i < count; i++)
+        loadSlice(z + i, values.data() + i * nx * ny);
+    }
+
+    size_t nx, ny, nz;
+    size_t z0 {0};
+    std::vector<float> values;
+  };
+
+  void extractIsosurfaces(const LoadSlice &loadSlice,
+                          const vec3i &dimensions,
+                          const vec3f &gridOrigin,
+                          const vec3f &gridSpacing,
+                          const float *isovalues,
+                          size_t numIsovalues,
+                          IsosurfaceMesh &mesh)
+  {
+    if (reduce_min(dimensions) < 2 || numIsovalues == 0)
+      return;
+
+    const size_t nx = dimensions.x;
+    const size_t ny = dimensions.y;
+    const size_t nz = dimensions.z;
+    const size_t numRows = ny * nz;
+
+    int numCaseTriangles[256];
+    for (int i = 0; i < 256; i++)
+      numCaseTriangles[i] = numTriangles(i);
+
+    // pass 1: count crossed edges per row of grid points, and triangles
+    // per row of voxels, for each isovalue (+1 for the prefix sums
+    // below). each task only needs its own and the next slice
+    const size_t numOffsets = numIsovalues * numRows;
+    std::vector<size_t> vertexOffset(numOffsets + 1, 0);
+    std::vector<size_t> triangleOffset(numOffsets + 1, 0);
+
+    tasking::parallel_for(nz, [&](size_t z) {
+      SliceWindow value {nx, ny, nz};
+      value.load(loadSlice, z, 2);
+
+      for (size_t isoID = 0; isoID < numIsovalues; isoID++) {
+        const float iso = isovalues[isoID];
+        for (size_t y = 0; y < ny; y++) {
+          size_t numVertices = 0;
+          for (size_t x = 0; x < nx; x++) {
+            const bool in = value(x, y, z) < iso;
+            numVertices += (x + 1 < nx && in != (value(x + 1, y, z) < iso));
+            numVertices += (y + 1 < ny && in != (value(x, y + 1, z) < iso));
+            numVertices += (z + 1 < nz && in != (value(x, y, z + 1) < iso));
+          }
+
+          size_t numTris = 0;
+          if (y + 1 < ny && z + 1 < nz) {
+            for (size_t x = 0; x + 1 < nx; x++)
+              numTris += numCaseTriangles[value.cubeCase(x, y, z, iso)];
+          }
+
+          const size_t row = isoID * numRows + z * ny + y;
+          vertexOffset[row + 1]   = numVertices;
+          triangleOffset[row + 1] = numTris;
+        }
+      }
+    });
+
+    vertexOffset[0]   = mesh.vertex.size();
+    triangleOffset[0] = mesh.index.size();
+    for (size_t r = 0; r < numOffsets; r++) {
+      vertexOffset[r + 1]   += vertexOffset[r];
+      triangleOffset[r + 1] += triangleOffset[r];
+    }
+
+    if (vertexOffset[numOffsets] > size_t(INT32_MAX))
+      throw std::runtime_error("#osp: extracted isosurface has too many "
+                               "vertices");
+
+    mesh.vertex.resize(vertexOffset[numOffsets]);
+    mesh.index.resize(triangleOffset[numOffsets]);
+    mesh.isovalueID.resize(triangleOffset[numOffsets]);
+
+    // pass 2: write vertices and triangles at their offsets. each task
+    // emits the vertices of its own slice of grid points, and
+    // (re-)computes the vertex IDs of the next slice it shares the
+    // voxels with (which needs the slice after that, too)
+    tasking::parallel_for(nz, [&](size_t z) {
+      SliceWindow value {nx, ny, nz};
+      value.load(loadSlice, z, 3);
+
+      // vertex ID of each edge (3 per grid point) of rows [y,y+1] in
+      // slices [z,z+1]
+      std::vector<int32> edgeIDs(4 * 3 * nx);
+      auto rowEdges = [&](int dy, int dz) {
+        return edgeIDs.data() + (2 * dz + dy) * 3 * nx;
+      };
+
+      const bool lastSlice = z + 1 >= nz;
+
+      for (size_t isoID = 0; isoID < numIsovalues; isoID++) {
+        const float iso = isovalues[isoID];
+        const size_t *isoVertexOffset = vertexOffset.data() + isoID * numRows;
+        const size_t *isoTriangleOffset =
+          triangleOffset.data() + isoID * numRows;
+
+        auto computeRowEdges = [&](size_t rowY, size_t rowZ,
+                                   int32 *ids, bool emit) {
+          size_t id = isoVertexOffset[rowZ * ny + rowY];
+          for (size_t x = 0; x < nx; x++) {
+            const float v0 = value(x, rowY, rowZ);
+            const bool in = v0 < iso;
+            for (int axis = 0; axis < 3; axis++) {
+              const size_t x1 = x + (axis == 0);
+              const size_t y1 = rowY + (axis == 1);
+              const size_t z1 = rowZ + (axis == 2);
+              if (x1 >= nx || y1 >= ny || z1 >= nz
+                  || in == (value(x1, y1, z1) < iso)) {
+                ids[3 * x + axis] = -1;
+                continue;
+              }
+
+              ids[3 * x + axis] = int32(id);
+              if (emit) {
+                float t = (iso - v0) / (value(x1, y1, z1) - v0);
+                if (!(t >= 0.f)) t = 0.f;
+                if (t > 1.f) t = 1.f;
+                vec3f p((float)x, (float)rowY, (float)rowZ);
+                p[axis] += t;
+                mesh.vertex[id] = vec3fa(gridOrigin + p * gridSpacing);
+              }
+              id++;
+            }
+          }
+        };
+
+        computeRowEdges(0, z, rowEdges(0, 0), true);
+        if (!lastSlice)
+          computeRowEdges(0, z + 1, rowEdges(0, 1), false);
+
+        for (size_t y = 0; y + 1 < ny; y++) {
+          computeRowEdges(y + 1, z, rowEdges(1, 0), true);
+          if (lastSlice)
+            continue;
+          computeRowEdges(y + 1, z + 1, rowEdges(1, 1), false);
+
+          size_t triID = isoTriangleOffset[z * ny + y];
+          for (size_t x = 0; x + 1 < nx; x++) {
+            const int8 *tri = triTable[value.cubeCase(x, y, z, iso)];
+            for (; *tri >= 0; tri += 3, triID++) {
+              int32 v[3];
+              for (int i = 0; i < 3; i++) {
+                const int *e = edgeOwner[tri[i]];
+                v[i] = rowEdges(e[1], e[2])[3 * (x + e[0]) + e[3]];
+              }
+              mesh.index[triID] = vec3i(v[0], v[1], v[2]);
+              mesh.isovalueID[triID] = int32(isoID);
+            }
+          }
+
+          std::copy(rowEdges(1, 0), rowEdges(1, 0) + 3 * nx, rowEdges(0, 0));
+          std::copy(rowEdges(1, 1), rowEdges(1, 1) + 3 * nx, rowEdges(0, 1));
+        }
+      }
+    });
+  }
+
+} // ::ospray
@@ -0,0 +1,58 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "common/OSPCommon.h"
+// std
+#include <functional>
+#include <vector>
+
+namespace ospray {
+
+  /*! a welded triangle mesh of one or more isosurfaces */
+  struct IsosurfaceMesh
+  {
+    std::vector<vec3fa> vertex;
+    std::vector<vec3i>  index;
+    /*! per triangle: index of the isovalue it belongs to */
+    std::vector<int32>  isovalueID;
+  };
+
+  /*! loads the values of slice 'z' of the grid (x fastest) into
+      'slice'; gets called concurrently for different slices */
+  using LoadSlice = std::function<void(size_t z, float *slice)>;
+
+  /*! extract the isosurfaces of a regular grid of 'dimensions' values
+      via marching cubes, appending them to 'mesh'.
+
+      Runs in parallel over slices of the grid, in two passes: the
+      first pass counts the crossed grid edges and the triangles per
+      row of voxels, the second pass writes them to their (prefix-sum)
+      offsets. Each task only loads the (up to three) slices it needs,
+      so the grid never has to be held in memory as a whole. Each
+      vertex is stored exactly once, on the grid edge that owns it, so
+      the result is welded (and watertight), and it is identical no
+      matter how the work was scheduled. */
+  void extractIsosurfaces(const LoadSlice &loadSlice,
+                          const vec3i &dimensions,
+                          const vec3f &gridOrigin,
+                          const vec3f &gridSpacing,
+                          const float *isovalues,
+                          size_t numIsovalues,
+                          IsosurfaceMesh &mesh);
+
+} // ::ospray
@@ -20,8 +20,14 @@
 #include "Isosurfaces.h"
 #include "common/Data.h"
 #include "common/Model.h"
+#include "volume/structured/StructuredVolume.h"
+#include "ospcommon/tasking/parallel_for.h"
+// embree
+#include "embree2/rtcore.h"
 // ispc-generated files
 #include "Isosurfaces_ispc.h"
+// std
+#include <algorithm>
 
 namespace ospray {
 
@@ -30,6 +36,11 @@ namespace ospray {
     this->ispcEquivalent = ispc::Isosurfaces_create(this);
   }
 
+  Isosurfaces::~Isosurfaces()
+  {
+    setVolume(nullptr);
+  }
+
   std::string Isosurfaces::toString() const
   {
     return "ospray::Isosurfaces";
@@ -38,7 +49,7 @@ namespace ospray {
   void Isosurfaces::finalize(Model *model)
   {
     isovaluesData = getParamData("isovalues", nullptr);
-    volume        = (Volume *)getParamObject("volume", nullptr);
+    setVolume((Volume *)getParamObject("volume", nullptr));
 
     Assert(isovaluesData);
     Assert(isovaluesData->numItems > 0);
@@ -47,8 +58,133 @@ namespace ospray {
     numIsovalues = isovaluesData->numItems;
     isovalues    = (float*)isovaluesData->data;
 
-    ispc::Isosurfaces_set(getIE(), model->getIE(), numIsovalues,
-                          isovalues, volume->getIE());
+    bool extract = getParam1i("extract", 0);
+    if (extract && (!dynamic_cast<StructuredVolume*>(volume.ptr)
+                    || volume->isDataDistributed())) {
+      postStatusMsg(1) << "#osp: isosurface extraction requires a (local) "
+                       << "structured volume, falling back to implicit "
+                       << "isosurfaces";
+      extract = false;
+    }
+
+    if (!extract) {
+      mesh = IsosurfaceMesh();
+      meshNormal = std::vector<vec3f>();
+      meshValid = false;
+      ispc::Isosurfaces_set(getIE(), model->getIE(), numIsovalues,
+                            isovalues, volume->getIE());
+      return;
+    }
+
+    const bool isovaluesChanged =
+      extractedIsovalues.size() != numIsovalues ||
+      !std::equal(isovalues, isovalues + numIsovalues,
+                  extractedIsovalues.begin());
+    if (!meshValid || extractedVolume != volume.ptr || isovaluesChanged) {
+      // mark the mesh as valid first, so a change of the volume during
+      // the extraction triggers another one
+      meshValid = true;
+      extractMesh();
+      extractedVolume = volume.ptr;
+      extractedIsovalues.assign(isovalues, isovalues + numIsovalues);
+
+      postStatusMsg(2) << "ospray: extracted " << mesh.index.size()
+                       << " isosurface triangles (" << mesh.vertex.size()
+                       << " vertices)";
+    }
+
+    RTCScene embreeSceneHandle = model->embreeSceneHandle;
+    const uint32 eMesh = rtcNewTriangleMesh(embreeSceneHandle,
+                                            RTC_GEOMETRY_STATIC,
+                                            mesh.index.size(),
+                                            mesh.vertex.size());
+    rtcSetBuffer(embreeSceneHandle, eMesh, RTC_VERTEX_BUFFER,
+                 mesh.vertex.data(), 0, sizeof(vec3fa));
+    rtcSetBuffer(embreeSceneHandle, eMesh, RTC_INDEX_BUFFER,
+                 mesh.index.data(), 0, sizeof(vec3i));
+
+    bounds = empty;
+    for (const auto &v : mesh.vertex)
+      bounds.extend(vec3f(v));
+
+    ispc::Isosurfaces_setMesh(getIE(), model->getIE(), eMesh,
+                              numIsovalues, isovalues, volume->getIE(),
+                              mesh.index.size(),
+                              (ispc::vec3i*)mesh.index.data(),
+                              (ispc::vec3f*)meshNormal.data(),
+                              mesh.isovalueID.data());
+  }
+
+  void Isosurfaces::dependencyGotChanged(ManagedObject *object)
+  {
+    if (object == extractedVolume)
+      meshValid = false;
+  }
+
+  void Isosurfaces::setVolume(Volume *newVolume)
+  {
+    if (volume.ptr == newVolume)
+      return;
+    if (volume)
+      volume->unregisterListener(this);
+    volume = newVolume;
+    if (volume)
+      volume->registerListener(this);
+  }
+
+  void Isosurfaces::extractMesh()
+  {
+    const vec3i dimensions  = volume->getParam3i("dimensions", vec3i(0));
+    const vec3f gridOrigin  = volume->getParam3f("gridOrigin", vec3f(0.f));
+    const vec3f gridSpacing = volume->getParam3f("gridSpacing", vec3f(1.f));
+
+    // fetch the voxels slice by slice through the volume's sampling, so
+    // the layout of the voxels (shared, bricked, ...) does not matter;
+    // sample locations are exactly at the voxels, so no interpolation
+    // happens
+    const size_t sliceSize = size_t(dimensions.x) * dimensions.y;
+    std::vector<float> x(sliceSize), y(sliceSize);
+    for (size_t i = 0; i < sliceSize; i++) {
+      x[i] = gridOrigin.x + (i % dimensions.x) * gridSpacing.x;
+      y[i] = gridOrigin.y + (i / dimensions.x) * gridSpacing.y;
+    }
+    auto loadSlice = [&](size_t k, float *slice) {
+      std::vector<float> z(sliceSize, gridOrigin.z + k * gridSpacing.z);
+      volume->computeSamplesSoA(x.data(), y.data(), z.data(), sliceSize,
+                                slice);
+    };
+
+    mesh = IsosurfaceMesh();
+    extractIsosurfaces(loadSlice, dimensions, gridOrigin, gridSpacing,
+                       isovalues, numIsovalues, mesh);
+
+    // gradient normals, pointing the same way as the ones of the
+    // implicit isosurfaces; sampled in blocks, to keep the temporary
+    // SoA arrays small
+    const size_t numVertices = mesh.vertex.size();
+    const size_t blockSize = 16*1024;
+    meshNormal.resize(numVertices);
+    tasking::parallel_for(divRoundUp(numVertices, blockSize), [&](size_t b) {
+      const size_t begin = b * blockSize;
+      const size_t count = std::min(blockSize, numVertices - begin);
+      std::vector<float> p(3 * count), g(3 * count), value(count);
+      for (size_t i = 0; i < count; i++) {
+        p[i]             = mesh.vertex[begin + i].x;
+        p[count + i]     = mesh.vertex[begin + i].y;
+        p[2 * count + i] = mesh.vertex[begin + i].z;
+      }
+
+      volume->computeSamplesSoA(p.data(), p.data() + count,
+                                p.data() + 2 * count, count, value.data(),
+                                g.data(), g.data() + count,
+                                g.data() + 2 * count);
+
+      for (size_t i = 0; i < count; i++) {
+        const vec3f grad(g[i], g[count + i], g[2 * count + i]);
+        const float len2 = dot(grad, grad);
+        meshNormal[begin + i] = len2 > 0.f ? grad * rsqrt(len2) : vec3f(0.f);
+      }
+    });
   }
 
   OSP_REGISTER_GEOMETRY(Isosurfaces, isosurfaces);
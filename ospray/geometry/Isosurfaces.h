@@ -17,7 +17,10 @@
 #pragma once
 
 #include "Geometry.h"
+#include "IsosurfaceExtraction.h"
 #include "volume/Volume.h"
+// std
+#include <atomic>
 
 namespace ospray {
 
@@ -35,6 +38,7 @@ namespace ospray {
     <dl>
     <dt><li><code>Data<float> isovalues</code></dt><dd> Array of floats for all isovalues in this geometry.</dd>
     <dt><li><code>Volume  volume </code></dt><dd> volume specifies the volume to be isosurfaced. The color of the isosurface(s) will be mapped through the volume's transfer function.</dd>
+    <dt><li><code>int32   extract = 0</code></dt><dd> if set (and the volume is a structured volume), the isosurfaces get extracted as a triangle mesh (via marching cubes) when the geometry is committed, and are traced through embree instead of the volume.</dd>
     </dl>
 
     The functionality for this geometry is implemented via the
@@ -50,10 +54,11 @@ namespace ospray {
   struct OSPRAY_SDK_INTERFACE Isosurfaces : public Geometry
   {
     Isosurfaces();
-    virtual ~Isosurfaces() override = default;
+    virtual ~Isosurfaces() override;
 
     virtual std::string toString() const override;
     virtual void finalize(Model *model) override;
+    virtual void dependencyGotChanged(ManagedObject *object) override;
 
     // Data members //
 
@@ -62,6 +67,25 @@ namespace ospray {
 
     size_t numIsovalues;
     float *isovalues;
+
+    /*! explicitly extracted isosurfaces; empty unless 'extract' is set */
+    IsosurfaceMesh mesh;
+    std::vector<vec3f> meshNormal;
+
+   private:
+
+    /*! extract the isosurfaces of the (structured) volume into 'mesh',
+        with gradient normals in 'meshNormal' */
+    void extractMesh();
+
+    /*! listen for changes of 'volume' (instead of the previous one) */
+    void setVolume(Volume *newVolume);
+
+    /*! the volume and isovalues 'mesh' was extracted from; the mesh is
+        reused by later commits until either of them changes */
+    Volume *extractedVolume {nullptr};
+    std::vector<float> extractedIsovalues;
+    std::atomic<bool> meshValid {false};
   };
   /*! @} */
 
@@ -0,0 +1,406 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+// ospray
+#include "Particles.h"
+#include "common/Data.h"
+#include "common/Model.h"
+#include "ospcommon/tasking/parallel_for.h"
+// ispc-generated files
+#include "Particles_ispc.h"
+// std
+#include <algorithm>
+
+/*! subtrees with more particles than this get built in parallel */
+#define PARTICLES_PARALLEL_BUILD_THRESHOLD (64*1024)
+/*! LOD proxies of the upper levels of the BVH get built in parallel */
+#define PARTICLES_PARALLEL_PROXY_DEPTH 8
+
+namespace ospray {
+
+  static_assert(sizeof(Particles::Node) == 32,
+                "Particles::Node has to match ParticleNode in Particles.ispc");
+  static_assert(sizeof(Particles::Leaf) == 32 + 8*PARTICLES_LEAF_SIZE,
+                "Particles::Leaf has to match ParticleLeaf in Particles.ispc");
+
+  /*! quantize 'v' in [0,1] to 16 bits */
+  inline uint16 quantize16(float v)
+  {
+    return (uint16)clamp(v * 65535.f + .5f, 0.f, 65535.f);
+  }
+
+  /*! quantize 'v' in [0,1] to 8 bits */
+  inline uint8 quantize8(float v)
+  {
+    return (uint8)clamp(v * 255.f + .5f, 0.f, 255.f);
+  }
+
+  inline uint32 packColor(const vec4f &c)
+  {
+    return uint32(quantize8(c.x))
+        | (uint32(quantize8(c.y)) << 8)
+        | (uint32(quantize8(c.z)) << 16)
+        | (uint32(quantize8(c.w)) << 24);
+  }
+
+  /*! whether 'packColor()' can convert elements of type 'type' */
+  inline bool isColorType(OSPDataType type)
+  {
+    return type == OSP_UCHAR4 || type == OSP_FLOAT3
+        || type == OSP_FLOAT3A || type == OSP_FLOAT4;
+  }
+
+  /*! convert a single element of the 'color' data array to RGBA8; the
+      type of the array has been checked with 'isColorType()' */
+  inline uint32 packColor(const Data &colorData, int64 i)
+  {
+    vec4f c(1.f);
+    switch (colorData.type) {
+    case OSP_UCHAR4:
+      return ((const uint32 *)colorData.data)[i];
+    case OSP_FLOAT3:
+      (vec3f&)c = ((const vec3f *)colorData.data)[i];
+      break;
+    case OSP_FLOAT3A:
+      (vec3f&)c = (const vec3f&)((const vec4f *)colorData.data)[i];
+      break;
+    case OSP_FLOAT4:
+      c = ((const vec4f *)colorData.data)[i];
+      break;
+    default:
+      Assert2(false, "particle color type has to be checked in commit()");
+      break;
+    }
+    return packColor(c);
+  }
+
+  inline vec4f unpackColor(uint32 c)
+  {
+    return vec4f(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24)
+        * (1.f/255.f);
+  }
+
+  /*! accumulated particle data of a BVH subtree, used for its LOD proxy */
+  struct ParticleAggregate
+  {
+    vec3f weightedCenter {0.f};
+    float weight {0.f};
+    vec4f colorSum {0.f};
+    size_t count {0};
+
+    void add(const ParticleAggregate &other)
+    {
+      weightedCenter += other.weightedCenter;
+      weight         += other.weight;
+      colorSum       += other.colorSum;
+      count          += other.count;
+    }
+  };
+
+  Particles::Particles()
+  {
+    this->ispcEquivalent = ispc::Particles_create(this);
+  }
+
+  std::string Particles::toString() const
+  {
+    return "ospray::Particles";
+  }
+
+  inline vec3f Particles::particleCenter(int64 particleID) const
+  {
+    return *(const vec3f*)(positionPtr + particleID * positionStride);
+  }
+
+  inline float Particles::particleRadius(int64 particleID) const
+  {
+    return hasRadius ?
+        ((const vec4f*)positionPtr)[particleID].w : radius;
+  }
+
+  void Particles::buildLeaf(size_t nodeID, size_t begin, size_t end)
+  {
+    // all splits are multiples of the leaf size, so leaf IDs are implicit
+    const size_t leafID = begin / PARTICLES_LEAF_SIZE;
+    Leaf &l = leaf[leafID];
+
+    box3f centBounds = empty;
+    float maxRadius  = 0.f;
+    for (size_t i = begin; i < end; i++) {
+      centBounds.extend(particleCenter(particleID[i]));
+      maxRadius = std::max(maxRadius, particleRadius(particleID[i]));
+    }
+
+    const vec3f size  = centBounds.size();
+    l.lower           = centBounds.lower;
+    l.scale           = size * (1.f/65535.f);
+    l.radiusScale     = maxRadius * (1.f/65535.f);
+    l.numParticles    = end - begin;
+
+    const vec3f rcpSize(size.x > 0.f ? 1.f/size.x : 0.f,
+                        size.y > 0.f ? 1.f/size.y : 0.f,
+                        size.z > 0.f ? 1.f/size.z : 0.f);
+    const float rcpRadius = maxRadius > 0.f ? 1.f/maxRadius : 0.f;
+
+    // the bounds have to be computed from the _dequantized_ particles,
+    // which are what the ispc side actually intersects
+    box3f bounds = empty;
+    for (size_t i = begin; i < end; i++) {
+      const int slot = i - begin;
+      const vec3f p  = (particleCenter(particleID[i]) - l.lower) * rcpSize;
+      l.x[slot] = quantize16(p.x);
+      l.y[slot] = quantize16(p.y);
+      l.z[slot] = quantize16(p.z);
+      l.r[slot] = quantize16(particleRadius(particleID[i]) * rcpRadius);
+
+      const vec3f c = l.lower + vec3f(l.x[slot], l.y[slot], l.z[slot]) * l.scale;
+      const float r = l.radiusScale * l.r[slot];
+      bounds.extend(box3f(c - r, c + r));
+    }
+    for (int slot = end - begin; slot < PARTICLES_LEAF_SIZE; slot++)
+      l.x[slot] = l.y[slot] = l.z[slot] = l.r[slot] = 0;
+
+    if (!color.empty()) {
+      for (size_t i = begin; i < end; i++)
+        color[i] = packColor(*colorData, particleID[i]);
+    }
+
+    node[nodeID].lower = bounds.lower;
+    node[nodeID].upper = bounds.upper;
+    node[nodeID].ref   = (int64(leafID) << 1) | 1;
+  }
+
+  void Particles::buildRec(size_t nodeID, size_t begin, size_t end)
+  {
+    if (end - begin <= PARTICLES_LEAF_SIZE) {
+      buildLeaf(nodeID, begin, end);
+      return;
+    }
+
+    box3f centBounds = empty;
+    for (size_t i = begin; i < end; i++)
+      centBounds.extend(particleCenter(particleID[i]));
+    const size_t dim = arg_max(centBounds.size());
+
+    // split at the object median, rounded to a multiple of the leaf
+    // size: all leaves but the very last one are completely filled
+    const size_t numLeaves = divRoundUp(end - begin,
+                                        size_t(PARTICLES_LEAF_SIZE));
+    const size_t mid = begin + (numLeaves / 2) * PARTICLES_LEAF_SIZE;
+
+    std::nth_element(particleID.begin() + begin,
+                     particleID.begin() + mid,
+                     particleID.begin() + end,
+                     [&](int64 a, int64 b) {
+                       return particleCenter(a)[dim] < particleCenter(b)[dim];
+                     });
+
+    const size_t childID = numNodes.fetch_add(2);
+
+    if (end - begin > PARTICLES_PARALLEL_BUILD_THRESHOLD) {
+      tasking::parallel_for(2, [&](int childIndex) {
+        if (childIndex == 0)
+          buildRec(childID + 0, begin, mid);
+        else
+          buildRec(childID + 1, mid, end);
+      });
+    } else {
+      buildRec(childID + 0, begin, mid);
+      buildRec(childID + 1, mid, end);
+    }
+
+    node[nodeID].lower = min(node[childID].lower, node[childID + 1].lower);
+    node[nodeID].upper = max(node[childID].upper, node[childID + 1].upper);
+    node[nodeID].ref   = int64(childID) << 1;
+  }
+
+  ParticleAggregate Particles::buildProxyRec(size_t nodeID, int depth)
+  {
+    ParticleAggregate aggregate;
+    const Node &n = node[nodeID];
+
+    if (n.ref & 1) {
+      const size_t leafID = n.ref >> 1;
+      const Leaf &l = leaf[leafID];
+      for (int slot = 0; slot < l.numParticles; slot++) {
+        const vec3f c = l.lower + vec3f(l.x[slot], l.y[slot], l.z[slot]) * l.scale;
+        const float r = l.radiusScale * l.r[slot];
+        // weight by (projected) area, which is what a viewer sees of
+        // the particles from far away
+        aggregate.weightedCenter += c * (r*r);
+        aggregate.weight         += r*r;
+        if (!color.empty())
+          aggregate.colorSum += unpackColor(color[leafID * PARTICLES_LEAF_SIZE + slot]);
+        aggregate.count++;
+      }
+    } else {
+      const size_t childID = n.ref >> 1;
+      ParticleAggregate child[2];
+      if (depth < PARTICLES_PARALLEL_PROXY_DEPTH) {
+        tasking::parallel_for(2, [&](int childIndex) {
+          child[childIndex] = buildProxyRec(childID + childIndex, depth + 1);
+        });
+      } else {
+        child[0] = buildProxyRec(childID + 0, depth + 1);
+        child[1] = buildProxyRec(childID + 1, depth + 1);
+      }
+      aggregate = child[0];
+      aggregate.add(child[1]);
+    }
+
+    // a sphere of the particles' combined projected area, but never
+    // bigger than the node itself
+    Proxy &p = proxy[nodeID];
+    const vec3f size = n.upper - n.lower;
+    p.center = aggregate.weight > 0.f ?
+        aggregate.weightedCenter * (1.f/aggregate.weight) :
+        0.5f * (n.lower + n.upper);
+    p.radius = std::min(std::sqrt(aggregate.weight), 0.5f * length(size));
+
+    if (!color.empty()) {
+      const vec4f c = aggregate.colorSum * (1.f/aggregate.count);
+      color[numParticles + nodeID] = packColor(c);
+    }
+
+    return aggregate;
+  }
+
+  void Particles::buildProxies()
+  {
+    proxy.resize(node.size());
+    // proxy colors get appended to the particle colors, so the ispc
+    // side can address both through the same (64-bit) hit ID
+    if (!color.empty())
+      color.resize(numParticles + node.size());
+    buildProxyRec(0, 0);
+  }
+
+  void Particles::buildBVH()
+  {
+    const size_t numLeaves = divRoundUp(numParticles,
+                                        size_t(PARTICLES_LEAF_SIZE));
+
+    // a binary tree over 'numLeaves' leaves has at most 2*numLeaves-1 nodes
+    node.resize(numLeaves ? 2 * numLeaves - 1 : 1);
+    leaf.resize(numLeaves);
+    color.resize(colorData ? numParticles : 0);
+    particleID.resize(numParticles);
+
+    const size_t numBlocks = divRoundUp(numParticles,
+                                        size_t(PARTICLES_PARALLEL_BUILD_THRESHOLD));
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * PARTICLES_PARALLEL_BUILD_THRESHOLD;
+      const size_t end   = std::min(begin + PARTICLES_PARALLEL_BUILD_THRESHOLD,
+                                    numParticles);
+      for (size_t i = begin; i < end; i++)
+        particleID[i] = i;
+    });
+
+    if (numParticles == 0) {
+      node[0].lower = vec3f(pos_inf);
+      node[0].upper = vec3f(neg_inf);
+      node[0].ref   = 0;
+    } else {
+      numNodes = 1;
+      buildRec(0, 0, numParticles);
+      node.resize(numNodes);
+    }
+
+    // the permutation is only needed while building
+    particleID.clear();
+    particleID.shrink_to_fit();
+  }
+
+  void Particles::finalize(Model *model)
+  {
+    Geometry::finalize(model);
+
+    radius       = getParam1f("radius",0.01f);
+    materialID   = getParam1i("materialID",0);
+    lodThreshold = getParam1f("lodThreshold",0.f);
+    positionData = getParamData("positions");
+    colorData    = getParamData("color");
+
+    if (positionData.ptr == nullptr) {
+      throw std::runtime_error("#ospray:geometry/particles: no 'positions' "
+                               "data specified");
+    }
+
+    switch (positionData->type) {
+    case OSP_FLOAT3:
+      positionStride = sizeof(vec3f);
+      hasRadius      = false;
+      break;
+    case OSP_FLOAT3A:
+      positionStride = sizeof(vec4f);
+      hasRadius      = false;
+      break;
+    case OSP_FLOAT4:
+      positionStride = sizeof(vec4f);
+      hasRadius      = true;
+      break;
+    default:
+      throw std::runtime_error("#ospray:geometry/particles: 'positions' "
+                               "has to be of type OSP_FLOAT3, OSP_FLOAT3A, "
+                               "or OSP_FLOAT4");
+    }
+
+    positionPtr  = (const uint8*)positionData->data;
+    numParticles = positionData->numItems;
+
+    if (colorData && !isColorType(colorData->type)) {
+      postStatusMsg() << "#ospray:geometry/particles: 'color' has to be of "
+                      << "type OSP_UCHAR4, OSP_FLOAT3, OSP_FLOAT3A, or "
+                      << "OSP_FLOAT4, not " << stringForType(colorData->type)
+                      << "; ignoring it";
+      colorData = nullptr;
+    }
+
+    if (colorData && colorData->numItems < numParticles) {
+      throw std::runtime_error("#ospray:geometry/particles: 'color' has "
+                               "fewer elements than 'positions'");
+    }
+
+    postStatusMsg(2) << "#osp: creating 'particles' geometry, #particles = "
+                     << numParticles;
+
+    buildBVH();
+
+    proxy.clear();
+    if (lodThreshold > 0.f && numParticles > 0)
+      buildProxies();
+
+    bounds = box3f(node[0].lower, node[0].upper);
+
+    epsilon = std::log(radius);
+    if (epsilon < 0.f)
+      epsilon = -1.f/epsilon;
+
+    ispc::Particles_set(getIE(),model->getIE(),
+                        materialList ? ispcMaterialPtrs.data() : nullptr,
+                        node.data(),
+                        leaf.data(),
+                        proxy.empty() ? nullptr : proxy.data(),
+                        color.empty() ? nullptr : color.data(),
+                        numParticles,
+                        epsilon,
+                        lodThreshold,
+                        materialID);
+  }
+
+  OSP_REGISTER_GEOMETRY(Particles,particles);
+
+} // ::ospray
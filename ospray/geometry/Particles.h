@@ -0,0 +1,156 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "Geometry.h"
+// std
+#include <atomic>
+
+/*! number of particles stored (in SoA layout) per BVH leaf; has to
+    match the value used in Particles.ispc */
+#define PARTICLES_LEAF_SIZE 16
+
+namespace ospray {
+
+  struct ParticleAggregate;
+
+  /*! @{ \defgroup geometry_particles Particles ("particles")
+
+    \ingroup ospray_supported_geometries
+
+    \brief Geometry representing very large sets of spheres
+
+    Unlike the \ref geometry_spheres geometry, which hands every
+    sphere to embree as an individual user primitive, this geometry
+    builds its own compact BVH over the particles and registers only a
+    single primitive with embree. Particle positions (and radii) are
+    quantized to 16 bits relative to the bounds of their BVH leaf, and
+    each leaf stores up to PARTICLES_LEAF_SIZE particles in SoA layout
+    so that all particles of a leaf get intersected at once. Particle
+    counts are 64-bit; the hit particle is reported through
+    'ray.primID' (lower 32 bits) and 'ray.primID_hi64' (upper 32 bits),
+    and refers to the BVH leaf order of the particles (per-particle
+    attributes are reordered accordingly during the build).
+
+    Parameters:
+    <dl>
+    <dt><code>Data<vec3f|vec4f> positions</code></dt><dd>Particle centers. If the data type is OSP_FLOAT4, the 'w' component is used as per-particle radius.</dd>
+    <dt><code>float        radius = 0.01f</code></dt><dd>Radius common to all particles if no per-particle radius is given</dd>
+    <dt><code>int32        materialID = 0</code></dt><dd>Material ID common to all particles</dd>
+    <dt><code>Data<vec3f|vec4f|vec4uc> color</code></dt><dd>Optional per-particle color (stored as RGBA8 internally)</dd>
+    <dt><code>float        lodThreshold = 0.f</code></dt><dd>Angular size (in radians) below which a BVH subtree gets replaced by a single proxy sphere of its particles' combined area and average color. Typically set to the angle covered by one pixel, i.e. 'fovy/imageHeight' of the camera (in radians); 0 disables level-of-detail</dd>
+    </dl>
+
+    The functionality for this geometry is implemented via the
+    \ref ospray::Particles class.
+  */
+
+  /*! \brief A geometry for (very) large sets of particles
+
+    Implements the \ref geometry_particles geometry
+  */
+  struct OSPRAY_SDK_INTERFACE Particles : public Geometry
+  {
+    /*! a node of the particle BVH; nodes always come in pairs, and
+        'ref' either points to the node pair of the children, or to a
+        leaf (lowest bit set) */
+    struct Node
+    {
+      vec3f lower;
+      vec3f upper;
+      int64 ref;
+    };
+
+    /*! a BVH leaf, storing PARTICLES_LEAF_SIZE quantized particles in
+        SoA layout. leaf 'i' stores the (reordered) particles
+        [i*PARTICLES_LEAF_SIZE, (i+1)*PARTICLES_LEAF_SIZE) */
+    struct Leaf
+    {
+      vec3f lower;       //!< origin of the quantization grid
+      float radiusScale; //!< dequantization scale for radii
+      vec3f scale;       //!< dequantization scale for positions
+      int32 numParticles;
+      uint16 x[PARTICLES_LEAF_SIZE];
+      uint16 y[PARTICLES_LEAF_SIZE];
+      uint16 z[PARTICLES_LEAF_SIZE];
+      uint16 r[PARTICLES_LEAF_SIZE];
+    };
+
+    /*! aggregate proxy sphere of a BVH subtree, used for level-of-detail */
+    struct Proxy
+    {
+      vec3f center;
+      float radius;
+    };
+
+    Particles();
+
+    virtual std::string toString() const override;
+    virtual void finalize(Model *model) override;
+
+   private:
+
+    /*! build the BVH (and the leaf-ordered permutation) over the
+        current input data */
+    void buildBVH();
+
+    void buildRec(size_t nodeID, size_t begin, size_t end);
+
+    void buildLeaf(size_t nodeID, size_t begin, size_t end);
+
+    /*! build the LOD proxy spheres (one per BVH node) */
+    void buildProxies();
+
+    ParticleAggregate buildProxyRec(size_t nodeID, int depth);
+
+    vec3f particleCenter(int64 particleID) const;
+    float particleRadius(int64 particleID) const;
+
+    // Data members //
+
+    /*! default radius, if no per-particle radius was specified. */
+    float radius;
+    int32 materialID;
+    float epsilon;
+    float lodThreshold;
+
+    size_t numParticles {0};
+
+    Ref<Data> positionData;
+    Ref<Data> colorData;
+
+    const uint8 *positionPtr {nullptr};
+    size_t positionStride {0};
+    bool hasRadius {false};
+
+    /*! node array; node 0 is the root (a single node, not a pair) */
+    std::vector<Node> node;
+    /*! number of nodes allocated in 'node' so far, during the build */
+    std::atomic<size_t> numNodes {0};
+    std::vector<Leaf> leaf;
+    /*! LOD proxies, one per node; empty if LOD is disabled */
+    std::vector<Proxy> proxy;
+    /*! maps each (leaf-ordered) particle back to its input index;
+        only needed during the build */
+    std::vector<int64> particleID;
+    /*! per-particle RGBA8 color, in leaf order (followed by one color
+        per node if LOD is enabled) */
+    std::vector<uint32> color;
+  };
+  /*! @} */
+
+} // ::ospray
@@ -20,9 +20,13 @@
 #include "StreamLines.h"
 #include "common/Data.h"
 #include "common/Model.h"
+#include "ospcommon/tasking/parallel_for.h"
 #include "ospcommon/utility/DataView.h"
 // ispc-generated files
 #include "StreamLines_ispc.h"
+// std
+#include <algorithm>
+#include <limits>
 
 namespace ospray {
 
@@ -80,22 +84,96 @@ namespace ospray {
                      << "#segments=" << numSegments << ", "
                      << "as curve: " << useCurve;
 
+    computeBounds(radius);
+
+    if (useCurve) {
+      buildSmoothCurves(radius);
+      ispc::StreamLines_setCurve(getIE(),model->getIE(),
+          (const ispc::vec3fa*)vertexCurve.data(), vertexCurve.size(),
+          indexCurve.data(), numSegments, index, color);
+    } else if (buildTubes(globalRadius)) {
+      ispc::StreamLines_setTubes(getIE(),model->getIE(), globalRadius,
+          (const ispc::vec3fa*)vertex, numVertices, index, numSegments, color,
+          (const ispc::vec3fa*)vertexCurve.data(), vertexCurve.size(),
+          indexCurve.data(), indexCurve.size(), jointVertex.data());
+    } else
+      ispc::StreamLines_set(getIE(),model->getIE(), globalRadius,
+          (const ispc::vec3fa*)vertex, numVertices, index, numSegments, color);
+  }
+
+  void StreamLines::computeBounds(const utility::DataView<const float> &radius)
+  {
+    const size_t numBlocks = divRoundUp(numSegments, segmentsPerBlock);
+    std::vector<box3f> blockBounds(numBlocks);
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * segmentsPerBlock;
+      const size_t end = std::min(begin + segmentsPerBlock, numSegments);
+      box3f blockBox = empty;
+      // XXX curves may actually have a larger bounding box due to swinging
+      for (size_t i = begin; i < end; i++) {
+        const uint32 idx = index[i];
+        blockBox.extend(vertex[idx] - radius[idx]);
+        blockBox.extend(vertex[idx] + radius[idx]);
+        blockBox.extend(vertex[idx+1] - radius[idx+1]);
+        blockBox.extend(vertex[idx+1] + radius[idx+1]);
+      }
+      blockBounds[blockID] = blockBox;
+    });
+
     bounds = empty;
-    // XXX curves may actually have a larger bounding box due to swinging
-    for (uint32_t i = 0; i < numSegments; i++) {
-      const uint32 idx = index[i];
-      bounds.extend(vertex[idx] - radius[idx]);
-      bounds.extend(vertex[idx] + radius[idx]);
-      bounds.extend(vertex[idx+1] - radius[idx+1]);
-      bounds.extend(vertex[idx+1] + radius[idx+1]);
+    for (const auto &blockBox : blockBounds)
+      bounds.extend(blockBox);
+  }
+
+  /*! turns per-block counts into (exclusive) per-block offsets,
+      returns the total count */
+  static size_t exclusiveScan(std::vector<size_t> &blockCount)
+  {
+    size_t sum = 0;
+    for (auto &count : blockCount) {
+      const size_t c = count;
+      count = sum;
+      sum += c;
     }
+    return sum;
+  }
 
-    if (useCurve) {
-      vertexCurve.clear();
-      indexCurve.resize(numSegments);
-      bool middleSegment = false;
-      vec3f tangent;
-      for (uint32_t i = 0; i < numSegments; i++) {
+  void StreamLines::buildSmoothCurves(const utility::DataView<const float> &radius)
+  {
+    /* position of the inner control point (towards 'vertex[idx+1]') of
+       the joint between segments (idx,idx+1) and (idx+1,idx+2), which
+       is placed at 'vertex[idx+1] - r*delta' for the first and at
+       'vertex[idx+1] + (1-r)*delta' for the second segment */
+    auto joint = [&](uint32 idx, vec3f &delta, float &r) {
+      const vec3f start = vertex[idx];
+      const vec3f end = vertex[idx+1];
+      const vec3f next = vertex[idx+2];
+      delta = (1.f/3)*(next - start);
+      const float a = length(start - end);
+      const float b = length(next - end);
+      r = a/(a + b);
+    };
+
+    // count the control points: three per segment, plus the end cap
+    const size_t numBlocks = divRoundUp(numSegments, segmentsPerBlock);
+    std::vector<size_t> blockOffset(numBlocks);
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * segmentsPerBlock;
+      const size_t end = std::min(begin + segmentsPerBlock, numSegments);
+      size_t count = 0;
+      for (size_t i = begin; i < end; i++)
+        count += lineEndsAt(i) ? 4 : 3;
+      blockOffset[blockID] = count;
+    });
+
+    vertexCurve.resize(exclusiveScan(blockOffset));
+    indexCurve.resize(numSegments);
+
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * segmentsPerBlock;
+      const size_t end = std::min(begin + segmentsPerBlock, numSegments);
+      size_t ofs = blockOffset[blockID];
+      for (size_t i = begin; i < end; i++) {
         const uint32 idx = index[i];
         const vec3f start = vertex[idx];
         const vec3f end = vertex[idx+1];
@@ -103,38 +181,147 @@ namespace ospray {
         const float startRadius = radius[idx];
         const float endRadius = radius[idx+1];
 
-        indexCurve[i] = vertexCurve.size();
-        if (middleSegment) {
-          vertexCurve.push_back(vec4f(start, startRadius));
-          vertexCurve.push_back(vec4f(start + tangent,
-                lerp(1.f/3, startRadius, endRadius)));
-        } else { // start new curve
-          const vec3f cap =  lerp(1.f+startRadius/lengthSegment, end, start);
-          vertexCurve.push_back(vec4f(cap, 0.f));
-          vertexCurve.push_back(vec4f(start, startRadius));
+        indexCurve[i] = ofs;
+        if (lineStartsAt(i)) {
+          const vec3f cap = lerp(1.f+startRadius/lengthSegment, end, start);
+          vertexCurve[ofs++] = vec4f(cap, 0.f);
+          vertexCurve[ofs++] = vec4f(start, startRadius);
+        } else {
+          vec3f delta;
+          float r;
+          joint(idx-1, delta, r);
+          vertexCurve[ofs++] = vec4f(start, startRadius);
+          vertexCurve[ofs++] = vec4f(start + (1.f-r)*delta,
+              lerp(1.f/3, startRadius, endRadius));
         }
 
-        middleSegment = i+1 < numSegments && index[i+1] == idx+1;
-        if (middleSegment) {
-          const vec3f next = vertex[idx+2];
-          const vec3f delta = (1.f/3)*(next - start);
-          const float b = length(next - end);
-          const float r = lengthSegment/(lengthSegment + b);
-          vertexCurve.push_back(vec4f(end - r*delta,
-                lerp(2.f/3, startRadius, endRadius)));
-          tangent = (1.f-r)*delta;
-        } else { // end curve
-          vertexCurve.push_back(vec4f(end, endRadius));
+        if (lineEndsAt(i)) {
+          vertexCurve[ofs++] = vec4f(end, endRadius);
           const vec3f cap = lerp(1.f+endRadius/lengthSegment, start, end);
-          vertexCurve.push_back(vec4f(cap, 0.f));
+          vertexCurve[ofs++] = vec4f(cap, 0.f);
+        } else {
+          vec3f delta;
+          float r;
+          joint(idx, delta, r);
+          vertexCurve[ofs++] = vec4f(end - r*delta,
+              lerp(2.f/3, startRadius, endRadius));
         }
       }
-      ispc::StreamLines_setCurve(getIE(),model->getIE(),
-          (const ispc::vec3fa*)vertexCurve.data(), vertexCurve.size(),
-          indexCurve.data(), numSegments, index, color);
-    } else
-      ispc::StreamLines_set(getIE(),model->getIE(), globalRadius,
-          (const ispc::vec3fa*)vertex, numVertices, index, numSegments, color);
+    });
+  }
+
+  static inline vec3f segmentDirection(const vec3f &a, const vec3f &b)
+  {
+    const vec3f d = b - a;
+    const float len = length(d);
+    return len > 0.f ? d * (1.f/len) : vec3f(0.f, 0.f, 1.f);
+  }
+
+  /*! a rounded joint (or end cap) of tubes of 'radius' at 'center',
+      symmetric to 'axis'. its profile (position along 'axis' and
+      radius) is a cubic Bezier curve whose points are within 0.5% of
+      'radius' of the circle of the sphere; as the sphere gets steep
+      towards the poles, the radius at a given position along 'axis'
+      still is off by up to 3% of 'radius' there */
+  static inline void writeJoint(vec4f *v, const vec3f &center,
+                                const vec3f &axis, float radius)
+  {
+    v[0] = vec4f(center - radius*axis, 0.f);
+    v[1] = vec4f(center - (0.94f*radius)*axis, 1.328f*radius);
+    v[2] = vec4f(center + (0.94f*radius)*axis, 1.328f*radius);
+    v[3] = vec4f(center + radius*axis, 0.f);
+  }
+
+  bool StreamLines::buildTubes(float radius)
+  {
+    /* tubes meeting at an angle of less than ~0.8 degrees leave no
+       visible gap and need no joint */
+    const float maxJointCos = 0.9999f;
+
+    auto direction = [&](size_t i) {
+      return segmentDirection(vertex[index[i]], vertex[index[i]+1]);
+    };
+    auto needsJointAtEnd = [&](size_t i) {
+      return lineEndsAt(i) || dot(direction(i), direction(i+1)) < maxJointCos;
+    };
+
+    /* count the control points of the tubes (three per segment, the
+       first one is shared with the previous segment of the line) and
+       the number of joints (at line starts, line ends and bends) */
+    const size_t numBlocks = divRoundUp(numSegments, segmentsPerBlock);
+    std::vector<size_t> blockTubeOffset(numBlocks);
+    std::vector<size_t> blockJointOffset(numBlocks);
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * segmentsPerBlock;
+      const size_t end = std::min(begin + segmentsPerBlock, numSegments);
+      size_t tubeCount = 0;
+      size_t jointCount = 0;
+      for (size_t i = begin; i < end; i++) {
+        const bool start = lineStartsAt(i);
+        tubeCount += start ? 4 : 3;
+        jointCount += start + needsJointAtEnd(i);
+      }
+      blockTubeOffset[blockID] = tubeCount;
+      blockJointOffset[blockID] = jointCount;
+    });
+
+    const size_t numTubeVertices = exclusiveScan(blockTubeOffset);
+    const size_t numJoints = exclusiveScan(blockJointOffset);
+
+    // embree addresses curves and their control points with 32 bits
+    const size_t maxItems = std::numeric_limits<int32>::max();
+    if (numTubeVertices + 4*numJoints > maxItems
+        || numSegments + numJoints > maxItems) {
+      vertexCurve = std::vector<vec4f>();
+      indexCurve = std::vector<uint32>();
+      jointVertex = std::vector<uint32>();
+      return false;
+    }
+
+    vertexCurve.resize(numTubeVertices + 4*numJoints);
+    indexCurve.resize(numSegments + numJoints);
+    jointVertex.resize(numJoints);
+
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * segmentsPerBlock;
+      const size_t end = std::min(begin + segmentsPerBlock, numSegments);
+      size_t tubeOfs = blockTubeOffset[blockID];
+      size_t jointOfs = blockJointOffset[blockID];
+
+      auto addJoint = [&](uint32 idx, const vec3f &axis) {
+        const size_t ofs = numTubeVertices + 4*jointOfs;
+        writeJoint(&vertexCurve[ofs], vertex[idx], axis, radius);
+        indexCurve[numSegments + jointOfs] = ofs;
+        jointVertex[jointOfs++] = idx;
+      };
+
+      for (size_t i = begin; i < end; i++) {
+        const uint32 idx = index[i];
+        const vec3f v0 = vertex[idx];
+        const vec3f v1 = vertex[idx+1];
+        const vec3f dir = segmentDirection(v0, v1);
+
+        if (lineStartsAt(i)) {
+          indexCurve[i] = tubeOfs;
+          vertexCurve[tubeOfs++] = vec4f(v0, radius);
+          addJoint(idx, dir);
+        } else
+          indexCurve[i] = tubeOfs - 1;
+        vertexCurve[tubeOfs++] = vec4f(lerp(1.f/3, v0, v1), radius);
+        vertexCurve[tubeOfs++] = vec4f(lerp(2.f/3, v0, v1), radius);
+        vertexCurve[tubeOfs++] = vec4f(v1, radius);
+
+        if (lineEndsAt(i))
+          addJoint(idx+1, dir);
+        else {
+          const vec3f next = direction(i+1);
+          if (dot(dir, next) < maxJointCos)
+            addJoint(idx+1, segmentDirection(vec3f(0.f), dir + next));
+        }
+      }
+    });
+
+    return true;
   }
 
   OSP_REGISTER_GEOMETRY(StreamLines,streamlines);
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "Geometry.h"
+#include "ospcommon/utility/DataView.h"
 
 namespace ospray {
 
@@ -67,6 +68,26 @@ namespace ospray {
     <dt><li><code>Data<vec3fa> color</code></dt><dd> Array of vertex colors corresponding to the vertices in this geometry.</dd>
     </dl>
 
+    All stream lines are handed to embree as native curves: with
+    per-vertex radii or if "smooth" is set, the vertices get
+    interpolated by Bezier curves; otherwise each segment becomes a
+    straight curve (i.e., a cylinder), with an additional rounded
+    joint curve at the ends of each stream line and wherever adjacent
+    segments meet at an angle. The curves are built in parallel,
+    directly into pre-sized arrays. Only if the curves cannot be
+    addressed with 32 bits the cylinders and spheres are intersected
+    via a user geometry.
+
+    The joints only approximate spheres: their surface is within 0.5%
+    of the radius of a sphere's, but their radius at a given position
+    along the segment is off by up to 3% of the radius near the poles.
+
+    The curves are kept in addition to the application's vertices:
+    each straight segment takes 52 bytes (three vec4f control points
+    and an index), each joint 72 bytes, thus about 120 bytes per segment
+    for stream lines that bend at every vertex, or 6 GB for 50M such
+    segments. Smooth curves take about 52 bytes per segment.
+
     The functionality for this geometry is implemented via the
     \ref ospray::StreamLines class.
 
@@ -86,6 +107,30 @@ namespace ospray {
     virtual std::string toString() const override;
     virtual void finalize(Model *model) override;
 
+   private:
+
+    /*! number of segments processed per task when building curves */
+    static constexpr size_t segmentsPerBlock = 4*1024;
+
+    bool lineStartsAt(size_t i) const
+    { return i == 0 || index[i-1]+1 != index[i]; }
+
+    bool lineEndsAt(size_t i) const
+    { return i+1 == numSegments || index[i+1] != index[i]+1; }
+
+    void computeBounds(const utility::DataView<const float> &radius);
+
+    /*! convert the segments to Bezier curves smoothly interpolating
+        the vertices, with a cap at both ends of each stream line */
+    void buildSmoothCurves(const utility::DataView<const float> &radius);
+
+    /*! convert the segments to straight curves of constant 'radius',
+        followed by one rounded joint curve at each line end and bend;
+        returns false if there are too many curves for embree */
+    bool buildTubes(float radius);
+
+   public:
+
     // Data members //
 
     Ref<Data> vertexData; //!< refcounted data array for vertex data
@@ -99,6 +144,8 @@ namespace ospray {
     size_t        numSegments {0};
     std::vector<vec4f> vertexCurve;
     std::vector<uint32> indexCurve;
+    /*! for each joint curve (of the tubes) the vertex it is centered at */
+    std::vector<uint32> jointVertex;
   };
   /*! @} */
 
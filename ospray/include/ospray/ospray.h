@@ -682,6 +682,29 @@ extern "C" {
                                         const size_t count);
 #endif
 
+  /*! \brief Samples the given volume at a batch of world-space
+    coordinates, writing into application-owned memory.
+
+    The 'count' coordinates are given in SoA layout, i.e., as three
+    separate arrays 'x', 'y' and 'z'. The sampled values are written
+    to 'results', which must hold 'count' floats. If 'gradientX',
+    'gradientY' and 'gradientZ' are not NULL, they receive the
+    components of the volume gradient at each coordinate as well.
+
+    Unlike ospSampleVolume, samples are computed in parallel and no
+    memory is allocated by OSPRay, so this is the function to use for
+    large numbers of samples.
+  */
+  OSPRAY_INTERFACE void ospSampleVolumeSoA(OSPVolume,
+                                           const float *x,
+                                           const float *y,
+                                           const float *z,
+                                           size_t count,
+                                           float *results,
+                                           float *gradientX OSP_DEFAULT_VAL(=NULL),
+                                           float *gradientY OSP_DEFAULT_VAL(=NULL),
+                                           float *gradientZ OSP_DEFAULT_VAL(=NULL));
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -46,6 +46,15 @@ public:
                     const ospcommon::vec3f *worldCoordinates,
                     size_t count) const;
   std::vector<float> sampleVolume(const std::vector<ospcommon::vec3f> &points) const;
+
+  void sampleVolumeSoA(const float *x,
+                       const float *y,
+                       const float *z,
+                       size_t count,
+                       float *results,
+                       float *gradientX = nullptr,
+                       float *gradientY = nullptr,
+                       float *gradientZ = nullptr) const;
 };
 
 // Inlined function definitions ///////////////////////////////////////////////
@@ -106,5 +115,18 @@ Volume::sampleVolume(const std::vector<ospcommon::vec3f> &points) const
   return retval;
 }
 
+inline void Volume::sampleVolumeSoA(const float *x,
+                                    const float *y,
+                                    const float *z,
+                                    size_t count,
+                                    float *results,
+                                    float *gradientX,
+                                    float *gradientY,
+                                    float *gradientZ) const
+{
+  ospSampleVolumeSoA(handle(), x, y, z, count, results,
+                     gradientX, gradientY, gradientZ);
+}
+
 }// namespace cpp
 }// namespace ospray
@@ -18,6 +18,9 @@
 #include "LoadBalancer.h"
 #include "Renderer.h"
 #include "ospcommon/tasking/parallel_for.h"
+// std
+#include <algorithm>
+#include <atomic>
 
 namespace ospray {
 
@@ -31,36 +34,128 @@ namespace ospray {
     Assert(renderer);
     Assert(fb);
 
+    const double startTime = getSysTime();
     void *perFrameData = renderer->beginFrame(fb);
 
-    tasking::parallel_for(fb->getTotalTiles(), [&](int taskIndex) {
-      const size_t numTiles_x = fb->getNumTiles().x;
-      const size_t tile_y = taskIndex / numTiles_x;
-      const size_t tile_x = taskIndex - tile_y*numTiles_x;
-      const vec2i tileID(tile_x, tile_y);
+    auto renderTile = [&](const vec2i &tileID) {
       const int32 accumID = fb->accumID(tileID);
-
-      if (fb->tileError(tileID) <= renderer->errorThreshold)
-        return;
+      const int32 pixelsPerSample =
+          renderer->pixelsPerSample(fb, tileID, accumID);
 
 #define MAX_TILE_SIZE 128
 #if TILE_SIZE > MAX_TILE_SIZE
-      auto tilePtr = make_unique<Tile>(tileID, fb->size, accumID);
-      auto &tile   = *tilePtr;
+      auto *tilePtr = fb->frameArena.create<Tile>(tileID, fb->size,
+                                                 accumID, pixelsPerSample);
+      auto &tile    = *tilePtr;
 #else
-      Tile __aligned(64) tile(tileID, fb->size, accumID);
+      Tile __aligned(64) tile(tileID, fb->size, accumID, pixelsPerSample);
 #endif
 
-      tasking::parallel_for(numJobs(renderer->spp, accumID), [&](size_t tIdx) {
+      tasking::parallel_for(numJobs(tile), [&](size_t tIdx) {
         renderer->renderTile(perFrameData, tile, tIdx);
       });
 
       fb->setTile(tile);
-    });
+
+#if TILE_SIZE > MAX_TILE_SIZE
+      fb->frameArena.destroy(tilePtr);
+#endif
+    };
+
+    if (renderer->frameBudget > 0.f) {
+      renderTilesInBudget(renderer, fb, startTime, renderTile);
+    } else {
+      tasking::parallel_for(fb->getTotalTiles(), [&](int taskIndex) {
+        const size_t numTiles_x = fb->getNumTiles().x;
+        const size_t tile_y = taskIndex / numTiles_x;
+        const size_t tile_x = taskIndex - tile_y*numTiles_x;
+        const vec2i tileID(tile_x, tile_y);
+
+        if (fb->tileError(tileID) <= renderer->errorThreshold)
+          return;
+
+        renderTile(tileID);
+      });
+    }
 
     renderer->endFrame(perFrameData,channelFlags);
 
-    return fb->endFrame(renderer->errorThreshold);
+    const float error = fb->endFrame(renderer->errorThreshold);
+    fb->frameArena.reset();
+
+    return error;
+  }
+
+  template <typename RenderTile>
+  void LocalTiledLoadBalancer::renderTilesInBudget(Renderer *renderer,
+                                                   FrameBuffer *fb,
+                                                   double startTime,
+                                                   const RenderTile &renderTile)
+  {
+    const int numTiles = fb->getTotalTiles();
+    const int numTiles_x = fb->getNumTiles().x;
+    auto &state = fb->budgetState;
+    if (state.tileLastFrame.size() != size_t(numTiles))
+      state.tileLastFrame.assign(numTiles, -1);
+    state.frameID++;
+
+    // highest error first, then the tiles that have not been rendered
+    // for the longest time (i.e., the ones the last frames left out)
+    struct TilePriority
+    {
+      float error;
+      int32 lastFrame;
+      int   index;
+    };
+
+    std::vector<TilePriority> order;
+    order.reserve(numTiles);
+    for (int i = 0; i < numTiles; i++) {
+      const vec2i tileID(i % numTiles_x, i / numTiles_x);
+      const float error = fb->tileError(tileID);
+      if (error > renderer->errorThreshold)
+        order.push_back({error, state.tileLastFrame[i], i});
+    }
+
+    std::sort(order.begin(), order.end(),
+              [](const TilePriority &a, const TilePriority &b) {
+                if (a.error != b.error)
+                  return a.error > b.error;
+                if (a.lastFrame != b.lastFrame)
+                  return a.lastFrame < b.lastFrame;
+                return a.index < b.index;
+              });
+
+    // tiles get started strictly in order of priority, and no tile
+    // gets started that is expected to finish after the deadline;
+    // the first one always gets rendered so that every frame makes
+    // progress, no matter how heavy the view is
+    const double deadline = startTime + renderer->frameBudget;
+    const double expectedTileTime = state.tileTime;
+    std::atomic<size_t> nextTile {0};
+    std::atomic<int64> renderTimeUs {0};
+    std::atomic<int>   numRendered {0};
+
+    tasking::parallel_for(order.size(), [&](size_t) {
+      const size_t i = nextTile++;
+      const double tileStart = getSysTime();
+      if (i > 0 && tileStart + expectedTileTime > deadline)
+        return;
+
+      const int index = order[i].index;
+      renderTile(vec2i(index % numTiles_x, index / numTiles_x));
+      state.tileLastFrame[index] = state.frameID;
+
+      renderTimeUs += int64((getSysTime() - tileStart) * 1e6);
+      numRendered++;
+    });
+
+    if (numRendered > 0) {
+      const double frameTileTime = renderTimeUs * 1e-6 / numRendered;
+      state.tileTime = state.tileTime > 0.0
+                       ? 0.5 * (state.tileTime + frameTileTime)
+                       : frameTileTime;
+    }
   }
 
   std::string LocalTiledLoadBalancer::toString() const
@@ -34,11 +34,10 @@ namespace ospray {
                               FrameBuffer *fb,
                               const uint32 channelFlags) = 0;
 
-    static size_t numJobs(const int spp, int accumID)
+    static size_t numJobs(const Tile &tile)
     {
-      const int blocks = (accumID > 0 || spp > 0) ? 1 :
-        std::min(1 << -2 * spp, TILE_SIZE*TILE_SIZE);
-      return divRoundUp((TILE_SIZE*TILE_SIZE)/RENDERTILE_PIXELS_PER_JOB, blocks);
+      return divRoundUp((TILE_SIZE*TILE_SIZE)/RENDERTILE_PIXELS_PER_JOB,
+                        int(tile.pixelsPerSample));
     }
   };
 
@@ -54,6 +53,16 @@ namespace ospray {
                       const uint32 channelFlags) override;
 
     std::string toString() const override;
+
+  private:
+
+    /*! render as many tiles as fit into the renderer's 'frameBudget',
+        in order of priority */
+    template <typename RenderTile>
+    void renderTilesInBudget(Renderer *renderer,
+                             FrameBuffer *fb,
+                             double startTime,
+                             const RenderTile &renderTile);
   };
 
 } // ::ospray
@@ -37,6 +37,11 @@ namespace ospray {
     const int32 maxDepth = getParam1i("maxDepth", 20);
     const float minContribution = getParam1f("minContribution", 0.001f);
     errorThreshold = getParam1f("varianceThreshold", 0.f);
+    frameBudget = getParam1f("frameBudgetMs", 0.f) * 1e-3f;
+    foveaCenter = getParam2f("foveaCenter", vec2f(0.5f));
+    foveaRadius = getParam1f("foveaRadius", 0.f);
+    importanceMap = (Texture2D*)getParamObject("importanceMap", nullptr);
+    maxSubsampling = getParam1i("maxSubsampling", 3);
     maxDepthTexture = (Texture2D*)getParamObject("maxDepthTexture", nullptr);
     model = (Model*)getParamObject("model", getParamObject("world"));
 
@@ -49,6 +54,14 @@ namespace ospray {
       }
     }
 
+    if (importanceMap && importanceMap->type != OSP_TEXTURE_R8
+        && importanceMap->type != OSP_TEXTURE_R32F) {
+      static WarnOnce warning("importanceMap provided to the renderer needs "
+                              "to be of type OSP_TEXTURE_R8 or "
+                              "OSP_TEXTURE_R32F, ignoring it");
+      importanceMap = nullptr;
+    }
+
     vec3f bgColor3 = getParam3f("bgColor", vec3f(getParam1f("bgColor", 0.f)));
     bgColor = getParam4f("bgColor", vec4f(bgColor3, 0.f));
 
@@ -101,6 +114,48 @@ namespace ospray {
     return TiledLoadBalancer::instance->renderFrame(this,fb,channelFlags);
   }
 
+  int32 Renderer::pixelsPerSample(const FrameBuffer *fb,
+                                  const vec2i &tileID,
+                                  const int32 accumID) const
+  {
+    int level = 0;
+    if (accumID <= 0 && spp < 0)
+      level = -spp;
+
+    if (importanceMap || foveaRadius > 0.f) {
+      // importance at the tile center
+      const vec2f center = (vec2f(tileID) + 0.5f) * float(TILE_SIZE)
+                           / vec2f(fb->size);
+      float importance = 1.f;
+      if (importanceMap) {
+        const vec2i size = importanceMap->size;
+        const vec2i texel = clamp(vec2i(center * vec2f(size)),
+                                  vec2i(0), size - 1);
+        const size_t idx = texel.y * size_t(size.x) + texel.x;
+        importance = importanceMap->type == OSP_TEXTURE_R8
+                     ? ((const uint8*)importanceMap->data)[idx] / 255.f
+                     : ((const float*)importanceMap->data)[idx];
+      } else {
+        // distance in units of the image height
+        const float aspect = fb->size.x / float(fb->size.y);
+        const vec2f d = (center - foveaCenter) * vec2f(aspect, 1.f);
+        const float dist = length(d);
+        if (dist > foveaRadius)
+          importance = foveaRadius / dist;
+      }
+
+      // each level halves the resolution
+      const int foveaLevel = importance > 0.f
+                             ? int(std::floor(-std::log2(importance)))
+                             : maxSubsampling;
+      level = std::max(level, std::min(foveaLevel, maxSubsampling));
+    }
+
+    return level > 0 ? std::min(1 << 2 * std::min(level, 15),
+                                TILE_SIZE*TILE_SIZE)
+                     : 1;
+  }
+
   OSPPickResult Renderer::pick(const vec2f &screenPos)
   {
     assert(getIE());
@@ -79,6 +79,13 @@ namespace ospray {
 
     virtual OSPPickResult pick(const vec2f &screenPos);
 
+    /*! number of pixels sharing one sample in the given tile (see
+        Tile::pixelsPerSample), from the subsampling of the first frame
+        (negative 'spp') and from foveation */
+    int32 pixelsPerSample(const FrameBuffer *fb,
+                          const vec2i &tileID,
+                          const int32 accumID) const;
+
     Model *model {nullptr};
     FrameBuffer *currentFB {nullptr};
 
@@ -94,6 +101,22 @@ namespace ospray {
     /*! adaptive accumulation: variance-based error to reach */
     float errorThreshold {0.f};
 
+    /*! time-budgeted rendering: seconds a frame may take (0 means
+        unlimited); tiles that did not fit get rendered in later frames */
+    float frameBudget {0.f};
+
+    /*! foveated rendering: screen position of the fovea, and its
+        radius (relative to the image height, 0 disables foveation);
+        outside, the resolution falls off with the distance */
+    vec2f foveaCenter {0.5f};
+    float foveaRadius {0.f};
+    /*! foveated rendering: optional map of the importance [0..1] of
+        each image region, used instead of the fovea */
+    Ref<Texture2D> importanceMap;
+    /*! foveated rendering: coarsest subsampling level, level 'l'
+        renders one sample per 2^l x 2^l pixels */
+    int32 maxSubsampling {3};
+
     /*! \brief the background color */
     vec4f bgColor {0.f};
 
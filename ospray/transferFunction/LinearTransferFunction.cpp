@@ -16,6 +16,8 @@
 
 #include "transferFunction/LinearTransferFunction.h"
 #include "LinearTransferFunction_ispc.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
 
 namespace ospray {
 
@@ -32,8 +34,9 @@ namespace ospray {
     // Retrieve the color and opacity values.
     colorValues   = getParamData("colors", nullptr);
     opacityValues = getParamData("opacities", nullptr);
+    const bool preIntegration = getParam1i("preIntegration", 0);
     ispc::LinearTransferFunction_setPreIntegration(ispcEquivalent,
-                                               getParam1i("preIntegration", 0));
+                                                   preIntegration);
 
     // Set the color values.
     if (colorValues) {
@@ -49,8 +52,8 @@ namespace ospray {
                                                     (float *)opacityValues->data);
     }
 
-    if (getParam1i("preIntegration", 0) && colorValues && opacityValues)
-      ispc::LinearTransferFunction_precomputePreIntegratedValues(ispcEquivalent);
+    if (preIntegration && colorValues && opacityValues)
+      precomputePreIntegratedValues();
 
     TransferFunction::commit();
 
@@ -58,6 +61,27 @@ namespace ospray {
     notifyListenersThatObjectGotChanged();
   }
 
+  void LinearTransferFunction::precomputePreIntegratedValues()
+  {
+    // The tables are built from prefix sums, one (independent) row per
+    // task, i.e., in O(N^2) instead of O(N^3).
+    ispc::LinearTransferFunction_beginPreIntegration(ispcEquivalent);
+
+    tasking::parallel_for(int(opacityValues->numItems), [&](int j) {
+      ispc::LinearTransferFunction_precomputePreIntegratedOpacityRow(
+        ispcEquivalent, j
+      );
+    });
+
+    tasking::parallel_for(int(colorValues->numItems), [&](int j) {
+      ispc::LinearTransferFunction_precomputePreIntegratedColorRow(
+        ispcEquivalent, j
+      );
+    });
+
+    ispc::LinearTransferFunction_endPreIntegration(ispcEquivalent);
+  }
+
   std::string LinearTransferFunction::toString() const
   {
     return "ospray::LinearTransferFunction";
@@ -45,6 +45,9 @@ namespace ospray {
     //! Create the equivalent ISPC transfer function.
     void createEquivalentISPC();
 
+    //! (Re)compute the pre-integrated color and opacity tables.
+    void precomputePreIntegratedValues();
+
   };
 
 } // ::ospray
@@ -20,9 +20,14 @@
 #include "transferFunction/TransferFunction.h"
 #include "common/Data.h"
 #include "Volume_ispc.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
 
 namespace ospray {
 
+  //! Number of coordinates sampled by a single task in computeSamples().
+  static const size_t SAMPLES_PER_TASK = 1024;
+
   bool Volume::isDataDistributed() const
   {
     return false;
@@ -53,20 +58,49 @@ namespace ospray {
     *results = (float *)malloc(count * sizeof(float));
     exitOnCondition(*results == nullptr, "error allocating memory");
 
-    // Allocate memory for ISPC-computed volume samples using Embree's new to
-    // enforce alignment
-    float *ispcResults = new float[count];
-    exitOnCondition(ispcResults == nullptr, "error allocating memory");
+    // Compute the sample values directly into the returned array, in
+    // parallel over blocks of coordinates.
+    float *out = *results;
+    const size_t numBlocks = (count + SAMPLES_PER_TASK - 1) / SAMPLES_PER_TASK;
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * SAMPLES_PER_TASK;
+      const size_t end   = std::min(begin + SAMPLES_PER_TASK, count);
+      float *blockResults = out + begin;
+      ispc::Volume_computeSamples(ispcEquivalent,
+                                  &blockResults,
+                                  (const ispc::vec3f *)worldCoordinates + begin,
+                                  end - begin);
+    });
+  }
 
-    // Compute the sample values.
-    ispc::Volume_computeSamples(ispcEquivalent,
-                                &ispcResults,
-                                (const ispc::vec3f *)worldCoordinates,
-                                count);
+  void Volume::computeSamplesSoA(const float *x,
+                                 const float *y,
+                                 const float *z,
+                                 size_t count,
+                                 float *results,
+                                 float *gradientX,
+                                 float *gradientY,
+                                 float *gradientZ)
+  {
+    // The ISPC volume container must exist at this point.
+    assert(ispcEquivalent != nullptr);
 
-    // Copy samples and free ISPC results memory
-    memcpy(*results, ispcResults, count * sizeof(float));
-    delete[] ispcResults;
+    const bool withGradients = gradientX && gradientY && gradientZ;
+
+    const size_t numBlocks = (count + SAMPLES_PER_TASK - 1) / SAMPLES_PER_TASK;
+    tasking::parallel_for(numBlocks, [&](size_t blockID) {
+      const size_t begin = blockID * SAMPLES_PER_TASK;
+      const size_t end   = std::min(begin + SAMPLES_PER_TASK, count);
+      ispc::Volume_computeSamplesSoA(ispcEquivalent,
+                                     x + begin,
+                                     y + begin,
+                                     z + begin,
+                                     end - begin,
+                                     results + begin,
+                                     withGradients ? gradientX + begin : nullptr,
+                                     withGradients ? gradientY + begin : nullptr,
+                                     withGradients ? gradientZ + begin : nullptr);
+    });
   }
 
   void Volume::finish()
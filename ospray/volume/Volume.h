@@ -58,6 +58,18 @@ namespace ospray {
                                 const vec3f *worldCoordinates,
                                 const size_t &count);
 
+    //! Compute samples (and optionally gradients) at the given world
+    //! coordinates in SoA layout, writing into caller-owned arrays. The
+    //! gradient arrays are either all valid or all nullptr.
+    virtual void computeSamplesSoA(const float *x,
+                                   const float *y,
+                                   const float *z,
+                                   size_t count,
+                                   float *results,
+                                   float *gradientX = nullptr,
+                                   float *gradientY = nullptr,
+                                   float *gradientZ = nullptr);
+
     //! Update select editable parameters (allowed after the volume has been
     //! initially committed).
     virtual void updateEditableParameters();
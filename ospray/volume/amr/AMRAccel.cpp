@@ -15,10 +15,31 @@
 // ======================================================================== //
 
 #include "AMRAccel.h"
+// ospcommon
+#include "ospcommon/tasking/parallel_for.h"
+// stl
+#include <algorithm>
+#include <memory>
+
+/*! subtrees over more than this many (overlapping) bricks get their
+    two children built in parallel */
+#define AMR_PARALLEL_BUILD_THRESHOLD 1024
 
 namespace ospray {
   namespace amr {
 
+    struct AMRAccel::BuildNode
+    {
+      //! split dimension; '3' means 'leaf'
+      int   dim {3};
+      float pos {0.f};
+      std::unique_ptr<BuildNode> child[2];
+
+      //! leaf only: bounds, and the bricks sorted finest to coarsest
+      box3f bounds;
+      std::vector<const AMRData::Brick *> brick;
+    };
+
     /*! constructor that constructs the actual accel from the amr data */
     AMRAccel::AMRAccel(const AMRData &input)
     {
@@ -39,72 +60,93 @@ namespace ospray {
         level[b->level].rcpCellWidth = 1.f/b->cellWidth;
       }
 
-      node.resize(1);
-      buildRec(0, bounds, brickVec);
+      BuildNode root;
+      buildRec(root, bounds, brickVec);
+
+      size_t numNodes = 0, numLeaves = 0, numBrickRefs = 0;
+      countRec(root, numNodes, numLeaves, numBrickRefs);
+
+      // node 1 is padding, so all child pairs start at an even index
+      node.reserve(numNodes+1);
+      leaf.reserve(numLeaves);
+      brickArray.reserve(numBrickRefs);
+
+      node.resize(2);
+      flatten(0, root);
     }
 
     /*! destructor that frees all allocated memory */
     AMRAccel::~AMRAccel()
     {
-      for (auto &l : leaf)
-        delete [] l.brickList;
-
+      brickArray.clear();
       leaf.clear();
       node.clear();
     }
 
-    void AMRAccel::makeLeaf(index_t nodeID,
-                            const box3f &bounds,
-                            const std::vector<const AMRData::Brick *> &brick)
+    void AMRAccel::countRec(const BuildNode &n,
+                            size_t &numNodes,
+                            size_t &numLeaves,
+                            size_t &numBrickRefs)
     {
-      node[nodeID].dim = 3;
-      node[nodeID].ofs = this->leaf.size(); //item.size();
-      node[nodeID].numItems = brick.size();
-
-      AMRAccel::Leaf newLeaf;
-      newLeaf.bounds = bounds;
-      newLeaf.brickList = new const AMRData::Brick *[brick.size()+1];
-
-      // create leaf list, and sort it
-      std::copy(brick.begin(),brick.end(),newLeaf.brickList);
-      std::sort(newLeaf.brickList,newLeaf.brickList+brick.size(),
-                [&](const AMRData::Brick *a, const AMRData::Brick *b){
-                  return a->level > b->level;
-                });
-
-      newLeaf.brickList[brick.size()] = nullptr;
-      this->leaf.push_back(newLeaf);
+      numNodes++;
+      if (n.dim == 3) {
+        numLeaves++;
+        numBrickRefs += n.brick.size();
+      } else {
+        countRec(*n.child[0], numNodes, numLeaves, numBrickRefs);
+        countRec(*n.child[1], numNodes, numLeaves, numBrickRefs);
+      }
     }
 
-    void AMRAccel::makeInner(index_t nodeID, int dim, float pos, int childID)
+    void AMRAccel::flatten(index_t nodeID, BuildNode &buildNode)
     {
-      node[nodeID].dim = dim;
-      node[nodeID].pos = pos;
-      node[nodeID].ofs = childID;
+      if (buildNode.dim == 3) {
+        node[nodeID].dim = 3;
+        node[nodeID].ofs = this->leaf.size();
+        node[nodeID].numItems = buildNode.brick.size();
+
+        AMRAccel::Leaf newLeaf;
+        newLeaf.bounds = buildNode.bounds;
+        newLeaf.brickListBegin = brickArray.size();
+        newLeaf.numBricks = buildNode.brick.size();
+        brickArray.insert(brickArray.end(),
+                          buildNode.brick.begin(), buildNode.brick.end());
+        this->leaf.push_back(newLeaf);
+      } else {
+        const index_t childID = node.size();
+        node.resize(childID+2);
+
+        node[nodeID].dim = buildNode.dim;
+        node[nodeID].pos = buildNode.pos;
+        node[nodeID].ofs = childID;
+
+        flatten(childID+0, *buildNode.child[0]);
+        flatten(childID+1, *buildNode.child[1]);
+      }
     }
 
-    void AMRAccel::buildRec(int nodeID,
+    void AMRAccel::buildRec(BuildNode &buildNode,
                             const box3f &bounds,
                             std::vector<const AMRData::Brick *> &brick)
     {
-      std::set<float> possibleSplits[3];
+      std::vector<float> possibleSplits[3];
       for (const auto &b : brick) {
         const box3f clipped = intersectionOf(bounds, b->worldBounds);
         assert(clipped.lower.x != clipped.upper.x);
         assert(clipped.lower.y != clipped.upper.y);
         assert(clipped.lower.z != clipped.upper.z);
         if (clipped.lower.x != bounds.lower.x)
-          possibleSplits[0].insert(clipped.lower.x);
+          possibleSplits[0].push_back(clipped.lower.x);
         if (clipped.upper.x != bounds.upper.x)
-          possibleSplits[0].insert(clipped.upper.x);
+          possibleSplits[0].push_back(clipped.upper.x);
         if (clipped.lower.y != bounds.lower.y)
-          possibleSplits[1].insert(clipped.lower.y);
+          possibleSplits[1].push_back(clipped.lower.y);
         if (clipped.upper.y != bounds.upper.y)
-          possibleSplits[1].insert(clipped.upper.y);
+          possibleSplits[1].push_back(clipped.upper.y);
         if (clipped.lower.z != bounds.lower.z)
-          possibleSplits[2].insert(clipped.lower.z);
+          possibleSplits[2].push_back(clipped.lower.z);
         if (clipped.upper.z != bounds.upper.z)
-          possibleSplits[2].insert(clipped.upper.z);
+          possibleSplits[2].push_back(clipped.upper.z);
       }
 
       int bestDim = -1;
@@ -122,11 +164,21 @@ namespace ospray {
         // we're looking for (all on a lower level must be earlier in
         // the list)
 
-        makeLeaf(nodeID,bounds,brick);
+        std::sort(brick.begin(),brick.end(),
+                  [&](const AMRData::Brick *a, const AMRData::Brick *b){
+                    return a->level > b->level;
+                  });
+        buildNode.bounds = bounds;
+        buildNode.brick  = std::move(brick);
       } else {
+        // same pick as iterating an ordered set of candidates
+        auto &splits = possibleSplits[bestDim];
+        std::sort(splits.begin(), splits.end());
+        splits.erase(std::unique(splits.begin(), splits.end()), splits.end());
+
         float bestPos = std::numeric_limits<float>::infinity();
         float mid = bounds.center()[bestDim];
-        for (const auto &split : possibleSplits[bestDim]) {
+        for (const auto &split : splits) {
           if (fabsf(split - mid) < fabsf(bestPos-mid))
             bestPos = split;
         }
@@ -179,15 +231,23 @@ namespace ospray {
         }
         assert(!(l.empty() || r.empty()));
 
-        int newNodeID = node.size();
-        makeInner(nodeID,bestDim,bestPos,newNodeID);
-
-        node.push_back(AMRAccel::Node());
-        node.push_back(AMRAccel::Node());
-        brick.clear();
-
-        buildRec(newNodeID+0,lBounds,l);
-        buildRec(newNodeID+1,rBounds,r);
+        buildNode.dim = bestDim;
+        buildNode.pos = bestPos;
+        buildNode.child[0] = make_unique<BuildNode>();
+        buildNode.child[1] = make_unique<BuildNode>();
+        std::vector<const AMRData::Brick *>().swap(brick);
+
+        if (l.size() + r.size() > AMR_PARALLEL_BUILD_THRESHOLD) {
+          tasking::parallel_for(2, [&](int childIndex) {
+            if (childIndex == 0)
+              buildRec(*buildNode.child[0],lBounds,l);
+            else
+              buildRec(*buildNode.child[1],rBounds,r);
+          });
+        } else {
+          buildRec(*buildNode.child[0],lBounds,l);
+          buildRec(*buildNode.child[1],rBounds,r);
+        }
       }
     }
 
@@ -17,6 +17,8 @@
 #pragma once
 
 #include "AMRData.h"
+// ospcommon
+#include "ospcommon/containers/AlignedVector.h"
 
 namespace ospray {
   namespace amr {
@@ -50,13 +52,6 @@ namespace ospray {
         blocks that overlap this area */
       struct Leaf
       {
-        Leaf() {}
-        Leaf(const Leaf &o) : brickList(o.brickList), bounds(o.bounds) {}
-
-        /*! list of bricks that overlap this leaf; sorted from finest
-          to coarsest level */
-        const AMRData::Brick **brickList;
-
         /*! bounding box of this leaf - note that the bricks will
           likely "stick out" of this bounding box, and the same
           brick may be listed in MULTIPLE leaves */
@@ -66,20 +61,26 @@ namespace ospray {
             set AFTER all the bricks are being generated (we need all
             bricks before we can even compute the values in a brick */
         range1f valueRange;
+
+        /*! list of bricks that overlap this leaf, stored as the range
+          [brickListBegin,brickListBegin+numBricks) of 'brickArray';
+          sorted from finest to coarsest level */
+        uint32 brickListBegin;
+        uint32 numBricks;
       };
 
       /*! each node in the tree refers to either a pair ofo child
         nodes (using split plane pos, split plane dim, and offset in
         node[] array), or to a list of 'numItems' bricks (using
-        dim=3, and offset pointing to the start of the list of
-        numItems brick pointers in 'brickArray[]'. In case of a
+        dim=3, and offset being the ID of the leaf whose brick list
+        lives in 'brickArray[]'). In case of a
         leaf, the 'num' bricks stored in this leaf are (in theory),
         exactly one brick per level, in sorted order */
       struct Node
       {
         inline bool isLeaf() const { return dim == 3; }
         // first dword
-        uint32 ofs:30; // offset in node[] array (if inner), or brick ID (if leaf)
+        uint32 ofs:30; // offset in node[] array (if inner), or leaf ID (if leaf)
         uint32 dim:2;  // upper two bits: split dimension. '3' means 'leaf
         // second dword
         union
@@ -95,21 +96,33 @@ namespace ospray {
 
       //! list of levels
       std::vector<Level> level;
-      //! list of inner nodes
-      std::vector<Node> node;
+      /*! list of nodes; the two children of an inner node are stored
+        next to each other, starting at an even index, so that (with
+        the 64-byte aligned array) a pair never straddles a cache
+        line. nodes are laid out depth-first, with the child pair of a
+        left child following right after its parent's pair */
+      containers::AlignedVector<Node> node;
       //! list of leaf nodes
       std::vector<Leaf> leaf;
+      /*! the brick lists of all leaves, stored back to back (see
+        Leaf::brickListBegin) */
+      std::vector<const AMRData::Brick *> brickArray;
       //! world bounds of domain
       box3f worldBounds;
 
     private:
-      void makeLeaf(index_t nodeID,
+      /*! temporary, pointer-based tree node used during the
+        (parallel) build; gets flattened into 'node'/'leaf' after */
+      struct BuildNode;
+
+      void buildRec(BuildNode &buildNode,
                     const box3f &bounds,
-                    const std::vector<const AMRData::Brick *> &brickIDs);
-      void makeInner(index_t nodeID, int dim, float pos, int childID);
-      void buildRec(int nodeID,const box3f &bounds,
                     std::vector<const AMRData::Brick *> &brick);
-
+      void flatten(index_t nodeID, BuildNode &buildNode);
+      static void countRec(const BuildNode &buildNode,
+                           size_t &numNodes,
+                           size_t &numLeaves,
+                           size_t &numBrickRefs);
     };
 
   } // ::ospray::amr
@@ -143,6 +143,7 @@ namespace ospray {
                              &accel->node[0],
                              accel->leaf.size(),
                              &accel->leaf[0],
+                             &accel->brickArray[0],
                              accel->level.size(),
                              &accel->level[0],
                              voxelTypeID,
@@ -38,6 +38,10 @@ namespace ospray {
     // filled.
     updateEditableParameters();
 
+    const vec3i lastDimensions  = this->dimensions;
+    const vec3f lastGridOrigin  = this->gridOrigin;
+    const vec3f lastGridSpacing = this->gridSpacing;
+
     // Set the grid origin, default to (0,0,0).
     this->gridOrigin = getParam3f("gridOrigin", vec3f(0.f));
 
@@ -49,6 +53,15 @@ namespace ospray {
     // Set the grid spacing, default to (1,1,1).
     this->gridSpacing = getParam3f("gridSpacing", vec3f(1.f));
 
+    // Data derived from the volume (e.g., extracted isosurfaces) only
+    // depends on the grid and the voxels, not on the transfer function or
+    // the sampling parameters applied above.
+    const bool gridChanged = !finished || voxelsChanged
+                             || this->dimensions  != lastDimensions
+                             || this->gridOrigin  != lastGridOrigin
+                             || this->gridSpacing != lastGridSpacing;
+    voxelsChanged = false;
+
 
     this->scaleFactor = getParam3f("scaleFactor", vec3f(-1.f));
 
@@ -62,6 +75,11 @@ namespace ospray {
       finish();
       finished = true;
     }
+
+    // Notify listeners (e.g., extracted isosurfaces) that the volume has
+    // changed.
+    if (gridChanged)
+      notifyListenersThatObjectGotChanged();
   }
 
   bool StructuredVolume::scaleRegion(const void *source, void *&out,
@@ -83,17 +83,20 @@ namespace ospray {
     OSPDataType getVoxelType();
 
     //! Volume size in voxels per dimension.
-    vec3i dimensions;
+    vec3i dimensions {0};
 
     //! Grid origin.
-    vec3f gridOrigin;
+    vec3f gridOrigin {0.f};
 
     //! Grid spacing in each dimension.
-    vec3f gridSpacing;
+    vec3f gridSpacing {1.f};
 
     //! Indicate that the volume is fully initialized.
     bool finished {false};
 
+    //! Voxels were written via setRegion() since the last commit.
+    bool voxelsChanged {false};
+
     //! Voxel value range (will be computed if not provided as a parameter).
     vec2f voxelRange {FLT_MAX, -FLT_MAX};
 
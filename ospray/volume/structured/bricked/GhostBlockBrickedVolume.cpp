@@ -92,6 +92,7 @@ namespace ospray {
       free(finalSource);
     }
 
+    voxelsChanged = true;
     return true;
   }
 
@@ -79,6 +79,7 @@ namespace ospray {
                                "support for volumes of voxel type '"
                                + voxelType + "'");
     }
+    voxelsChanged = true;
     return true;
   }
 
@@ -126,8 +127,10 @@ namespace ospray {
   void SharedStructuredVolume::dependencyGotChanged(ManagedObject *object)
   {
     // Rebuild volume accelerator when voxelData is committed.
-    if(object == voxelData && ispcEquivalent)
+    if(object == voxelData && ispcEquivalent) {
       StructuredVolume::buildAccelerator();
+      notifyListenersThatObjectGotChanged();
+    }
   }
 
   // A volume type with XYZ storage order. The voxel data is provided by the
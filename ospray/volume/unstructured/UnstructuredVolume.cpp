@@ -22,6 +22,11 @@
 #include "ospcommon/tasking/parallel_for.h"
 #include "ospcommon/utility/getEnvVar.h"
 
+// std
+#include <algorithm>
+#include <array>
+#include <limits>
+
 // auto-generated .h file.
 #include "UnstructuredVolume_ispc.h"
 
@@ -53,6 +58,20 @@ namespace ospray {
       ispc::UnstructuredVolume_method_nonplanar(ispcEquivalent);
     }
 
+    // Per-cell steps can be switched on and off (or rescaled) at any
+    // commit; they are only recomputed if that setting changed.
+    const float stepScale =
+        getParam1i("cellStep", 0) ? getParam1f("cellStepScale", 0.5f) : 0.f;
+    if (stepScale != cellStepScale) {
+      cellStepScale = stepScale;
+      if (cellStepScale > 0.f)
+        calculateCellSteps();
+      else
+        std::vector<float>().swap(cellSteps);
+      ispc::UnstructuredVolume_setCellSteps(ispcEquivalent,
+          cellSteps.empty() ? nullptr : cellSteps.data());
+    }
+
     Volume::commit();
   }
 
@@ -61,49 +80,124 @@ namespace ospray {
     return 0;
   }
 
-  void UnstructuredVolume::computeSamples(float **,
-                                         const vec3f *,
-                                         const size_t &)
+  namespace {
+
+    //! Whether 'type' is an array of (32- or 64-bit) integer indices.
+    bool isIndexType(OSPDataType type, bool &is64)
+    {
+      if ((type >= OSP_INT && type <= OSP_INT4) ||
+          (type >= OSP_UINT && type <= OSP_UINT4)) {
+        is64 = false;
+        return true;
+      }
+      if ((type >= OSP_LONG && type <= OSP_LONG4) ||
+          (type >= OSP_ULONG && type <= OSP_ULONG4)) {
+        is64 = true;
+        return true;
+      }
+      return false;
+    }
+
+    inline int64 readIndex(const Data *data, bool is64, size_t i)
+    {
+      return is64 ? ((const int64 *)data->data)[i]
+                  : ((const int32 *)data->data)[i];
+    }
+
+    // Corners of the faces of tetrahedra and hexahedra, in the same order
+    // as their face normals (face 'i' of a tetrahedron is opposite of its
+    // corner 'i').
+    const int tetFaces[4][3] = {{1, 2, 3}, {2, 0, 3}, {3, 0, 1}, {0, 2, 1}};
+    const int hexFaces[6][4] = {{0, 1, 2, 3}, {0, 1, 5, 4}, {0, 3, 7, 4},
+                                {1, 2, 6, 5}, {4, 5, 6, 7}, {2, 3, 7, 6}};
+
+    //! A cell face, identified by a hash of its sorted corner indices.
+    struct CellFace
+    {
+      uint64 key;
+      uint64 slot;  // index into the neighbor array
+
+      bool operator<(const CellFace &other) const { return key < other.key; }
+    };
+
+    inline uint64 hashFace(const std::array<int64, 4> &corners)
+    {
+      uint64 h = 0x9e3779b97f4a7c15ull;
+      for (const int64 c : corners) {
+        h = (h ^ uint64(c)) * 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+      }
+      return h;
+    }
+
+    //! Sort blocks of 'items' in parallel, then merge them pairwise.
+    template <typename T>
+    void parallelSort(std::vector<T> &items)
+    {
+      const size_t n         = items.size();
+      const size_t blockSize = 64 * 1024;
+
+      tasking::parallel_for(divRoundUp(n, blockSize), [&](size_t b) {
+        std::sort(items.begin() + b * blockSize,
+                  items.begin() + std::min(n, (b + 1) * blockSize));
+      });
+
+      for (size_t width = blockSize; width < n; width *= 2) {
+        tasking::parallel_for(divRoundUp(n, 2 * width), [&](size_t m) {
+          const size_t begin = 2 * width * m;
+          std::inplace_merge(items.begin() + begin,
+                             items.begin() + std::min(n, begin + width),
+                             items.begin() + std::min(n, begin + 2 * width));
+        });
+      }
+    }
+
+    // Decomposition of wedges and pyramids into tetrahedra.
+    const int wedgeTets[3][4]   = {{0, 1, 2, 3}, {1, 2, 3, 4}, {2, 3, 4, 5}};
+    const int pyramidTets[2][4] = {{0, 1, 2, 4}, {0, 2, 3, 4}};
+
+  }  // ::ospray::<anonymous>
+
+  int64 UnstructuredVolume::cellIndex(size_t cellID, int i) const
   {
-    NOT_IMPLEMENTED;
+    const void *cells = tetIndices;
+    int perCell = 4;
+    if (cellID >= nTets) {
+      cells = hexIndices;
+      cellID -= nTets;
+      perCell = 8;
+    }
+    const size_t idx = cellID * perCell + i;
+    return index64 ? ((const int64 *)cells)[idx] : ((const int32 *)cells)[idx];
   }
 
-  box4f UnstructuredVolume::getTetBBox(size_t id)
+  box4f UnstructuredVolume::getCellBBox(size_t cellID)
   {
-    box4f tetBox;
+    box4f cellBox;
 
-    int maxIdx = indices[2 * id][0] == -1 ? 4 : 8;
+    const int maxIdx = cellID < nTets ? 4 : 8;
 
     for (int i = 0; i < maxIdx; i++) {
-      size_t idx;
-      if (maxIdx == 4) {
-        idx = indices[2 * id + 1][i];
-      } else {
-        if (i < 4)
-          idx = indices[2 * id][i];
-        else
-          idx = indices[2 * id + 1][i - 4];
-      }
+      const int64 idx = cellIndex(cellID, i);
       const auto &v = vertices[idx];
       const float f = field[idx];
       const auto p  = vec4f(v.x, v.y, v.z, f);
 
       if (i == 0)
-        tetBox.upper = tetBox.lower = p;
+        cellBox.upper = cellBox.lower = p;
       else
-        tetBox.extend(p);
+        cellBox.extend(p);
     }
 
-    return tetBox;
+    return cellBox;
   }
 
   void UnstructuredVolume::finish()
   {
     Data *verticesData   = getParamData("vertices", nullptr);
-    Data *indicesData    = getParamData("indices", nullptr);
     Data *fieldData      = getParamData("field", nullptr);
 
-    if (!verticesData || !indicesData || !fieldData) {
+    if (!verticesData || !fieldData) {
       throw std::runtime_error(
           "#osp: missing correct data arrays in "
           " UnstructuredVolume!");
@@ -111,26 +205,43 @@ namespace ospray {
 
     nVertices   = verticesData->size();
 
-    nCells = indicesData->size() / 2;
-    indices = (vec4i *)indicesData->data;
-
     vertices   = (vec3f *)verticesData->data;
     field      = (float *)fieldData->data;
 
+    setupCells();
+
+    if (nTets + nHexes == 0) {
+      throw std::runtime_error(
+          "#osp: no cells given to UnstructuredVolume!");
+    }
+
     buildBvhAndCalculateBounds();
-    calculateFaceNormals();
+    if (getParam1i("precomputeNormals", 1))
+      calculateFaceNormals();
 
     float samplingRate = getParam1f("samplingRate", 1.f);
-    float samplingStep = calculateSamplingStep();
+    samplingStep = calculateSamplingStep();
+
+    // Neighbor references are 32-bit.
+    if (getParam1i("cellAdjacency", 0) &&
+        nTets + nHexes < size_t(std::numeric_limits<int32>::max()))
+      buildCellAdjacency();
 
     UnstructuredVolume_set(ispcEquivalent,
                           nVertices,
-                          nCells,
                           (const ispc::box3f &)bbox,
                           (const ispc::vec3f *)vertices,
-                          (const ispc::vec3f *)faceNormals.data(),
-                          (const ispc::vec4i *)indices,
                           (const float *)field,
+                          nTets,
+                          tetIndices,
+                          nHexes,
+                          hexIndices,
+                          index64,
+                          tetNormals.empty() ? nullptr
+                              : (const ispc::vec3f *)tetNormals.data(),
+                          hexNormals.empty() ? nullptr
+                              : (const ispc::vec3f *)hexNormals.data(),
+                          neighbors.empty() ? nullptr : neighbors.data(),
                           bvh.rootRef(),
                           bvh.nodePtr(),
                           bvh.itemListPtr(),
@@ -141,80 +252,202 @@ namespace ospray {
     finished = true;
   }
 
-  void UnstructuredVolume::buildBvhAndCalculateBounds()
+  void UnstructuredVolume::setupCells()
   {
-    std::vector<int64> primID(nCells);
-    std::vector<box4f> primBounds(nCells);
+    Data *tetData     = getParamData("tetrahedra", nullptr);
+    Data *hexData     = getParamData("hexahedra", nullptr);
+    Data *wedgeData   = getParamData("wedges", nullptr);
+    Data *pyramidData = getParamData("pyramids", nullptr);
+    Data *legacyData  = getParamData("indices", nullptr);
+
+    if (legacyData) {
+      if (tetData || hexData || wedgeData || pyramidData) {
+        throw std::runtime_error("#osp: UnstructuredVolume takes either "
+                                 "'indices' or per cell type arrays, not both");
+      }
 
-    for (int i = 0; i < nCells; i++) {
-      primID[i]   = i;
-      auto bounds = getTetBBox(i);
-      if (i == 0) {
-        bbox.lower = vec3f(bounds.lower.x, bounds.lower.y, bounds.lower.z);
-        bbox.upper = vec3f(bounds.upper.x, bounds.upper.y, bounds.upper.z);
-      } else {
-        bbox.extend(vec3f(bounds.lower.x, bounds.lower.y, bounds.lower.z));
-        bbox.extend(vec3f(bounds.upper.x, bounds.upper.y, bounds.upper.z));
+      // Two vec4i per cell, with tetrahedra marked by a leading -1.
+      const vec4i *indices = (const vec4i *)legacyData->data;
+      const size_t nCells  = legacyData->size() / 2;
+      for (size_t i = 0; i < nCells; i++) {
+        const vec4i &lower = indices[2 * i];
+        const vec4i &upper = indices[2 * i + 1];
+        if (lower.x == -1) {
+          ownedTets32.insert(ownedTets32.end(), &upper.x, &upper.x + 4);
+        } else {
+          ownedHexes32.insert(ownedHexes32.end(), &lower.x, &lower.x + 4);
+          ownedHexes32.insert(ownedHexes32.end(), &upper.x, &upper.x + 4);
+        }
       }
-      primBounds[i] = bounds;
+
+      index64    = false;
+      nTets      = ownedTets32.size() / 4;
+      tetIndices = ownedTets32.data();
+      nHexes     = ownedHexes32.size() / 8;
+      hexIndices = ownedHexes32.data();
+      return;
     }
 
-    bvh.build(primBounds.data(), primID.data(), nCells);
+    // All cell arrays have to use the same index width.
+    bool anyCells = false;
+    auto numIndices = [&](const Data *data,
+                          const std::string &name,
+                          int perCell) -> size_t {
+      if (!data)
+        return 0;
+
+      bool is64 = false;
+      if (!isIndexType(data->type, is64)) {
+        throw std::runtime_error("#osp: '" + name + "' of UnstructuredVolume"
+                                 " has to be an array of integer indices");
+      }
+      if (anyCells && is64 != index64) {
+        throw std::runtime_error("#osp: cell arrays of UnstructuredVolume"
+                                 " have to be either all 32-bit or all"
+                                 " 64-bit indices");
+      }
+      anyCells = true;
+      index64  = is64;
+
+      const size_t n = data->numBytes / (is64 ? 8 : 4);
+      if (n % perCell != 0) {
+        throw std::runtime_error("#osp: size of '" + name + "' of"
+                                 " UnstructuredVolume is not a multiple of "
+                                 + std::to_string(perCell));
+      }
+      return n;
+    };
+
+    const size_t numTetIndices     = numIndices(tetData, "tetrahedra", 4);
+    const size_t numHexIndices     = numIndices(hexData, "hexahedra", 8);
+    const size_t numWedgeIndices   = numIndices(wedgeData, "wedges", 6);
+    const size_t numPyramidIndices = numIndices(pyramidData, "pyramids", 5);
+
+    nHexes     = numHexIndices / 8;
+    hexIndices = hexData ? hexData->data : nullptr;
+
+    if (!wedgeData && !pyramidData) {
+      nTets      = numTetIndices / 4;
+      tetIndices = tetData ? tetData->data : nullptr;
+      return;
+    }
+
+    // Wedges and pyramids are split into tetrahedra, which get appended
+    // to a copy of the given tetrahedra.
+    if (index64) {
+      gatherCells(ownedTets64, numTetIndices, numWedgeIndices, numPyramidIndices);
+      nTets      = ownedTets64.size() / 4;
+      tetIndices = ownedTets64.data();
+    } else {
+      gatherCells(ownedTets32, numTetIndices, numWedgeIndices, numPyramidIndices);
+      nTets      = ownedTets32.size() / 4;
+      tetIndices = ownedTets32.data();
+    }
   }
 
-  void UnstructuredVolume::calculateFaceNormals()
+  template <typename T>
+  void UnstructuredVolume::gatherCells(std::vector<T> &tets,
+                                       size_t numTetIndices,
+                                       size_t numWedgeIndices,
+                                       size_t numPyramidIndices)
   {
-    const auto numNormals = nCells * 6;
-    faceNormals.resize(numNormals);
+    Data *tetData     = getParamData("tetrahedra", nullptr);
+    Data *wedgeData   = getParamData("wedges", nullptr);
+    Data *pyramidData = getParamData("pyramids", nullptr);
+
+    tets.reserve(numTetIndices + numWedgeIndices / 6 * 12 +
+                 numPyramidIndices / 5 * 8);
+
+    for (size_t i = 0; i < numTetIndices; i++)
+      tets.push_back(readIndex(tetData, index64, i));
+
+    auto split = [&](const Data *data,
+                     size_t numIndices,
+                     int perCell,
+                     const int (*cellTets)[4],
+                     int numCellTets) {
+      for (size_t c = 0; c < numIndices; c += perCell) {
+        for (int t = 0; t < numCellTets; t++) {
+          T tet[4];
+          for (int i = 0; i < 4; i++)
+            tet[i] = readIndex(data, index64, c + cellTets[t][i]);
+
+          // Sampling relies on positively oriented tetrahedra.
+          const vec3f &p0 = vertices[tet[0]];
+          const vec3f &p1 = vertices[tet[1]];
+          const vec3f &p2 = vertices[tet[2]];
+          const vec3f &p3 = vertices[tet[3]];
+          if (dot(cross(p2 - p1, p3 - p1), p1 - p0) < 0.f)
+            std::swap(tet[1], tet[2]);
+
+          tets.insert(tets.end(), tet, tet + 4);
+        }
+      }
+    };
 
-    tasking::parallel_for(numNormals / 6, [&](int taskIndex) {
-      const int i   = taskIndex * 6;
+    split(wedgeData, numWedgeIndices, 6, wedgeTets, 3);
+    split(pyramidData, numPyramidIndices, 5, pyramidTets, 2);
+  }
 
-      if (indices[2 * taskIndex].x == -1) {
-        // tetrahedron cell
-        const vec4i &t = indices[2 * taskIndex + 1];
+  void UnstructuredVolume::buildBvhAndCalculateBounds()
+  {
+    const size_t nCells = nTets + nHexes;
 
-        // The corners of each triangle in the tetrahedron.
-        const int faces[4][3] = {{1, 2, 3}, {2, 0, 3}, {3, 0, 1}, {0, 2, 1}};
+    std::vector<int64> primID(nCells);
+    std::vector<box4f> primBounds(nCells);
 
-        for (int j = 0; j < 4; j++) {
-          const int t0 = t[faces[j][0]];
-          const int t1 = t[faces[j][1]];
-          const int t2 = t[faces[j][2]];
+    tasking::parallel_for(nCells, [&](size_t i) {
+      primID[i]     = i;
+      primBounds[i] = getCellBBox(i);
+    });
 
-          const auto &p0 = vertices[t0];
-          const auto &p1 = vertices[t1];
-          const auto &p2 = vertices[t2];
+    bbox = empty;
+    for (const auto &bounds : primBounds) {
+      bbox.extend(vec3f(bounds.lower.x, bounds.lower.y, bounds.lower.z));
+      bbox.extend(vec3f(bounds.upper.x, bounds.upper.y, bounds.upper.z));
+    }
 
-          const auto q0 = p1 - p0;
-          const auto q1 = p2 - p0;
+    bvh.build(primBounds.data(), primID.data(), nCells);
+  }
 
-          const auto norm = normalize(cross(q0, q1));
+  void UnstructuredVolume::calculateFaceNormals()
+  {
+    tetNormals.resize(nTets * 4);
+    hexNormals.resize(nHexes * 6);
 
-          faceNormals[i + j] = norm;
-        }
-      } else {
-        // hexahedron cell
-        const vec4i &lower = indices[2 * taskIndex];
-        const vec4i &upper = indices[2 * taskIndex + 1];
-
-        const auto v0 = vertices[lower.x];
-        const auto v1 = vertices[lower.y];
-        const auto v2 = vertices[lower.z];
-        const auto v3 = vertices[lower.w];
-        const auto v4 = vertices[upper.x];
-        const auto v5 = vertices[upper.y];
-        const auto v6 = vertices[upper.z];
-        const auto v7 = vertices[upper.w];
-
-        faceNormals[i + 0] = normalize(cross(v2 - v0, v1 - v0));
-        faceNormals[i + 1] = normalize(cross(v5 - v0, v4 - v0));
-        faceNormals[i + 2] = normalize(cross(v7 - v0, v3 - v0));
-        faceNormals[i + 3] = normalize(cross(v5 - v6, v1 - v6));
-        faceNormals[i + 4] = normalize(cross(v7 - v6, v4 - v6));
-        faceNormals[i + 5] = normalize(cross(v2 - v6, v3 - v6));
+    tasking::parallel_for(nTets, [&](size_t taskIndex) {
+      for (int j = 0; j < 4; j++) {
+        const auto &p0 = vertices[cellIndex(taskIndex, tetFaces[j][0])];
+        const auto &p1 = vertices[cellIndex(taskIndex, tetFaces[j][1])];
+        const auto &p2 = vertices[cellIndex(taskIndex, tetFaces[j][2])];
+
+        const auto q0 = p1 - p0;
+        const auto q1 = p2 - p0;
+
+        tetNormals[taskIndex * 4 + j] = normalize(cross(q0, q1));
       }
     });
+
+    tasking::parallel_for(nHexes, [&](size_t taskIndex) {
+      const size_t cellID = nTets + taskIndex;
+      vec3f *n = &hexNormals[taskIndex * 6];
+
+      const auto v0 = vertices[cellIndex(cellID, 0)];
+      const auto v1 = vertices[cellIndex(cellID, 1)];
+      const auto v2 = vertices[cellIndex(cellID, 2)];
+      const auto v3 = vertices[cellIndex(cellID, 3)];
+      const auto v4 = vertices[cellIndex(cellID, 4)];
+      const auto v5 = vertices[cellIndex(cellID, 5)];
+      const auto v6 = vertices[cellIndex(cellID, 6)];
+      const auto v7 = vertices[cellIndex(cellID, 7)];
+
+      n[0] = normalize(cross(v2 - v0, v1 - v0));
+      n[1] = normalize(cross(v5 - v0, v4 - v0));
+      n[2] = normalize(cross(v7 - v0, v3 - v0));
+      n[3] = normalize(cross(v5 - v6, v1 - v6));
+      n[4] = normalize(cross(v7 - v6, v4 - v6));
+      n[5] = normalize(cross(v2 - v6, v3 - v6));
+    });
   }
 
   float UnstructuredVolume::calculateSamplingStep()
@@ -229,6 +462,81 @@ namespace ospray {
     return getParam1f("samplingStep", samplingStep);
   }
 
+  void UnstructuredVolume::calculateCellSteps()
+  {
+    // Guard against degenerate cells stalling the ray.
+    const float minStep = 0.01f * samplingStep;
+
+    cellSteps.resize(nTets + nHexes);
+    tasking::parallel_for(nTets + nHexes, [&](size_t cellID) {
+      const box4f bounds = getCellBBox(cellID);
+      const float size   = reduce_min(vec3f(bounds.upper.x - bounds.lower.x,
+                                            bounds.upper.y - bounds.lower.y,
+                                            bounds.upper.z - bounds.lower.z));
+      cellSteps[cellID] = std::max(cellStepScale * size, minStep);
+    });
+  }
+
+  void UnstructuredVolume::buildCellAdjacency()
+  {
+    const size_t numSlots = 4 * nTets + 6 * nHexes;
+
+    // Cells sharing a face have the same sorted corner indices for it
+    // (with a leading -1 for triangles).
+    auto faceCorners = [&](size_t slot) {
+      std::array<int64, 4> corners;
+      if (slot < 4 * nTets) {
+        corners[3] = -1;
+        for (int i = 0; i < 3; i++)
+          corners[i] = cellIndex(slot / 4, tetFaces[slot % 4][i]);
+      } else {
+        const size_t hexSlot = slot - 4 * nTets;
+        for (int i = 0; i < 4; i++) {
+          corners[i] = cellIndex(nTets + hexSlot / 6,
+                                 hexFaces[hexSlot % 6][i]);
+        }
+      }
+      std::sort(corners.begin(), corners.end());
+      return corners;
+    };
+
+    auto slotCell = [&](size_t slot) -> int32 {
+      return slot < 4 * nTets ? slot / 4 : nTets + (slot - 4 * nTets) / 6;
+    };
+
+    // Sorting all faces by the hash of their corners brings neighbors
+    // next to each other, at 16 bytes per face.
+    std::vector<CellFace> faces(numSlots);
+    tasking::parallel_for(numSlots, [&](size_t slot) {
+      faces[slot].key  = hashFace(faceCorners(slot));
+      faces[slot].slot = slot;
+    });
+
+    parallelSort(faces);
+
+    // Within a run of equal hashes, only faces with the same corners are
+    // neighbors; anything else is a hash collision.
+    neighbors.assign(numSlots, -1);
+    for (size_t begin = 0, end = 1; begin < numSlots; begin = end++) {
+      while (end < numSlots && faces[end].key == faces[begin].key)
+        end++;
+
+      for (size_t i = begin; i + 1 < end; i++) {
+        if (neighbors[faces[i].slot] != -1)
+          continue;
+        const auto corners = faceCorners(faces[i].slot);
+        for (size_t j = i + 1; j < end; j++) {
+          if (neighbors[faces[j].slot] == -1 &&
+              faceCorners(faces[j].slot) == corners) {
+            neighbors[faces[i].slot] = slotCell(faces[j].slot);
+            neighbors[faces[j].slot] = slotCell(faces[i].slot);
+            break;
+          }
+        }
+      }
+    }
+  }
+
   OSP_REGISTER_VOLUME(UnstructuredVolume, unstructured_volume);
 
 }  // ::ospray
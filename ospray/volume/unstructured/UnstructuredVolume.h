@@ -14,6 +14,7 @@
 // limitations under the License.                                           //
 // ======================================================================== //
 
+
 #pragma once
 
 // ospray
@@ -23,6 +24,40 @@
 
 namespace ospray {
 
+  /*! \brief A volume given by tetrahedral and/or hexahedral cells
+
+    Cells are given in separate arrays per cell type, with their
+    natural number of vertex indices per cell:
+
+    <dl>
+    <dt><code>Data<int|long> tetrahedra</code></dt><dd>4 indices per cell</dd>
+    <dt><code>Data<int|long> hexahedra</code></dt><dd>8 indices per cell</dd>
+    <dt><code>Data<int|long> wedges</code></dt><dd>6 indices per cell, split into 3 tetrahedra</dd>
+    <dt><code>Data<int|long> pyramids</code></dt><dd>5 indices per cell, split into 2 tetrahedra</dd>
+    </dl>
+
+    Indices are either all 32-bit (OSP_INT, OSP_UINT and their vector
+    types) or all 64-bit (OSP_LONG, OSP_ULONG, ...). The legacy layout
+    of two vec4i per cell in 'indices' (with a leading -1 marking
+    tetrahedra) is still accepted and converted to the above.
+
+    Tetrahedra (and planar hexahedra) are sampled using the plane
+    equations of their faces. These are precomputed at commit, unless
+    'precomputeNormals' is set to 0, in which case they are computed
+    on-the-fly while sampling to save memory.
+
+    By default rays are marched with a single global step size. If
+    'cellStep' is set, the step size instead adapts to the size of the
+    cell the ray currently is in (scaled by 'cellStepScale', default
+    0.5), so small cells no longer get undersampled and large cells no
+    longer get oversampled. Both can be changed at any commit.
+
+    If 'cellAdjacency' is set to 1, the face neighbors of all cells are
+    determined at commit, which temporarily takes 16 bytes per cell face
+    and keeps 4 of them. Renderers sampling along a ray then first test
+    the cell of the previous sample and its neighbors, and only fall
+    back to a traversal of the BVH if the sample is in neither.
+  */
   class UnstructuredVolume : public Volume
   {
    public:
@@ -41,31 +76,66 @@ namespace ospray {
                   const vec3i &target_index,
                   const vec3i &source_count) override;
 
-    //! Compute samples at the given world coordinates.
-    void computeSamples(float **results,
-                        const vec3f *worldCoordinates,
-                        const size_t &count) override;
-
    private:
-    box4f getTetBBox(size_t id);
+    //! Vertex index 'i' of the given cell (tetrahedra first, then hexahedra).
+    int64 cellIndex(size_t cellID, int i) const;
+
+    box4f getCellBBox(size_t cellID);
 
     //! Complete volume initialization (only on first commit).
     void finish() override;
 
+    //! Fetch the cell arrays, converting/splitting cells where needed.
+    void setupCells();
+
+    //! Gather the given tetrahedra plus the split wedges and pyramids.
+    template <typename T>
+    void gatherCells(std::vector<T> &tets,
+                     size_t numTetIndices,
+                     size_t numWedgeIndices,
+                     size_t numPyramidIndices);
+
     void buildBvhAndCalculateBounds();
     void calculateFaceNormals();
     float calculateSamplingStep();
+    void calculateCellSteps();
+    void buildCellAdjacency();
 
     // Data members //
 
-    int nVertices;
+    size_t nVertices;
     vec3f *vertices{nullptr};
     float *field{nullptr};  // Attribute value at each vertex.
 
-    int nCells;
-    vec4i *indices{nullptr};
+    //! Whether all cell indices are 64-bit (otherwise 32-bit).
+    bool index64{false};
+
+    size_t nTets{0};
+    const void *tetIndices{nullptr};  // 4 indices per tetrahedron
+    size_t nHexes{0};
+    const void *hexIndices{nullptr};  // 8 indices per hexahedron
+
+    //! Cell arrays owned by the volume, if the input had to be converted.
+    std::vector<int32> ownedTets32, ownedHexes32;
+    std::vector<int64> ownedTets64;
+
+    //! Face normals, 4 per tetrahedron and 6 per hexahedron; empty if
+    //! computed on-the-fly.
+    std::vector<vec3f> tetNormals;
+    std::vector<vec3f> hexNormals;
+
+    //! Global ray marching step size.
+    float samplingStep{0.f};
+
+    //! Per-cell ray marching step size; empty if a global step is used.
+    std::vector<float> cellSteps;
+
+    //! The 'cellStepScale' cellSteps were computed with; 0 if not used.
+    float cellStepScale{0.f};
 
-    std::vector<vec3f> faceNormals;
+    //! Face neighbors, 4 per tetrahedron and 6 per hexahedron (-1 on the
+    //! boundary); empty if not built.
+    std::vector<int32> neighbors;
 
     box3f bbox;
 
@@ -82,6 +82,12 @@ protected:
   OSPMaterial CreateMaterial(std::string type);
 
   void RenderFrame(const uint32_t frameBufferChannels = OSP_FB_COLOR | OSP_FB_ACCUM);
+
+  // Helpers for tests that compare against an image they rendered themselves (e.g. the same
+  // scene with some option disabled) instead of a baseline image.
+  std::vector<uint32_t> GetImage(OSPFrameBuffer fb);
+  std::vector<uint32_t> RenderImage(OSPFrameBuffer fb, const uint32_t frameBufferChannels = OSP_FB_COLOR | OSP_FB_ACCUM);
+  void CompareWithReference(const std::vector<uint32_t>& image, const std::vector<uint32_t>& reference);
 };
 
 // Fixture class for tests parametrized with renderer type and material type, intended for
@@ -133,15 +139,52 @@ private:
 };
 
 // Fixture class used for tests that generates two isosurfaces, one in shape of a torus.
-// It's parametrized with type of the renderer.
-class Torus : public Base, public ::testing::TestWithParam<const char*> {
+// It's parametrized with type of the renderer and a boolean value that controls whether
+// the isosurfaces are extracted as a triangle mesh (true) or rendered implicitly (false).
+class Torus : public Base, public ::testing::TestWithParam<std::tuple<const char*, bool>> {
 public:
   Torus();
   virtual void SetUp();
+protected:
+  bool extractIsosurfaces;
+  std::vector<float> volumetricData;
+  OSPVolume torus;
+  OSPData voxelsData;
+  OSPTransferFunction transferFun;
+};
+
+// Fixture class for a single isosurface around a slab that is one voxel thick, i.e., much thinner
+// than the step size the volume is sampled with. The isosurface is rendered implicitly; the
+// tests can switch it to an extracted mesh. It's parametrized with the type of the renderer.
+class ThinIsosurface : public Base, public ::testing::TestWithParam<const char*> {
+public:
+  ThinIsosurface();
+  virtual void SetUp();
+protected:
+  OSPGeometry isosurface;
 private:
   std::vector<float> volumetricData;
 };
 
+// Fixture class for an unstructured volume of a cube made of 4x4x4 cells, with a linear field
+// that every cell type interpolates exactly. It's parametrized with the type of the cells and
+// whether their indices are 64-bit; the tests can create the same volume from other cells.
+class UnstructuredCube : public Base, public ::testing::TestWithParam<std::tuple<const char*, bool>> {
+public:
+  UnstructuredCube();
+  virtual void SetUp();
+  OSPVolume CreateVolume(const std::string& type, bool longIndices);
+protected:
+  std::string cellType;
+  bool index64;
+  OSPVolume volume;
+private:
+  static const int size = 4;
+  std::vector<float> vertices;
+  std::vector<float> field;
+  OSPTransferFunction transferFun;
+};
+
 // Fixture for test that renders three cuts of a cubic volume.
 class SlicedCube : public Base, public ::testing::Test {
 public:
@@ -172,9 +215,22 @@ class Pipes : public Base, public ::testing::TestWithParam<std::tuple<const char
 public:
   Pipes();
   virtual void SetUp();
-private:
+protected:
   float radius;
   std::string materialType;
+  std::vector<float> vertex;
+  std::vector<int> index;
+  OSPGeometry streamlines;
+};
+
+// Fixture class that renders a fixed scene of a few spheres in front of a quad. It is used to
+// test renderer and framebuffer options that are supposed to give the same image (within the
+// tolerance of the image comparison) as rendering without them, and is parametrized with the
+// type of the renderer.
+class RendererOptions : public Base, public ::testing::TestWithParam<const char*> {
+public:
+  RendererOptions();
+  virtual void SetUp();
 };
 
 } // namespace OSPRayTestScenes
@@ -65,6 +65,8 @@ class OSPImageTools {
     // helper method to write the image with given format
     OsprayStatus writeImg(std::string fileName, const void *pixel);
     std::string GetFileFormat() const { return fileFormat; };
+    // helper method to compare two images, both in the layout of the framebuffer
+    OsprayStatus compareImages(const uint32_t *testImg, const uint32_t *referenceImg, std::string referenceName);
 
   public:
     OSPImageTools(osp::vec2i imgSize, std::string testName, OSPFrameBufferFormat frameBufferFormat);
@@ -74,4 +76,6 @@ class OSPImageTools {
     OsprayStatus saveTestImage(const void *pixel);
     // helper method to compare gold image with current framebuffer render
     OsprayStatus compareImgWithBaseline(const uint32_t *testImg);
+    // helper method to compare current framebuffer render with an image rendered by the test itself
+    OsprayStatus compareImgWithReference(const uint32_t *testImg, const uint32_t *referenceImg);
 };
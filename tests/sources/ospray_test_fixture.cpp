@@ -167,6 +167,25 @@ void Base::RenderFrame(const uint32_t frameBufferChannels) {
     ospRenderFrame(framebuffer, renderer, frameBufferChannels);
 }
 
+std::vector<uint32_t> Base::GetImage(OSPFrameBuffer fb) {
+  const uint32_t* data = (const uint32_t*)ospMapFrameBuffer(fb, OSP_FB_COLOR);
+  std::vector<uint32_t> image(data, data + imgSize.x * imgSize.y);
+  ospUnmapFrameBuffer(data, fb);
+  return image;
+}
+
+std::vector<uint32_t> Base::RenderImage(OSPFrameBuffer fb, const uint32_t frameBufferChannels) {
+  ospFrameBufferClear(fb, OSP_FB_COLOR | OSP_FB_ACCUM);
+  for (int frame = 0; frame < frames; ++frame)
+    ospRenderFrame(fb, renderer, frameBufferChannels);
+  return GetImage(fb);
+}
+
+void Base::CompareWithReference(const std::vector<uint32_t>& image, const std::vector<uint32_t>& reference) {
+  ASSERT_EQ(image.size(), reference.size());
+  EXPECT_EQ(imageTool->compareImgWithReference(image.data(), reference.data()), OsprayStatus::Ok);
+}
+
 
 SingleObject::SingleObject() {
   auto params = GetParam();
@@ -445,7 +464,21 @@ void Sierpinski::SetUp() {
 
 
 Torus::Torus() {
-  rendererType = GetParam();
+  auto params = GetParam();
+  rendererType = std::get<0>(params);
+  extractIsosurfaces = std::get<1>(params);
+
+  // extracted isosurfaces have to look like the implicit ones (within the
+  // tolerance of the image comparison), thus they share their baselines
+  if (extractIsosurfaces) {
+    const std::string extracted = "_Extracted_";
+    const size_t pos = testName.find(extracted);
+    if (pos != std::string::npos) {
+      testName.replace(pos, extracted.size(), "_Renderers_");
+      delete imageTool;
+      SetImageTool();
+    }
+  }
 }
 
 void Torus::SetUp() {
@@ -483,8 +516,8 @@ void Torus::SetUp() {
     }
   }
 
-  OSPVolume torus = ospNewVolume("shared_structured_volume");
-  OSPData voxelsData = ospNewData(size * size * size, OSP_FLOAT, volumetricData.data(), OSP_DATA_SHARED_BUFFER);
+  torus = ospNewVolume("shared_structured_volume");
+  voxelsData = ospNewData(size * size * size, OSP_FLOAT, volumetricData.data(), OSP_DATA_SHARED_BUFFER);
   ospSetData(torus, "voxelData", voxelsData);
   ospSet3i(torus, "dimensions", size, size, size);
   ospSetString(torus, "voxelType", "float");
@@ -492,7 +525,7 @@ void Torus::SetUp() {
   ospSet3f(torus, "gridOrigin", -0.5f, -0.5f, -0.5f);
   ospSet3f(torus, "gridSpacing", 1.f / size, 1.f / size, 1.f / size);
 
-  OSPTransferFunction transferFun = ospNewTransferFunction("piecewise_linear");
+  transferFun = ospNewTransferFunction("piecewise_linear");
   ospSet2f(transferFun, "valueRange", -10000.f, 10000.f);
   float colors[] = {
     1.0f, 0.0f, 0.0f,
@@ -513,6 +546,77 @@ void Torus::SetUp() {
   float isovalues[2] = { -7000.f, 0.f };
   OSPData isovaluesData = ospNewData(2, OSP_FLOAT, isovalues);
   ospSetData(isosurface, "isovalues", isovaluesData);
+  ospSet1i(isosurface, "extract", extractIsosurfaces);
+  ospCommit(isosurface);
+  AddGeometry(isosurface);
+
+  OSPLight ambient = ospNewLight(renderer, "ambient");
+  ASSERT_TRUE(ambient) << "Failed to create lights";
+  ospSetf(ambient, "intensity", 0.5f);
+  ospCommit(ambient);
+  AddLight(ambient);
+}
+
+ThinIsosurface::ThinIsosurface() {
+  rendererType = GetParam();
+}
+
+void ThinIsosurface::SetUp() {
+  ASSERT_NO_FATAL_FAILURE(CreateEmptyScene());
+
+  float cam_pos[] = {-0.7f, -1.4f, 0.f};
+  float cam_up[] = {0.f, 0.f, -1.f};
+  float cam_view[] = {0.5f, 1.f, 0.f};
+  ospSet3fv(camera, "pos", cam_pos);
+  ospSet3fv(camera, "dir", cam_view);
+  ospSet3fv(camera, "up",  cam_up);
+  ospCommit(camera);
+
+  ospSet1f(renderer, "epsilon", 0.01);
+  ospCommit(renderer);
+
+  int size = 64;
+
+  // a slab in the middle of the volume, one voxel thick along x
+  volumetricData.resize(size*size*size, 0.f);
+  for (int y = 0; y < size; ++y)
+    for (int z = 0; z < size; ++z)
+      volumetricData[size*size * z + size * y + size / 2] = 1.f;
+
+  OSPVolume slab = ospNewVolume("shared_structured_volume");
+  ASSERT_TRUE(slab);
+  OSPData voxelsData = ospNewData(size * size * size, OSP_FLOAT, volumetricData.data(), OSP_DATA_SHARED_BUFFER);
+  ospSetData(slab, "voxelData", voxelsData);
+  ospSet3i(slab, "dimensions", size, size, size);
+  ospSetString(slab, "voxelType", "float");
+  ospSet2f(slab, "voxelRange", 0.f, 1.f);
+  ospSet3f(slab, "gridOrigin", -0.5f, -0.5f, -0.5f);
+  ospSet3f(slab, "gridSpacing", 1.f / size, 1.f / size, 1.f / size);
+  // steps of about 100 voxels, way past the slab
+  ospSet1f(slab, "samplingRate", 0.01f);
+
+  OSPTransferFunction transferFun = ospNewTransferFunction("piecewise_linear");
+  ospSet2f(transferFun, "valueRange", 0.f, 1.f);
+  float colors[] = {
+    1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f
+  };
+  float opacites[] = { 1.0f, 1.0f };
+  OSPData tfColorData = ospNewData(2, OSP_FLOAT3, colors);
+  ospSetData(transferFun, "colors", tfColorData);
+  OSPData tfOpacityData = ospNewData(2, OSP_FLOAT, opacites);
+  ospSetData(transferFun, "opacities", tfOpacityData);
+  ospCommit(transferFun);
+  ospSetObject(slab, "transferFunction", transferFun);
+
+  ospCommit(slab);
+
+  isosurface = ospNewGeometry("isosurfaces");
+  ASSERT_TRUE(isosurface);
+  ospSetObject(isosurface, "volume", slab);
+  float isovalue = 0.5f;
+  OSPData isovaluesData = ospNewData(1, OSP_FLOAT, &isovalue);
+  ospSetData(isosurface, "isovalues", isovaluesData);
   ospCommit(isosurface);
   AddGeometry(isosurface);
 
@@ -523,6 +627,139 @@ void Torus::SetUp() {
   AddLight(ambient);
 }
 
+UnstructuredCube::UnstructuredCube() {
+  rendererType = "scivis";
+
+  auto params = GetParam();
+  cellType = std::get<0>(params);
+  index64 = std::get<1>(params);
+}
+
+void UnstructuredCube::SetUp() {
+  ASSERT_NO_FATAL_FAILURE(CreateEmptyScene());
+
+  float cam_pos[] = {-0.7f, -1.4f, 0.f};
+  float cam_up[] = {0.f, 0.f, -1.f};
+  float cam_view[] = {0.5f, 1.f, 0.f};
+  ospSet3fv(camera, "pos", cam_pos);
+  ospSet3fv(camera, "dir", cam_view);
+  ospSet3fv(camera, "up",  cam_up);
+  ospCommit(camera);
+
+  for (int z = 0; z <= size; ++z) {
+    for (int y = 0; y <= size; ++y) {
+      for (int x = 0; x <= size; ++x) {
+        const float X = float(x) / size - 0.5f;
+        const float Y = float(y) / size - 0.5f;
+        const float Z = float(z) / size - 0.5f;
+        vertices.insert(vertices.end(), {X, Y, Z});
+        field.push_back(X + Y + Z);
+      }
+    }
+  }
+
+  transferFun = ospNewTransferFunction("piecewise_linear");
+  ospSet2f(transferFun, "valueRange", -1.5f, 1.5f);
+  float colors[] = {
+    1.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f
+  };
+  float opacites[] = { 0.1f, 0.5f };
+  OSPData tfColorData = ospNewData(2, OSP_FLOAT3, colors);
+  ospSetData(transferFun, "colors", tfColorData);
+  OSPData tfOpacityData = ospNewData(2, OSP_FLOAT, opacites);
+  ospSetData(transferFun, "opacities", tfOpacityData);
+  ospCommit(transferFun);
+
+  volume = CreateVolume(cellType, index64);
+  ASSERT_TRUE(volume);
+  AddVolume(volume);
+
+  OSPLight ambient = ospNewLight(renderer, "ambient");
+  ASSERT_TRUE(ambient) << "Failed to create lights";
+  ospSetf(ambient, "intensity", 0.5f);
+  ospCommit(ambient);
+  AddLight(ambient);
+}
+
+OSPVolume UnstructuredCube::CreateVolume(const std::string& type, bool longIndices) {
+  auto vertexID = [&](int x, int y, int z) {
+    return int64_t((z * (size + 1) + y) * (size + 1) + x);
+  };
+  // dot(cross(p2 - p1, p3 - p1), p1 - p0) of the tetrahedron's vertices
+  auto orientation = [&](const int64_t (&tet)[4]) {
+    const float *p0 = &vertices[3 * tet[0]];
+    const float *p1 = &vertices[3 * tet[1]];
+    const float *p2 = &vertices[3 * tet[2]];
+    const float *p3 = &vertices[3 * tet[3]];
+    const float a[] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+    const float b[] = { p3[0] - p1[0], p3[1] - p1[1], p3[2] - p1[2] };
+    return (a[1] * b[2] - a[2] * b[1]) * (p1[0] - p0[0])
+         + (a[2] * b[0] - a[0] * b[2]) * (p1[1] - p0[1])
+         + (a[0] * b[1] - a[1] * b[0]) * (p1[2] - p0[2]);
+  };
+
+  std::vector<int64_t> cells;
+  for (int z = 0; z < size; ++z) {
+    for (int y = 0; y < size; ++y) {
+      for (int x = 0; x < size; ++x) {
+        const int64_t c[] = {
+          vertexID(x, y, z), vertexID(x + 1, y, z), vertexID(x + 1, y + 1, z), vertexID(x, y + 1, z),
+          vertexID(x, y, z + 1), vertexID(x + 1, y, z + 1), vertexID(x + 1, y + 1, z + 1), vertexID(x, y + 1, z + 1)
+        };
+        // the cube split along a diagonal plane into two wedges, or into three pyramids with
+        // their apex at corner 6, which in turn split into two tetrahedra each
+        const int64_t pyramids[3][5] = {
+          { c[0], c[1], c[2], c[3], c[6] },
+          { c[0], c[3], c[7], c[4], c[6] },
+          { c[0], c[4], c[5], c[1], c[6] }
+        };
+        if (type == "hexahedra") {
+          cells.insert(cells.end(), c, c + 8);
+        } else if (type == "wedges") {
+          cells.insert(cells.end(), { c[0], c[1], c[2], c[4], c[5], c[6] });
+          cells.insert(cells.end(), { c[0], c[2], c[3], c[4], c[6], c[7] });
+        } else if (type == "pyramids") {
+          for (auto &pyramid : pyramids)
+            cells.insert(cells.end(), pyramid, pyramid + 5);
+        } else {
+          for (auto &p : pyramids) {
+            const int64_t tets[2][4] = {
+              { p[0], p[1], p[2], p[4] },
+              { p[0], p[2], p[3], p[4] }
+            };
+            for (auto &tet : tets) {
+              // sampling relies on positively oriented tetrahedra
+              if (orientation(tet) < 0.f)
+                cells.insert(cells.end(), { tet[0], tet[2], tet[1], tet[3] });
+              else
+                cells.insert(cells.end(), tet, tet + 4);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  OSPVolume cube = ospNewVolume("unstructured_volume");
+  EXPECT_TRUE(cube);
+  OSPData data = ospNewData(vertices.size() / 3, OSP_FLOAT3, vertices.data());
+  ospSetData(cube, "vertices", data);
+  data = ospNewData(field.size(), OSP_FLOAT, field.data());
+  ospSetData(cube, "field", data);
+  if (longIndices) {
+    data = ospNewData(cells.size(), OSP_LONG, cells.data());
+  } else {
+    std::vector<int32_t> cells32(cells.begin(), cells.end());
+    data = ospNewData(cells32.size(), OSP_INT, cells32.data());
+  }
+  ospSetData(cube, type.c_str(), data);
+  ospSetObject(cube, "transferFunction", transferFun);
+  ospCommit(cube);
+
+  return cube;
+}
+
 SlicedCube::SlicedCube() {
 }
 
@@ -700,7 +937,7 @@ void Pipes::SetUp() {
   ospCommit(camera);
   ospCommit(renderer);
 
-  float vertex[] = {
+  vertex = {
     -2.f,  2.f, -2.f, 0.f,
      2.f,  2.f, -2.f, 0.f,
      2.f, -2.f, -2.f, 0.f,
@@ -719,13 +956,13 @@ void Pipes::SetUp() {
     -2.f,  2.f,  2.f, 0.f,
   };
 
-  int index[] =  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
-  OSPGeometry streamlines = ospNewGeometry("streamlines");
+  index = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14 };
+  streamlines = ospNewGeometry("streamlines");
   ASSERT_TRUE(streamlines);
-  OSPData data = ospNewData(16, OSP_FLOAT3A, vertex);
+  OSPData data = ospNewData(16, OSP_FLOAT3A, vertex.data());
   ASSERT_TRUE(data);
   ospSetData(streamlines, "vertex", data);
-  data = ospNewData(15, OSP_INT, index);
+  data = ospNewData(15, OSP_INT, index.data());
   ASSERT_TRUE(data);
   ospSetData(streamlines, "index", data);
   ospSet1f(streamlines, "radius", radius);
@@ -741,5 +978,69 @@ void Pipes::SetUp() {
   AddLight(ambient);
 }
 
+RendererOptions::RendererOptions() {
+  rendererType = GetParam();
+}
+
+void RendererOptions::SetUp() {
+  ASSERT_NO_FATAL_FAILURE(CreateEmptyScene());
+
+  float quadVertices[] = {
+    -4.f, -3.f, 6.f,
+     4.f, -3.f, 6.f,
+     4.f,  3.f, 6.f,
+    -4.f,  3.f, 6.f
+  };
+  int32_t quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+  OSPGeometry quad = ospNewGeometry("triangles");
+  ASSERT_TRUE(quad);
+  OSPData data = ospNewData(4, OSP_FLOAT3, quadVertices);
+  ASSERT_TRUE(data);
+  ospSetData(quad, "vertex", data);
+  data = ospNewData(2, OSP_INT3, quadIndices);
+  ASSERT_TRUE(data);
+  ospSetData(quad, "index", data);
+  ospSetMaterial(quad, CreateMaterial("OBJMaterial"));
+  ospCommit(quad);
+  AddGeometry(quad);
+
+  float sphereVertices[] = {
+    -1.2f, -0.5f, 4.f, 0.f,
+     0.0f,  0.4f, 3.5f, 0.f,
+     1.2f, -0.3f, 3.f, 0.f
+  };
+  float sphereColors[] = {
+    1.f, 0.f, 0.f, 1.f,
+    0.f, 1.f, 0.f, 1.f,
+    0.f, 0.f, 1.f, 1.f
+  };
+  OSPGeometry spheres = ospNewGeometry("spheres");
+  ASSERT_TRUE(spheres);
+  data = ospNewData(3, OSP_FLOAT4, sphereVertices);
+  ASSERT_TRUE(data);
+  ospSetData(spheres, "spheres", data);
+  data = ospNewData(3, OSP_FLOAT4, sphereColors);
+  ASSERT_TRUE(data);
+  ospSetData(spheres, "color", data);
+  ospSet1f(spheres, "radius", 0.5f);
+  ospSetMaterial(spheres, CreateMaterial("OBJMaterial"));
+  ospCommit(spheres);
+  AddGeometry(spheres);
+
+  OSPLight distant = ospNewLight(renderer, "distant");
+  ASSERT_TRUE(distant);
+  ospSetf(distant, "intensity", 1.0f);
+  ospSet3f(distant, "direction", 1.0f, -1.0f, 1.0f);
+  ospSet1f(distant, "angularDiameter", 1.0f);
+  ospCommit(distant);
+  AddLight(distant);
+
+  OSPLight ambient = ospNewLight(renderer, "ambient");
+  ASSERT_TRUE(ambient);
+  ospSetf(ambient, "intensity", 0.2f);
+  ospCommit(ambient);
+  AddLight(ambient);
+}
+
 } // namespace OSPRayTestScenes
 
@@ -15,6 +15,7 @@
 // ======================================================================== //
 
 #include "ospray_test_fixture.h"
+#include <random>
 
 using OSPRayTestScenes::Base;
 using OSPRayTestScenes::SingleObject;
@@ -137,6 +138,17 @@ OSPGeometry getStreamline() {
   return streamlines;
 }
 
+// a 4x4x4 grid of spheres of varying sizes and colors, as centers with the radius in 'w'
+void getSphereGrid(std::vector<float> &vertex, std::vector<float> &color) {
+  for (int z = 0; z < 4; ++z)
+    for (int y = 0; y < 4; ++y)
+      for (int x = 0; x < 4; ++x) {
+        vertex.insert(vertex.end(), { -0.75f + 0.5f * x, -0.75f + 0.5f * y, 3.0f + 0.5f * z,
+                                      0.08f + 0.02f * ((x + y + z) % 4) });
+        color.insert(color.end(), { x / 3.0f, y / 3.0f, z / 3.0f, 1.0f });
+      }
+}
+
 } // anonymous namespace
 
 // an empty scene
@@ -180,6 +192,81 @@ TEST_P(SingleObject, simpleStreamlines) {
   PerformRenderTest();
 }
 
+// a grid of particles has to look like the same grid of spheres (up to the
+// quantization of the particle positions)
+TEST_P(SingleObject, simpleParticles) {
+  std::vector<float> vertex, color;
+  ::getSphereGrid(vertex, color);
+  OSPData vertexData = ospNewData(vertex.size() / 4, OSP_FLOAT4, vertex.data());
+  ASSERT_TRUE(vertexData);
+  ospCommit(vertexData);
+  OSPData colorData = ospNewData(color.size() / 4, OSP_FLOAT4, color.data());
+  ASSERT_TRUE(colorData);
+  ospCommit(colorData);
+
+  OSPGeometry spheres = ospNewGeometry("spheres");
+  ASSERT_TRUE(spheres);
+  ospSetData(spheres, "spheres", vertexData);
+  ospSet1i(spheres, "offset_radius", 3 * sizeof(float));
+  ospSetData(spheres, "color", colorData);
+  ospSetMaterial(spheres, GetMaterial());
+  ospCommit(spheres);
+  AddGeometry(spheres);
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  OSPGeometry particles = ospNewGeometry("particles");
+  ASSERT_TRUE(particles);
+  ospSetData(particles, "positions", vertexData);
+  ospSetData(particles, "color", colorData);
+  ospSetMaterial(particles, GetMaterial());
+  ospCommit(particles);
+  ospRemoveGeometry(world, spheres);
+  AddGeometry(particles);
+
+  CompareWithReference(RenderImage(framebuffer), reference);
+}
+
+// with level-of-detail, subtrees of a dense cloud of particles that cover
+// less than a pixel get replaced by proxy spheres, which must not be visible.
+// Glass is left out, as a proxy refracts differently than its particles.
+TEST_P(SingleObject, particlesLOD) {
+  if (materialType == "Glass")
+    return;
+
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<float> vertex, color;
+  while (vertex.size() < 3 * 128 * 1024) {
+    const float x = dist(rng), y = dist(rng), z = dist(rng);
+    if (x * x + y * y + z * z > 1.0f)
+      continue;
+    vertex.insert(vertex.end(), { 0.8f * x, 0.8f * y, 3.5f + 0.8f * z });
+    color.insert(color.end(), { 0.5f + 0.5f * x, 0.5f + 0.5f * y, 0.5f + 0.5f * z, 1.0f });
+  }
+  OSPData data = ospNewData(vertex.size() / 3, OSP_FLOAT3, vertex.data());
+  ASSERT_TRUE(data);
+  ospCommit(data);
+  OSPGeometry particles = ospNewGeometry("particles");
+  ASSERT_TRUE(particles);
+  ospSetData(particles, "positions", data);
+  data = ospNewData(color.size() / 4, OSP_FLOAT4, color.data());
+  ASSERT_TRUE(data);
+  ospCommit(data);
+  ospSetData(particles, "color", data);
+  ospSet1f(particles, "radius", 0.003f);
+  ospSetMaterial(particles, GetMaterial());
+  ospCommit(particles);
+  AddGeometry(particles);
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  // the angle covered by one pixel of the default camera (fovy = 60 degrees)
+  ospSet1f(particles, "lodThreshold", 60.0f * 3.14159265f / 180.0f / imgSize.y);
+  ospCommit(particles);
+  ospCommit(world);
+
+  CompareWithReference(RenderImage(framebuffer), reference);
+}
+
 INSTANTIATE_TEST_CASE_P(Scivis, SingleObject, ::testing::Combine(::testing::Values("scivis"), ::testing::Values("OBJMaterial")));
 INSTANTIATE_TEST_CASE_P(Pathtracer, SingleObject, ::testing::Combine(::testing::Values("pathtracer"), ::testing::Values("OBJMaterial", "Glass", "Luminous")));
 
@@ -193,6 +280,46 @@ TEST_P(Pipes, simple) {
   PerformRenderTest();
 }
 
+// The tubes and their rounded joints have to look like cylinders with spheres at the vertices
+// (up to the approximation of the spheres by the joints). Glass is left out, as the inner
+// surfaces where the pieces overlap refract differently.
+TEST_P(Pipes, joints) {
+  if (materialType == "Glass")
+    return;
+
+  const std::vector<uint32_t> image = RenderImage(framebuffer);
+
+  std::vector<float> cylinderVertex;
+  for (int i : index) {
+    cylinderVertex.insert(cylinderVertex.end(), &vertex[4 * i], &vertex[4 * i + 3]);
+    cylinderVertex.insert(cylinderVertex.end(), &vertex[4 * i + 4], &vertex[4 * i + 7]);
+  }
+  OSPGeometry cylinders = ospNewGeometry("cylinders");
+  ASSERT_TRUE(cylinders);
+  OSPData data = ospNewData(cylinderVertex.size(), OSP_FLOAT, cylinderVertex.data());
+  ASSERT_TRUE(data);
+  ospSetData(cylinders, "cylinders", data);
+  ospSet1f(cylinders, "radius", radius);
+  ospSetMaterial(cylinders, CreateMaterial(materialType));
+  ospCommit(cylinders);
+
+  OSPGeometry spheres = ospNewGeometry("spheres");
+  ASSERT_TRUE(spheres);
+  data = ospNewData(vertex.size(), OSP_FLOAT, vertex.data());
+  ASSERT_TRUE(data);
+  ospSetData(spheres, "spheres", data);
+  ospSet1f(spheres, "radius", radius);
+  ospSetMaterial(spheres, CreateMaterial(materialType));
+  ospCommit(spheres);
+
+  ospRemoveGeometry(world, streamlines);
+  ospAddGeometry(world, cylinders);
+  ospAddGeometry(world, spheres);
+  ospCommit(world);
+
+  CompareWithReference(image, RenderImage(framebuffer));
+}
+
 INSTANTIATE_TEST_CASE_P(Scivis, Pipes, ::testing::Combine(::testing::Values("scivis"), ::testing::Values("OBJMaterial"), ::testing::Values(0.1f, 0.4f)));
 
 // Tests disabled due to issues for pathtracer renderer with streamlines
@@ -0,0 +1,127 @@
+// ======================================================================== //
+// Copyright 2017-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+
+#include "ospray_test_fixture.h"
+#include <algorithm>
+
+using OSPRayTestScenes::RendererOptions;
+
+namespace {
+
+int numTiles(osp::vec2i imgSize) {
+  return ((imgSize.x + OSPRAY_TILE_SIZE - 1) / OSPRAY_TILE_SIZE)
+       * ((imgSize.y + OSPRAY_TILE_SIZE - 1) / OSPRAY_TILE_SIZE);
+}
+
+} // anonymous namespace
+
+// With a budget that is always exceeded, every frame renders just the single tile that was
+// left out the longest. Thus, after as many frames as there are tiles, each tile got rendered
+// exactly once, which must give the same image as one unlimited frame -- also when alternating
+// between two framebuffers, which each keep their own budget state.
+TEST_P(RendererOptions, frameBudget) {
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  OSPFrameBuffer second = ospNewFrameBuffer(imgSize, frameBufferFormat, OSP_FB_COLOR | OSP_FB_ACCUM);
+  ASSERT_TRUE(second);
+  ospFrameBufferClear(framebuffer, OSP_FB_COLOR | OSP_FB_ACCUM);
+  ospFrameBufferClear(second, OSP_FB_COLOR | OSP_FB_ACCUM);
+
+  ospSet1f(renderer, "frameBudgetMs", 1e-6f);
+  ospCommit(renderer);
+  for (int frame = 0; frame < numTiles(imgSize); ++frame) {
+    ospRenderFrame(framebuffer, renderer, OSP_FB_COLOR | OSP_FB_ACCUM);
+    ospRenderFrame(second, renderer, OSP_FB_COLOR | OSP_FB_ACCUM);
+  }
+
+  CompareWithReference(GetImage(framebuffer), reference);
+  CompareWithReference(GetImage(second), reference);
+  ospRelease(second);
+}
+
+// Adaptive accumulation has to be off without a variance threshold, thus a framebuffer with a
+// variance channel must give the same image as one without. With a threshold, regions stop
+// being refined once their estimated error is below it, which must not be visible.
+TEST_P(RendererOptions, varianceThreshold) {
+  frames = 8;
+  ospSet1i(renderer, "spp", 4);
+  ospCommit(renderer);
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  const uint32_t channels = OSP_FB_COLOR | OSP_FB_ACCUM | OSP_FB_VARIANCE;
+  OSPFrameBuffer varianceFB = ospNewFrameBuffer(imgSize, frameBufferFormat, channels);
+  ASSERT_TRUE(varianceFB);
+
+  for (float threshold : {0.f, 0.01f}) {
+    SCOPED_TRACE(threshold);
+    ospSet1f(renderer, "varianceThreshold", threshold);
+    ospCommit(renderer);
+    CompareWithReference(RenderImage(varianceFB, channels), reference);
+  }
+
+  ospRelease(varianceFB);
+}
+
+// Foveated rendering: an importance map or a fovea that cover the whole image must not change
+// it. Otherwise, tiles of low importance are rendered with fewer samples and upsampled, which
+// must stay close to the full resolution image, while the tile at the center of a fovea has to
+// be rendered at full resolution.
+TEST_P(RendererOptions, foveation) {
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  uint8_t fullImportance = 255;
+  OSPTexture2D importanceMap = ospNewTexture2D(osp::vec2i{1, 1}, OSP_TEXTURE_R8, &fullImportance);
+  ASSERT_TRUE(importanceMap);
+  ospCommit(importanceMap);
+  ospSetObject(renderer, "importanceMap", importanceMap);
+  ospCommit(renderer);
+  CompareWithReference(RenderImage(framebuffer), reference);
+  ospRelease(importanceMap);
+
+  // full resolution on the left, one sample per 4x4 pixels on the right
+  float halfImportance[] = { 1.f, 0.25f };
+  importanceMap = ospNewTexture2D(osp::vec2i{2, 1}, OSP_TEXTURE_R32F, halfImportance);
+  ASSERT_TRUE(importanceMap);
+  ospCommit(importanceMap);
+  ospSetObject(renderer, "importanceMap", importanceMap);
+  ospCommit(renderer);
+  CompareWithReference(RenderImage(framebuffer), reference);
+  ospRelease(importanceMap);
+  ospRemoveParam(renderer, "importanceMap");
+
+  ospSet1f(renderer, "foveaRadius", 2.f);
+  ospCommit(renderer);
+  CompareWithReference(RenderImage(framebuffer), reference);
+
+  // a fovea just covering the center tile, with one sample per 2x2 pixels outside
+  ospSet2f(renderer, "foveaCenter", 0.5f, 0.5f);
+  ospSet1f(renderer, "foveaRadius", OSPRAY_TILE_SIZE / float(imgSize.y));
+  ospSet1i(renderer, "maxSubsampling", 1);
+  ospCommit(renderer);
+  const std::vector<uint32_t> image = RenderImage(framebuffer);
+  CompareWithReference(image, reference);
+
+  const int x0 = imgSize.x / 2 / OSPRAY_TILE_SIZE * OSPRAY_TILE_SIZE;
+  const int y0 = imgSize.y / 2 / OSPRAY_TILE_SIZE * OSPRAY_TILE_SIZE;
+  int differentPixels = 0;
+  for (int y = y0; y < std::min(y0 + OSPRAY_TILE_SIZE, imgSize.y); ++y)
+    for (int x = x0; x < std::min(x0 + OSPRAY_TILE_SIZE, imgSize.x); ++x)
+      differentPixels += image[y * imgSize.x + x] != reference[y * imgSize.x + x];
+  EXPECT_EQ(differentPixels, 0);
+}
+
+INSTANTIATE_TEST_CASE_P(Renderers, RendererOptions, ::testing::Values("scivis", "pathtracer"));
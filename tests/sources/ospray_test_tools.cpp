@@ -127,7 +127,6 @@ OsprayStatus OSPImageTools::saveTestImage(const void *pixel)
 
 // comparare the baseline image wiht the values form the framebuffer
 OsprayStatus OSPImageTools::compareImgWithBaseline(const uint32_t *testImg) {
-  pixelColorValue* testImage = (pixelColorValue*)testImg;
   std::string baselineName = ospEnv->GetBaselineDir() + "/" + imgName +  GetFileFormat();
 
   int dataX , dataY, dataN;
@@ -144,13 +143,27 @@ OsprayStatus OSPImageTools::compareImgWithBaseline(const uint32_t *testImg) {
 
   unsigned int bufferLen = ImgType::RGBA * size.x * size.y;
   std::vector<pixelColorValue> baselineImage(bufferLen, std::numeric_limits<pixelColorValue>::max());
-  std::vector<pixelColorValue> diffImage(bufferLen, std::numeric_limits<pixelColorValue>::max());
 
   for (int y = 0; y < size.y; ++y) {
     pixelColorValue* lineAdrr = &(baselineImage[ImgType::RGBA*size.x *(size.y-1- y)]);
     std::memcpy(lineAdrr, &(baselineData[ImgType::RGBA*size.x*y]), ImgType::RGBA*sizeof(pixelColorValue)*size.x);
   }
 
+  stbi_image_free(baselineData);
+  return compareImages(testImg, (const uint32_t*)baselineImage.data(), baselineName);
+}
+
+// compare the values from the framebuffer with an image rendered by the test itself
+OsprayStatus OSPImageTools::compareImgWithReference(const uint32_t *testImg, const uint32_t *referenceImg) {
+  return compareImages(testImg, referenceImg, imgName + " (reference)");
+}
+
+OsprayStatus OSPImageTools::compareImages(const uint32_t *testImg, const uint32_t *referenceImg, std::string referenceName) {
+  pixelColorValue* testImage = (pixelColorValue*)testImg;
+  const pixelColorValue* baselineImage = (const pixelColorValue*)referenceImg;
+  unsigned int bufferLen = ImgType::RGBA * size.x * size.y;
+  std::vector<pixelColorValue> diffImage(bufferLen, std::numeric_limits<pixelColorValue>::max());
+
   bool notPerfect = false;
   unsigned incorrectPixels = 0;
   pixelColorValue maxError = 0;
@@ -175,7 +188,7 @@ OsprayStatus OSPImageTools::compareImgWithBaseline(const uint32_t *testImg) {
   }
 
   if (notPerfect)
-    std::cerr << "[ WARNING  ] " << baselineName << " is not pixel perfect" << std::endl;
+    std::cerr << "[ WARNING  ] " << referenceName << " is not pixel perfect" << std::endl;
 
   if(incorrectPixels > 0) {
     double meanError = totalError / double(3*size.x*size.y);
@@ -200,12 +213,11 @@ OsprayStatus OSPImageTools::compareImgWithBaseline(const uint32_t *testImg) {
   bool failed = (incorrectPixels / double(3*size.x*size.y)) > errorRate;
 
   if (failed) {
-    writeImg(ospEnv->GetFailedDir()+"/"+imgName+"_baseline", (const uint32_t*)baselineImage.data());
+    writeImg(ospEnv->GetFailedDir()+"/"+imgName+"_baseline", (const uint32_t*)baselineImage);
     writeImg(ospEnv->GetFailedDir()+"/"+imgName+"_rendered", (const uint32_t*)testImage);
     writeImg(ospEnv->GetFailedDir()+"/"+imgName+"_diff", (const uint32_t*)diffImage.data());
   }
 
-  stbi_image_free(baselineData);
   if (failed)
     return OsprayStatus::Fail;
   else
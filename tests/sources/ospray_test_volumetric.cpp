@@ -15,9 +15,15 @@
 // ======================================================================== //
 
 #include "ospray_test_fixture.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
 
 using OSPRayTestScenes::Sierpinski;
 using OSPRayTestScenes::Torus;
+using OSPRayTestScenes::ThinIsosurface;
+using OSPRayTestScenes::UnstructuredCube;
 
 TEST_P(Sierpinski, simple) {
   PerformRenderTest();
@@ -30,5 +36,132 @@ TEST_P(Torus, simple) {
   PerformRenderTest();
 }
 
-INSTANTIATE_TEST_CASE_P(Renderers, Torus, ::testing::Values("scivis", "pathtracer"));
+// Editing the transfer function and re-committing the volume must not re-extract the
+// isosurfaces. The shared voxels are overwritten without committing them, which only becomes
+// visible once the mesh gets rebuilt -- the opacities, in contrast, do not affect the mesh.
+TEST_P(Torus, recommit) {
+  if (!extractIsosurfaces)
+    return;
 
+  const std::vector<uint32_t> reference = RenderImage(framebuffer);
+
+  std::fill(volumetricData.begin(), volumetricData.end(), -10000.f);
+  float opacities[] = { 0.5f, 0.5f };
+  OSPData tfOpacityData = ospNewData(2, OSP_FLOAT, opacities);
+  ospSetData(transferFun, "opacities", tfOpacityData);
+  ospCommit(transferFun);
+  ospCommit(torus);
+  ospCommit(world);
+  CompareWithReference(RenderImage(framebuffer), reference);
+
+  // committing the voxels does rebuild the mesh, which is empty now
+  ospCommit(voxelsData);
+  ospCommit(world);
+  EXPECT_NE(RenderImage(framebuffer), reference);
+}
+
+// Sampling a batch of coordinates in SoA layout has to give the same values as sampling them
+// one by one, and the gradients have to match the forward differences over one voxel that the
+// structured volumes use. The count is not a multiple of the batch size of the parallel tasks.
+TEST_P(Torus, sampleSoA) {
+  const size_t count = 5000;
+  const float spacing = 1.f / 250;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-0.5f, 0.5f - 3 * spacing);
+  std::vector<float> x(count), y(count), z(count);
+  std::vector<osp::vec3f> coordinates(count);
+  for (size_t i = 0; i < count; ++i) {
+    x[i] = dist(rng);
+    y[i] = dist(rng);
+    z[i] = dist(rng);
+    coordinates[i] = osp::vec3f{x[i], y[i], z[i]};
+  }
+
+  float *reference = nullptr;
+  ospSampleVolume(&reference, torus, coordinates[0], count);
+  ASSERT_TRUE(reference);
+
+  std::vector<float> values(count);
+  ospSampleVolumeSoA(torus, x.data(), y.data(), z.data(), count, values.data());
+  for (size_t i = 0; i < count; ++i)
+    ASSERT_NEAR(values[i], reference[i], 1e-4f * (1.f + std::abs(reference[i]))) << "sample " << i;
+
+  std::vector<float> gradientX(count), gradientY(count), gradientZ(count);
+  ospSampleVolumeSoA(torus, x.data(), y.data(), z.data(), count, values.data(),
+                     gradientX.data(), gradientY.data(), gradientZ.data());
+
+  std::vector<osp::vec3f> neighbors(3 * count);
+  for (size_t i = 0; i < count; ++i) {
+    neighbors[3 * i + 0] = osp::vec3f{x[i] + spacing, y[i], z[i]};
+    neighbors[3 * i + 1] = osp::vec3f{x[i], y[i] + spacing, z[i]};
+    neighbors[3 * i + 2] = osp::vec3f{x[i], y[i], z[i] + spacing};
+  }
+  float *neighborValues = nullptr;
+  ospSampleVolume(&neighborValues, torus, neighbors[0], 3 * count);
+  ASSERT_TRUE(neighborValues);
+
+  for (size_t i = 0; i < count; ++i) {
+    ASSERT_NEAR(values[i], reference[i], 1e-4f * (1.f + std::abs(reference[i]))) << "sample " << i;
+    // the differences lose precision relative to the sampled values
+    const float tolerance = 1e-4f * (1.f + std::abs(reference[i])) / spacing;
+    const float *neighbor = neighborValues + 3 * i;
+    ASSERT_NEAR(gradientX[i], (neighbor[0] - reference[i]) / spacing, tolerance) << "sample " << i;
+    ASSERT_NEAR(gradientY[i], (neighbor[1] - reference[i]) / spacing, tolerance) << "sample " << i;
+    ASSERT_NEAR(gradientZ[i], (neighbor[2] - reference[i]) / spacing, tolerance) << "sample " << i;
+  }
+
+  free(reference);
+  free(neighborValues);
+}
+
+INSTANTIATE_TEST_CASE_P(Renderers, Torus, ::testing::Combine(::testing::Values("scivis", "pathtracer"), ::testing::Values(false)));
+INSTANTIATE_TEST_CASE_P(Extracted, Torus, ::testing::Combine(::testing::Values("scivis", "pathtracer"), ::testing::Values(true)));
+
+// Implicit isosurfaces of structured volumes are intersected exactly, thus even a feature much
+// thinner than the sampling step (which stepping along the ray misses) has to look like its
+// extracted mesh.
+TEST_P(ThinIsosurface, exact) {
+  const std::vector<uint32_t> image = RenderImage(framebuffer);
+
+  ospSet1i(isosurface, "extract", 1);
+  ospCommit(isosurface);
+  ospCommit(world);
+  CompareWithReference(image, RenderImage(framebuffer));
+}
+
+INSTANTIATE_TEST_CASE_P(Renderers, ThinIsosurface, ::testing::Values("scivis", "pathtracer"));
+
+// Wedges, pyramids and tetrahedra are split or sampled differently than hexahedra, and 64-bit
+// indices are read differently than 32-bit ones. All have to look like the same cube made of
+// hexahedra with 32-bit indices.
+TEST_P(UnstructuredCube, cellTypes) {
+  const std::vector<uint32_t> image = RenderImage(framebuffer);
+
+  OSPVolume hexahedra = CreateVolume("hexahedra", false);
+  ASSERT_TRUE(hexahedra);
+  ospRemoveVolume(world, volume);
+  AddVolume(hexahedra);
+
+  CompareWithReference(image, RenderImage(framebuffer));
+}
+
+// The field is linear, thus every cell type has to reproduce it exactly.
+TEST_P(UnstructuredCube, sample) {
+  const size_t count = 1000;
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(-0.49f, 0.49f);
+  std::vector<osp::vec3f> coordinates(count);
+  for (auto &c : coordinates)
+    c = osp::vec3f{dist(rng), dist(rng), dist(rng)};
+
+  float *values = nullptr;
+  ospSampleVolume(&values, volume, coordinates[0], count);
+  ASSERT_TRUE(values);
+  for (size_t i = 0; i < count; ++i) {
+    const osp::vec3f &c = coordinates[i];
+    EXPECT_NEAR(values[i], c.x + c.y + c.z, 1e-4f) << "sample " << i;
+  }
+  free(values);
+}
+
+INSTANTIATE_TEST_CASE_P(CellTypes, UnstructuredCube, ::testing::Combine(::testing::Values("tetrahedra", "hexahedra", "wedges", "pyramids"), ::testing::Bool()));